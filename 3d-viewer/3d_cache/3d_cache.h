@@ -31,6 +31,8 @@
 
 #include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <wx/string.h>
 #include "str_rsort.h"
 #include "3d_filename_resolver.h"
@@ -73,18 +75,46 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
-    /** Find or create cache entry for file name
+    /**
+     * Function getEntry
+     * finds the cache entry of a file, or creates it if the file was never loaded.
+     *
+     * The entry is returned locked by \a aEntryLock.  A new entry is locked before it is
+     * visible to the other threads, so they wait for it to be loaded instead of loading
+     * the same file again.
+     *
+     * @param[in]   aFileName   full path of the model file
+     * @param[out]  aEntryLock  receives the lock of the entry
+     * @param[out]  aCreated    set to true if the entry was created, and must be loaded
+     *                          with checkCache()
+     * @return      the cache entry of the file
+     */
+    S3D_CACHE_ENTRY* getEntry( const wxString& aFileName,
+                               std::unique_lock< std::mutex >& aEntryLock, bool& aCreated );
+
+    /** Load the data of a new cache entry
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Loads the scene data of the file from the cache directory if possible, or with
+     * the plugins otherwise.  The caller must hold the lock of the entry.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aFileName   full path of the model file
+     * @param[in]   aCacheItem  the new cache entry of the file
+     * @param[in]   aRenderOnly true if only the render data is needed; it is then read
+     *                          from the render cache file when there is one, and the
+     *                          scene data is not loaded
      * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @retval      NULL    on error, or if only the render data was loaded
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                            bool aRenderOnly = false );
+
+    /**
+     * Function loadScene
+     * loads the scene data of a cache entry whose hash is known, from the scene cache
+     * file if possible or with the plugins otherwise.  The caller must hold the lock
+     * of the entry.
+     */
+    SCENEGRAPH* loadScene( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -103,8 +133,30 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    /**
+     * Function loadRenderCache
+     * reads the render data of a cache entry from its render cache file.
+     *
+     * The render cache file holds the meshes of the S3DMODEL in contiguous blocks, so
+     * it is mapped in memory and copied in the arrays of the model, without decoding
+     * the scene graph.
+     *
+     * @return true if the render data was read, false if there is no usable file
+     */
+    bool loadRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Function saveRenderCache
+     * writes the render data of a cache entry to its render cache file.
+     */
+    bool saveRenderCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    // the real load function (can supply a cache entry pointer to member functions,
+    // and keep the entry locked with aEntryLock while they use it); if aRenderOnly
+    // is true the scene data is not loaded when the render data is in the cache
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      std::unique_lock< std::mutex >* aEntryLock = NULL,
+                      bool aRenderOnly = false );
 
 public:
     S3D_CACHE();
@@ -200,6 +252,20 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function LoadModels
+     * loads the render data of a list of models on a pool of threads, so the next
+     * calls to GetModel() for these models only have to look them up.  Several threads
+     * asking for the same model wait for the first one to load it.
+     *
+     * The files are hashed and read from the cache directory in parallel, but the
+     * plugins change the process locale, so they only decode one model at a time.
+     * The cache must not be flushed while the models are loaded.
+     *
+     * @param aModelFiles are the partial or full paths of the models to load
+     */
+    void LoadModels( const std::vector< wxString >& aModelFiles );
+
     wxString GetModelHash( const wxString& aModelFileName );
 };
 
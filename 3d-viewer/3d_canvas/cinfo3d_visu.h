@@ -420,6 +420,16 @@ class CINFO3D_VISU
  private:
     void createBoardPolygon();
     void createLayers( REPORTER *aStatusTextReporter );
+
+    /**
+     * @brief createCopperLayer - adds the items of a copper layer to its container and,
+     * when the copper thickness is rendered, to its polygon.  It only reads the board,
+     * so it can be called for several layers in parallel.
+     * @param aLayerId: the copper layer, its container and polygon must already exist
+     * @param aTrackList: the tracks and vias of the enabled layers
+     */
+    void createCopperLayer( PCB_LAYER_ID aLayerId,
+                            const std::vector< const TRACK *> &aTrackList );
     void destroyLayers();
 
     // Helper functions to create the board
@@ -51,6 +51,7 @@
 #include <convert_basic_shapes_to_polygon.h>
 #include <trigo.h>
 #include <drawtxt.h>
+#include <atomic>
 #include <utility>
 #include <vector>
 
@@ -65,6 +66,10 @@ static float s_biuTo3Dunits;
 static const CBBOX2D *s_boardBBox3DU = NULL;
 static const BOARD_ITEM *s_boardItem = NULL;
 
+// The texts are drawn by DrawGraphicText through a global BASIC_GAL, and with the
+// parameters above: only one text can be converted at a time.
+static MutexType s_textLock;
+
 // This is a call back function, used by DrawGraphicText to draw the 3D text shape:
 void addTextSegmToContainer( int x0, int y0, int xf, int yf )
 {
@@ -99,6 +104,8 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aTextPCB,
     if( aTextPCB->IsMirrored() )
         size.x = -size.x;
 
+    ScopedLock lock( s_textLock );
+
     s_boardItem    = (const BOARD_ITEM *)&aTextPCB;
     s_dstcontainer = aDstContainer;
     s_textWidth    = aTextPCB->GetThickness() + ( 2 * aClearanceValue );
@@ -225,6 +232,8 @@ void CINFO3D_VISU::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMod
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
+    ScopedLock lock( s_textLock );
+
     s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
     s_dstcontainer = aDstContainer;
     s_biuTo3Dunits = m_biuTo3Dunits;
@@ -1151,13 +1160,228 @@ void CINFO3D_VISU::destroyLayers()
 }
 
 
-void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+void CINFO3D_VISU::createCopperLayer( PCB_LAYER_ID aLayerId,
+                                      const std::vector< const TRACK *> &aTrackList )
 {
     // Number of segments to draw a circle using segments (used on countour zones
     // and text copper elements )
     const int    segcountforcircle = 12;
     const double correctionFactor  = GetCircleCorrectionFactor( segcountforcircle );
 
+    // The maps are only read here: the containers and polygons of the layer were created
+    // by createLayers()
+    wxASSERT( m_layers_container2D.find( aLayerId ) != m_layers_container2D.end() );
+
+    CBVHCONTAINER2D *layerContainer = m_layers_container2D.find( aLayerId )->second;
+
+    // ADD TRACKS
+    for( const TRACK *track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add object item to layer container
+        layerContainer->Add( createNewTrack( track, 0.0f ) );
+    }
+
+    // ADD PADS
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module,
+                                               layerContainer,
+                                               aLayerId,
+                                               0,
+                                               true );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   aLayerId,
+                                                   0 );
+    }
+
+    // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:  // should not exist on copper layers
+        {
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        }
+        break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+        break;
+        }
+    }
+
+    // ADD COPPER ZONES
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( zone->GetLayer() == aLayerId )
+                AddSolidAreasShapesToContainer( zone, layerContainer, aLayerId );
+        }
+    }
+
+    // Creates outline contours of the layer items and add it to the poly of the layer
+    // /////////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
+        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    {
+        wxASSERT( m_layers_poly.find( aLayerId ) != m_layers_poly.end() );
+
+        SHAPE_POLY_SET *layerPoly = m_layers_poly.find( aLayerId )->second;
+
+        // ADD TRACKS
+        for( const TRACK *track : aTrackList )
+        {
+            if( !track->IsOnLayer( aLayerId ) )
+                continue;
+
+            // Add the track contour
+            int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
+
+            track->TransformShapeWithClearanceToPolygon(
+                        *layerPoly,
+                        0,
+                        nrSegments,
+                        GetCircleCorrectionFactor( nrSegments ) );
+        }
+
+        // ADD PADS
+        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+        {
+            // Note: NPTH pads are not drawn on copper layers when the pad
+            // has same shape as its hole
+            transformPadsShapesWithClearanceToPolygon( module->PadsList(),
+                                                       aLayerId,
+                                                       *layerPoly,
+                                                       0,
+                                                       true );
+
+            // Micro-wave modules may have items on copper layers
+            {
+                ScopedLock lock( s_textLock );
+
+                module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId,
+                                                                        *layerPoly,
+                                                                        0,
+                                                                        segcountforcircle,
+                                                                        correctionFactor );
+            }
+
+            transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *layerPoly );
+        }
+
+        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+        for( auto item : m_board->Drawings() )
+        {
+            if( !item->IsOnLayer( aLayerId ) )
+                continue;
+
+            switch( item->Type() )
+            {
+            case PCB_LINE_T: // should not exist on copper layers
+            {
+                const int nrSegments =
+                        GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
+
+                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
+                            *layerPoly,
+                            0,
+                            nrSegments,
+                            GetCircleCorrectionFactor( nrSegments ) );
+            }
+            break;
+
+            case PCB_TEXT_T:
+            {
+                ScopedLock lock( s_textLock );
+
+                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
+                            *layerPoly,
+                            0,
+                            segcountforcircle,
+                            correctionFactor );
+            }
+            break;
+
+            default:
+                wxLogTrace( m_logTrace,
+                            wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
+            }
+        }
+
+        // ADD COPPER ZONES
+        if( GetFlag( FL_ZONE ) )
+        {
+            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+            {
+                const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+                if( zone->GetLayer() == aLayerId )
+                {
+                    zone->TransformSolidAreasShapesToPolygonSet( *layerPoly,
+                                                                 segcountforcircle,
+                                                                 correctionFactor );
+                }
+            }
+        }
+
+        // This will make a union of all added contourns
+        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+
+    // Simplify holes polygon contours
+    // /////////////////////////////////////////////////////////////////////////
+    if( m_layers_outer_holes_poly.find( aLayerId ) != m_layers_outer_holes_poly.end() )
+    {
+        // found
+        m_layers_outer_holes_poly.find( aLayerId )->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+
+        wxASSERT( m_layers_inner_holes_poly.find( aLayerId ) !=
+                  m_layers_inner_holes_poly.end() );
+
+        m_layers_inner_holes_poly.find( aLayerId )->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+    }
+}
+
+
+void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+{
     // segments to draw a circle to build texts. Is is used only to build
     // the shape of each segment of the stroke font, therefore no need to have
     // many segments per circle.
@@ -1260,40 +1484,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Create tracks and vias" ) );
-
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
-
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
     for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
@@ -1374,7 +1564,7 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
@@ -1482,47 +1672,7 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Creates outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track contour
-                int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
-
-                track->TransformShapeWithClearanceToPolygon(
-                            *layerPoly,
-                            0,
-                            nrSegments,
-                            GetCircleCorrectionFactor( nrSegments ) );
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
+    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
@@ -1556,10 +1706,11 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
+
     // Add contours of the pad holes (pads can be Circle or Segment holes)
     // /////////////////////////////////////////////////////////////////////////
     for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
@@ -1603,335 +1754,38 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs objects to containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD PADS
-            for( const MODULE* module = m_board->m_Modules;
-                 module;
-                 module = module->Next() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->PadsList(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                        *layerPoly,
-                                                                        0,
-                                                                        segcountforcircle,
-                                                                        correctionFactor );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to object containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:  // should not exist on copper layers
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( auto item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
-                {
-                case PCB_LINE_T: // should not exist on copper layers
-                {
-                    const int nrSegments =
-                            GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
-
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
-                                *layerPoly,
-                                0,
-                                nrSegments,
-                                GetCircleCorrectionFactor( nrSegments ) );
-                }
-                break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
-                                *layerPoly,
-                                0,
-                                segcountforcircle,
-                                correctionFactor );
-                break;
-
-                default:
-                    wxLogTrace( m_logTrace,
-                                wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                break;
-                }
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) )
-    {
-        if( aStatusTextReporter )
-            aStatusTextReporter->Report( _( "Create zones" ) );
-
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            if( aStatusTextReporter )
-                aStatusTextReporter->Report( wxString::Format( _( "Create zones of layer %s" ),
-                                                               LSET::Name( curr_layer_id ) ) );
-
-            wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-            CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-            // ADD COPPER ZONES
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                const ZONE_CONTAINER* zone = m_board->GetArea( ii );
-                const PCB_LAYER_ID zonelayer = zone->GetLayer();
-
-                if( zonelayer == curr_layer_id )
-                {
-                    AddSolidAreasShapesToContainer( zone,
-                                                    layerContainer,
-                                                    curr_layer_id );
-                }
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) &&
-        GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        // Add zones poly contourns
-        // /////////////////////////////////////////////////////////////////////
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD COPPER ZONES
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                const ZONE_CONTAINER* zone = m_board->GetArea( ii );
-                const LAYER_NUM zonelayer = zone->GetLayer();
-
-                if( zonelayer == curr_layer_id )
-                {
-                    zone->TransformSolidAreasShapesToPolygonSet( *layerPoly,
-                                                                 segcountforcircle,
-                                                                 correctionFactor );
-                }
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Simplify layer polygons
+    // Create the items and the polygons of each copper layer.  A layer is only made of
+    // board items, which are not modified, and of its own container and polygons, so the
+    // layers are created in parallel.
     // /////////////////////////////////////////////////////////////////////////
-
     if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying polygons" ) );
+        aStatusTextReporter->Report( _( "Create copper layers" ) );
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        const int nLayers = layer_id.size();
-
-        #pragma omp parallel for
-        for( signed int lIdx = 0; lIdx < nLayers; ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    const int nLayers = layer_id.size();
+    std::atomic<int> nLayersDone( 0 );
 
-            wxASSERT( layerPoly != NULL );
-
-            // This will make a union of all added contourns
-            layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
-
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    #pragma omp parallel for schedule(dynamic)
+    for( signed int lIdx = 0; lIdx < nLayers; ++lIdx )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        if( m_layers_outer_holes_poly.find( curr_layer_id ) !=
-            m_layers_outer_holes_poly.end() )
-        {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        createCopperLayer( layer_id[lIdx], trackList );
 
-            wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                      m_layers_inner_holes_poly.end() );
+        const int nDone = ++nLayersDone;
 
-            polyLayer = m_layers_inner_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
+        // The reporter belongs to the GUI, only the calling thread can use it
+        #ifdef _OPENMP
+        if( omp_get_thread_num() == 0 )
+        #endif
+            if( aStatusTextReporter )
+                aStatusTextReporter->Report( wxString::Format( _( "Create copper layers %d/%d" ),
+                                                               nDone, nLayers ) );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
+    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
 #endif
     // End Build Copper layers
 
@@ -29,11 +29,25 @@
 
 #include "cbvh_pbrt.h"
 #include <wx/debug.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <limits>
 
 
-#define BVH_RANGED_TRAVERSAL
 //#define BVH_PARTITION_TRAVERSAL
 
+#ifndef BVH_PARTITION_TRAVERSAL
+#define BVH_RANGED_TRAVERSAL
+#endif
+
+// SSE2 is part of every x86-64 CPU, so the boxes are tested against 4 rays at a time
+// when the target has it, without having to check the CPU at run time
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+#define BVH_PACKET_SSE
+#include <emmintrin.h>
+#endif
+
 
 #define MAX_TODOS 64
 
@@ -45,6 +59,173 @@ struct StackNode
 };
 
 
+#ifdef BVH_PACKET_SSE
+
+/// The origins and inverse directions of the rays of a packet, as structure of arrays.
+/// They are only filled once a box is tested against more rays than the first alive one:
+/// filling them costs more than tracing a packet that misses the whole scene.
+struct RAYPACKET_SOA
+{
+    alignas( 16 ) float m_origin[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 16 ) float m_invDir[3][RAYPACKET_RAYS_PER_PACKET];
+    bool                m_filled;
+};
+
+
+static inline const RAYPACKET_SOA &getRayPacketSoA( const RAYPACKET &aRayPacket,
+                                                    RAYPACKET_SOA &aSoA )
+{
+    if( !aSoA.m_filled )
+    {
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const RAY &ray = aRayPacket.m_ray[i];
+
+            for( unsigned int axis = 0; axis < 3; ++axis )
+            {
+                aSoA.m_origin[axis][i] = ray.m_Origin[axis];
+                aSoA.m_invDir[axis][i] = ray.m_InvDir[axis];
+            }
+        }
+
+        aSoA.m_filled = true;
+    }
+
+    return aSoA;
+}
+
+
+/// First (and last) set lane of a 4 lanes hit mask
+static const unsigned char s_firstLane[16] = { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+static const unsigned char s_lastLane[16]  = { 0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3 };
+
+
+// "An Efficient and Robust Ray-Box Intersection Algorithm"
+// http://www.cs.utah.edu/~awilliam/box/box.pdf
+// "Robust BVH Ray Traversal"
+// http://jcgt.org/published/0002/02/02/paper.pdf
+
+/**
+ * @brief intersect4 - slab test of the box against the 4 rays of the packet starting at
+ * aFirst, that must be a multiple of 4
+ * @return the mask of the rays that enter the box before their current hit
+ */
+static inline unsigned int intersect4( const RAYPACKET_SOA &aSoA,
+                                       unsigned int aFirst,
+                                       const CBBOX &aBBox,
+                                       const HITINFO_PACKET *aHitInfoPacket )
+{
+    // The far distance is enlarged by 1 + 2 * gamma( 3 ), so the rounding of the slab
+    // distances never culls a ray that hits the box
+    static const float farScale = 1.0f + 2.0f * ( 3.0f * FLT_EPSILON * 0.5f ) /
+                                             ( 1.0f - 3.0f * FLT_EPSILON * 0.5f );
+
+    const __m128 infinity = _mm_set1_ps( std::numeric_limits<float>::infinity() );
+
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar  = _mm_setr_ps( aHitInfoPacket[aFirst + 0].m_HitInfo.m_tHit,
+                                aHitInfoPacket[aFirst + 1].m_HitInfo.m_tHit,
+                                aHitInfoPacket[aFirst + 2].m_HitInfo.m_tHit,
+                                aHitInfoPacket[aFirst + 3].m_HitInfo.m_tHit );
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        const __m128 origin = _mm_load_ps( &aSoA.m_origin[axis][aFirst] );
+        const __m128 invDir = _mm_load_ps( &aSoA.m_invDir[axis][aFirst] );
+
+        const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Min()[axis] ), origin ),
+                                      invDir );
+        const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( aBBox.Max()[axis] ), origin ),
+                                      invDir );
+
+        // A ray parallel to the axis starting on a face of the box gives 0 * inf = NaN,
+        // this axis must then not cull it
+        const __m128 ordered = _mm_cmpord_ps( t0, t1 );
+
+        const __m128 slabNear = _mm_and_ps( ordered, _mm_min_ps( t0, t1 ) );
+        const __m128 slabFar  = _mm_or_ps( _mm_and_ps( ordered, _mm_max_ps( t0, t1 ) ),
+                                           _mm_andnot_ps( ordered, infinity ) );
+
+        tNear = _mm_max_ps( tNear, slabNear );
+        tFar  = _mm_min_ps( tFar,  slabFar );
+    }
+
+    tFar = _mm_mul_ps( tFar, _mm_set1_ps( farScale ) );
+
+    return (unsigned int)_mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) );
+}
+
+
+static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
+                                        RAYPACKET_SOA &aSoA,
+                                        const CBBOX &aBBox,
+                                        unsigned int ia,
+                                        HITINFO_PACKET *aHitInfoPacket )
+{
+    float hitT;
+
+    // The first alive ray is the most likely to hit, it is tested alone before the frustum
+    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
+        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
+            return ia;
+
+    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
+        return RAYPACKET_RAYS_PER_PACKET;
+
+    const RAYPACKET_SOA &soa = getRayPacketSoA( aRayPacket, aSoA );
+
+    // Only the rays after ia are searched in its block
+    unsigned int first = ia & ~3u;
+    unsigned int hits = intersect4( soa, first, aBBox, aHitInfoPacket ) &
+                        ( 0xEu << ( ia & 3u ) ) & 0xFu;
+
+    if( hits )
+        return first + s_firstLane[hits];
+
+    for( first += 4; first < RAYPACKET_RAYS_PER_PACKET; first += 4 )
+    {
+        hits = intersect4( soa, first, aBBox, aHitInfoPacket );
+
+        if( hits )
+            return first + s_firstLane[hits];
+    }
+
+    return RAYPACKET_RAYS_PER_PACKET;
+}
+
+
+#ifdef BVH_RANGED_TRAVERSAL
+
+static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
+                                       RAYPACKET_SOA &aSoA,
+                                       const CBBOX &aBBox,
+                                       unsigned int ia,
+                                       HITINFO_PACKET *aHitInfoPacket )
+{
+    const RAYPACKET_SOA &soa = getRayPacketSoA( aRayPacket, aSoA );
+    const unsigned int firstBlock = ia & ~3u;
+
+    for( unsigned int block = RAYPACKET_RAYS_PER_PACKET; block > firstBlock; )
+    {
+        block -= 4;
+
+        unsigned int hits = intersect4( soa, block, aBBox, aHitInfoPacket );
+
+        // Only the rays after ia are searched
+        if( block == firstBlock )
+            hits &= ~( ( 2u << ( ia & 3u ) ) - 1u ) & 0xFu;
+
+        if( hits )
+            return block + s_lastLane[hits] + 1;
+    }
+
+    return ia + 1;
+}
+
+#endif
+
+#else
+
 static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
                                         const CBBOX &aBBox,
                                         unsigned int ia,
@@ -89,6 +270,12 @@ static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
     return ia + 1;
 }
 
+#endif
+
+#endif
+
+
+#ifdef BVH_RANGED_TRAVERSAL
 
 // "Large Ray Packets for Real-time Whitted Ray Tracing"
 // http://cseweb.ucsd.edu/~ravir/whitted.pdf
@@ -109,11 +296,20 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
     unsigned int ia = 0;
 
+#ifdef BVH_PACKET_SSE
+    RAYPACKET_SOA soa;
+    soa.m_filled = false;
+#endif
+
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
+#ifdef BVH_PACKET_SSE
+        ia = getFirstHit( aRayPacket, soa, curCell->bounds, ia, aHitInfoPacket );
+#else
         ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+#endif
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -127,10 +323,15 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
+#ifdef BVH_PACKET_SSE
+                const unsigned int ie = getLastHit( aRayPacket, soa, curCell->bounds, ia,
+                                                    aHitInfoPacket );
+#else
                 const unsigned int ie = getLastHit( aRayPacket,
                                                     curCell->bounds,
                                                     ia,
                                                     aHitInfoPacket );
+#endif
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
@@ -175,34 +376,61 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
 #ifdef BVH_PARTITION_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
-                                       const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       const unsigned int *aRayIndex,
-                                       HITINFO_PACKET *aHitInfoPacket )
+#ifdef BVH_PACKET_SSE
+
+static_assert( RAYPACKET_RAYS_PER_PACKET <= 64, "the hit masks have a bit per ray" );
+
+/**
+ * @brief getHitMask - slab test of the box against all the rays of the packet, 4 at a time
+ * @return the mask of the rays that enter the box before their current hit
+ */
+static inline uint64_t getHitMask( const RAYPACKET_SOA &aSoA,
+                                   const CBBOX &aBBox,
+                                   const HITINFO_PACKET *aHitInfoPacket )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
+    uint64_t hits = 0;
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ aRayIndex[ie] ], &hitT ) )
-            if( hitT < aHitInfoPacket[ aRayIndex[ie] ].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
+    for( unsigned int first = 0; first < RAYPACKET_RAYS_PER_PACKET; first += 4 )
+        hits |= (uint64_t)intersect4( aSoA, first, aBBox, aHitInfoPacket ) << first;
 
-    return ia + 1;
+    return hits;
 }
 
 
 static inline unsigned int partRays( const RAYPACKET &aRayPacket,
+                                     RAYPACKET_SOA &aSoA,
                                      const CBBOX &aBBox,
                                      unsigned int ia,
                                      unsigned int *aRayIndex,
                                      HITINFO_PACKET *aHitInfoPacket )
 {
+    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
+        return 0;
+
+    const uint64_t hits = getHitMask( getRayPacketSoA( aRayPacket, aSoA ), aBBox,
+                                      aHitInfoPacket );
+
+    unsigned int ie = 0;
+
+    for( unsigned int i = 0; i < ia; ++i )
+    {
+        if( ( hits >> aRayIndex[i] ) & 1 )
+            std::swap( aRayIndex[ie++], aRayIndex[i] );
+    }
+
+    return ie;
+}
+
+#else
 
+static inline unsigned int partRays( const RAYPACKET &aRayPacket,
+                                     const CBBOX &aBBox,
+                                     unsigned int ia,
+                                     unsigned int *aRayIndex,
+                                     HITINFO_PACKET *aHitInfoPacket )
+{
     if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
+        return 0;
 
     unsigned int ie = 0;
 
@@ -217,10 +445,17 @@ static inline unsigned int partRays( const RAYPACKET &aRayPacket,
     return ie;
 }
 
+#endif
+
 
+// Partition Traversal: the rays aRayIndex[0] to aRayIndex[ia - 1] are the ones that hit
+// the box of the current node
 bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                            HITINFO_PACKET *aHitInfoPacket ) const
 {
+    if( m_nodes == NULL )
+        return false;
+
     bool anyHitted = false;
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
@@ -229,15 +464,24 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
     memcpy( I, m_I, RAYPACKET_RAYS_PER_PACKET * sizeof( unsigned int ) );
 
-    unsigned int ia = 0;
+    unsigned int ia = RAYPACKET_RAYS_PER_PACKET;
+
+#ifdef BVH_PACKET_SSE
+    RAYPACKET_SOA soa;
+    soa.m_filled = false;
+#endif
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
+#ifdef BVH_PACKET_SSE
+        ia = partRays( aRayPacket, soa, curCell->bounds, ia, I, aHitInfoPacket );
+#else
         ia = partRays( aRayPacket, curCell->bounds, ia, I, aHitInfoPacket );
+#endif
 
-        if( ia < RAYPACKET_RAYS_PER_PACKET )
+        if( ia > 0 )
         {
             if( curCell->nPrimitives == 0 )
             {
@@ -249,19 +493,13 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                unsigned int ie = getLastHit( aRayPacket,
-                                              curCell->bounds,
-                                              ia,
-                                              I,
-                                              aHitInfoPacket );
-
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
                     const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
 
                     if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
                     {
-                        for( unsigned int i = 0; i < ie; ++i )
+                        for( unsigned int i = 0; i < ia; ++i )
                         {
                             unsigned int idx = I[i];
 
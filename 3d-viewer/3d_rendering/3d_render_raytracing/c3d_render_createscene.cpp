@@ -47,6 +47,7 @@
 
 #include <base_units.h>
 #include <profile.h>        // To use GetRunningMicroSecs or an other profiling utility
+#include <algorithm>
 
 /**
   * Scale convertion from 3d model units to pcb units
@@ -1199,6 +1200,29 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Get all the models of the displayed modules from the cache at once, so they are
+    // loaded in parallel
+    std::vector<wxString> modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( !m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( !model.m_Filename.empty() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    std::sort( modelFiles.begin(), modelFiles.end() );
+    modelFiles.erase( std::unique( modelFiles.begin(), modelFiles.end() ), modelFiles.end() );
+
+    m_settings.Get3DCacheManager()->LoadModels( modelFiles );
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -29,6 +29,7 @@
 
 #include <GL/glew.h>
 #include <climits>
+#include <wx/image.h>
 
 #include "c3d_render_raytracing.h"
 #include "mortoncodes.h"
@@ -165,6 +166,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -190,6 +192,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -297,6 +300,105 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderToImage( const wxSize &aSize, wxImage &aImage,
+                                           REPORTER *aStatusTextReporter )
+{
+    // The block positions are computed with unsigned margins of this size
+    if( ( aSize.x <= (int)( 4 * RAYPACKET_DIM + 4 ) ) ||
+        ( aSize.y <= (int)( 4 * RAYPACKET_DIM + 4 ) ) )
+        return false;
+
+    const unsigned startTime = GetRunningMicroSecs();
+
+    // The sizes of the window, restored once the image is rendered
+    const wxSize windowSize = m_windowSize;
+    const wxSize cameraWindowSize = m_settings.CameraGet().GetCurWindowSize();
+
+    // Set the size without SetCurWindowSize(), that would also set the OpenGL viewport
+    m_windowSize = aSize;
+    m_settings.CameraGet().SetCurWindowSize( aSize );
+
+    if( m_reloadRequested )
+        reload( aStatusTextReporter );
+
+    const unsigned loadTime = GetRunningMicroSecs() - startTime;
+
+    initialize_block_positions();
+
+    // The render writes RGBA pixels, from the bottom row to the top one, as it would
+    // do in the PBO
+    std::vector< GLubyte > buffer( m_realBufferSize.x * m_realBufferSize.y * 4 );
+    unsigned stateTime[RT_RENDER_STATE_MAX] = { 0 };
+
+    // Set to an invalid state, so render() restarts from the tracing
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        const RT_RENDER_STATE state = ( m_rt_render_state < RT_RENDER_STATE_FINISH ) ?
+                                      m_rt_render_state : RT_RENDER_STATE_TRACING;
+        const unsigned stateStartTime = GetRunningMicroSecs();
+
+        render( &buffer[0], aStatusTextReporter );
+
+        stateTime[state] += GetRunningMicroSecs() - stateStartTime;
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    // The buffer is centered in the image, the margins get the background gradient
+    aImage.Create( aSize.x, aSize.y, false );
+    unsigned char *ptrImage = aImage.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const int bufferY = ( aSize.y - 1 - y ) - (int)m_yoffset;
+        const bool isBufferRow = ( bufferY >= 0 ) && ( bufferY < (int)m_realBufferSize.y );
+
+        const SFVEC3F bgColor = glm::mix( SFVEC3F( m_settings.m_BgColorTop ),
+                                          SFVEC3F( m_settings.m_BgColorBot ),
+                                          (float)y / (float)( aSize.y - 1 ) );
+
+        for( int x = 0; x < aSize.x; ++x, ptrImage += 3 )
+        {
+            const int bufferX = x - (int)m_xoffset;
+
+            if( isBufferRow && ( bufferX >= 0 ) && ( bufferX < (int)m_realBufferSize.x ) )
+            {
+                const GLubyte *ptr = &buffer[( bufferY * m_realBufferSize.x + bufferX ) * 4];
+
+                ptrImage[0] = ptr[0];
+                ptrImage[1] = ptr[1];
+                ptrImage[2] = ptr[2];
+            }
+            else
+            {
+                ptrImage[0] = (unsigned char)glm::clamp( (int)( bgColor.r * 255 ), 0, 255 );
+                ptrImage[1] = (unsigned char)glm::clamp( (int)( bgColor.g * 255 ), 0, 255 );
+                ptrImage[2] = (unsigned char)glm::clamp( (int)( bgColor.b * 255 ), 0, 255 );
+            }
+        }
+    }
+
+    wxLogTrace( m_logTrace,
+                wxT( "C3D_RENDER_RAYTRACING::RenderToImage %dx%d: load %.3f s, tracing %.3f s, "
+                     "post processing shade %.3f s, blur and finish %.3f s, total %.3f s" ),
+                aSize.x, aSize.y,
+                loadTime / 1e6,
+                stateTime[RT_RENDER_STATE_TRACING] / 1e6,
+                stateTime[RT_RENDER_STATE_POST_PROCESS_SHADE] / 1e6,
+                stateTime[RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH] / 1e6,
+                ( GetRunningMicroSecs() - startTime ) / 1e6 );
+
+    // The block positions and the PBO were left at the size of the image: the invalid old
+    // size makes the next Redraw() rebuild them for the window, and restart the render
+    m_windowSize = windowSize;
+    m_settings.CameraGet().SetCurWindowSize( cameraWindowSize );
+    m_oldWindowsSize = wxSize( 0, 0 );
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    return true;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -2136,6 +2238,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
@@ -41,6 +41,8 @@
 
 #include <map>
 
+class wxImage;
+
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 
@@ -69,6 +71,20 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * @brief RenderToImage - Render the scene at full quality into a memory buffer
+     * instead of the OpenGL PBO, so no OpenGL context is needed. The camera of the
+     * settings is used, with the aspect ratio of aSize. The time spent in each stage
+     * of the render is traced.
+     * @param aSize: the size of the image, at least 4 * RAYPACKET_DIM + 5 pixels
+     * in each direction
+     * @param aImage: receives the rendered image
+     * @param aStatusTextReporter: a pointer to the status progress reporter
+     * @return false if the size is too small to render anything
+     */
+    bool RenderToImage( const wxSize &aSize, wxImage &aImage,
+                        REPORTER *aStatusTextReporter = NULL );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
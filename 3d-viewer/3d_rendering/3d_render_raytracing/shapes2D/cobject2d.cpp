@@ -63,6 +63,6 @@ void COBJECT2D_STATS::PrintStats()
 
     for( unsigned int i = 0; i < OBJ2D_MAX; ++i )
     {
-        printf( "  %20s  %u\n", OBJECT2D_STR[i], m_counter[i] );
+        printf( "  %20s  %u\n", OBJECT2D_STR[i], m_counter[i].load() );
     }
 }
@@ -31,6 +31,7 @@
 #define _COBJECT2D_H_
 
 #include "cbbox2d.h"
+#include <atomic>
 #include <string.h>
 
 #include <class_board_item.h>
@@ -132,7 +133,11 @@ public:
 class COBJECT2D_STATS
 {
 public:
-    void ResetStats() { memset( m_counter, 0, sizeof( unsigned int ) * OBJ2D_MAX ); }
+    void ResetStats()
+    {
+        for( unsigned int i = 0; i < OBJ2D_MAX; ++i )
+            m_counter[i] = 0;
+    }
 
     unsigned int GetCountOf( OBJECT2D_TYPE aObjType ) const
     {
@@ -158,7 +163,8 @@ private:
     ~COBJECT2D_STATS(){}
 
 private:
-    unsigned int m_counter[OBJ2D_MAX];
+    // The objects of the copper layers are created in parallel
+    std::atomic<unsigned int> m_counter[OBJ2D_MAX];
 
     static COBJECT2D_STATS *s_instance;
 };
@@ -168,6 +168,12 @@ class CCAMERA
      */
     bool SetCurWindowSize( const wxSize &aSize );
 
+    /**
+     * @brief GetCurWindowSize
+     * @return the windows size of the camera, as set by SetCurWindowSize()
+     */
+    wxSize GetCurWindowSize() const { return wxSize( m_windowSize.x, m_windowSize.y ); }
+
     void ZoomReset();
 
     bool Zoom( float aFactor );
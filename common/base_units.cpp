@@ -39,6 +39,7 @@
 #include <class_title_block.h>
 #include <common.h>
 #include <base_units.h>
+#include <kicad_string.h>
 #include "libeval/numeric_evaluator.h"
 
 
@@ -53,38 +54,12 @@
 
 
 // Helper function to print a float number without using scientific notation
-// and no trailing 0
-// So we cannot always just use the %g or the %f format to print a fp number
-// this helper function uses the %f format when needed, or %g when %f is
-// not well working and then removes trailing 0
+// and no trailing 0.
+// FormatDouble() does the job without depending on the current locale.
 
 std::string Double2Str( double aValue )
 {
-    char    buf[50];
-    int     len;
-
-    if( aValue != 0.0 && fabs( aValue ) <= 0.0001 )
-    {
-        // For these small values, %f works fine,
-        // and %g gives an exponent
-        len = sprintf( buf,  "%.16f", aValue );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
-    {
-        // For these values, %g works fine, and sometimes %f
-        // gives a bad value (try aValue = 1.222222222222, with %.16f format!)
-        len = sprintf( buf, "%.16g", aValue );
-    }
-
-    return std::string( buf, len );
+    return FormatDouble( aValue, 16 );
 }
 
 
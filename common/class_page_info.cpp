@@ -25,6 +25,7 @@
 
 #include <common.h>
 #include <class_page_info.h>
+#include <kicad_string.h>
 #include <macros.h>
 
 
@@ -271,9 +272,9 @@ void PAGE_INFO::Format( OUTPUTFORMATTER* aFormatter, int aNestLevel, int aContro
     // The page dimensions are only required for user defined page sizes.
     // Internally, the page size is in mils
     if( GetType() == PAGE_INFO::Custom )
-        aFormatter->Print( 0, " %g %g",
-                           GetWidthMils() * 25.4 / 1000.0,
-                           GetHeightMils() * 25.4 / 1000.0 );
+        aFormatter->Print( 0, " %s %s",
+                           FormatDouble( GetWidthMils() * 25.4 / 1000.0, 6 ).c_str(),
+                           FormatDouble( GetHeightMils() * 25.4 / 1000.0, 6 ).c_str() );
 
     if( !IsCustom() && IsPortrait() )
         aFormatter->Print( 0, " portrait" );
@@ -42,6 +42,8 @@
 
 #include <pgm_base.h>
 
+#include <mutex>
+
 using KIGFX::COLOR4D;
 
 
@@ -165,6 +167,10 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags, wxProcess *callbac
 
 time_t GetNewTimeStamp()
 {
+    // Items can be created by several threads, e.g. when loading a schematic
+    static std::mutex timeStampMutex;
+    std::lock_guard<std::mutex> lock( timeStampMutex );
+
     static time_t oldTimeStamp;
     time_t newTimeStamp;
 
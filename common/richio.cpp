@@ -23,10 +23,21 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
+#ifdef _WIN32
+#include <wx/msw/wrapwin.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <richio.h>
+#include <kicad_string.h>
 
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
@@ -225,13 +236,15 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
-STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
+STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                                        unsigned aStartingLineNumber ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
 {
     // Clipboard text should be nice and _use multiple lines_ so that
     // we can report _line number_ oriented error messages when parsing.
     m_source = aSource;
+    m_lineNum = aStartingLineNumber;
 }
 
 
@@ -278,6 +291,138 @@ char* STRING_LINE_READER::ReadLine()
 }
 
 
+MEMORY_LINE_READER::MEMORY_LINE_READER( const char* aBuffer, size_t aSize,
+                                        const wxString& aSource, unsigned aStartingLineNumber ) :
+    LINE_READER( 0 ),   // no line buffer, the lines are returned in place
+    m_buffer( aBuffer ), m_size( aSize ), m_ndx( 0 )
+{
+    m_source  = aSource;
+    m_lineNum = aStartingLineNumber;
+}
+
+
+MEMORY_LINE_READER::~MEMORY_LINE_READER()
+{
+    // m_line points into m_buffer, do not let ~LINE_READER() free it
+    m_line = NULL;
+}
+
+
+char* MEMORY_LINE_READER::ReadLine()
+{
+    const char* begin = m_buffer + m_ndx;
+    const char* nl = (const char*) memchr( begin, '\n', m_size - m_ndx );
+
+    if( nl )
+        m_length = nl - begin + 1;     // include the newline, so +1
+    else
+        m_length = m_size - m_ndx;
+
+    // the buffer is never written to, LINE_READER just does not know about const lines
+    m_line = const_cast<char*>( begin );
+    m_ndx += m_length;
+
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+
+    return m_length ? m_line : NULL;
+}
+
+
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName ) :
+    MEMORY_LINE_READER( "", 0, aFileName )
+{
+    wxString msg = wxString::Format(
+        _( "Unable to open filename '%s' for reading" ), aFileName.GetData() );
+
+#ifdef _WIN32
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+
+    HANDLE        file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    LARGE_INTEGER size;
+
+    if( file == INVALID_HANDLE_VALUE )
+        THROW_IO_ERROR( msg );
+
+    if( !GetFileSizeEx( file, &size ) )
+    {
+        CloseHandle( file );
+        THROW_IO_ERROR( msg );
+    }
+
+    m_file = file;
+
+    if( size.QuadPart > 0 )
+    {
+        m_mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        void* view = m_mapping ? MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+
+        if( !view )
+        {
+            if( m_mapping )
+                CloseHandle( m_mapping );
+
+            CloseHandle( file );
+            THROW_IO_ERROR( msg );
+        }
+
+        m_buffer = (const char*) view;
+        m_size = (size_t) size.QuadPart;
+    }
+#else
+    int         fd = open( aFileName.fn_str(), O_RDONLY );
+    struct stat st;
+
+    if( fd < 0 )
+        THROW_IO_ERROR( msg );
+
+    if( fstat( fd, &st ) < 0 )
+    {
+        close( fd );
+        THROW_IO_ERROR( msg );
+    }
+
+    if( st.st_size > 0 )
+    {
+        void* view = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( view == MAP_FAILED )
+        {
+            close( fd );
+            THROW_IO_ERROR( msg );
+        }
+
+        // The file is read once from start to end
+        madvise( view, st.st_size, MADV_SEQUENTIAL );
+
+        m_buffer = (const char*) view;
+        m_size = st.st_size;
+    }
+
+    // The mapping stays valid after the file is closed
+    close( fd );
+#endif
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+#ifdef _WIN32
+    if( m_size )
+    {
+        UnmapViewOfFile( m_buffer );
+        CloseHandle( m_mapping );
+    }
+
+    CloseHandle( m_file );
+#else
+    if( m_size )
+        munmap( const_cast<char*>( m_buffer ), m_size );
+#endif
+}
+
+
 INPUTSTREAM_LINE_READER::INPUTSTREAM_LINE_READER( wxInputStream* aStream, const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_stream( aStream )
@@ -389,44 +534,82 @@ int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )
 }
 
 
-int OUTPUTFORMATTER::sprint( const char* fmt, ... )
+int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... )
 {
+#define NESTWIDTH           2   ///< how many spaces per nestLevel
+
     va_list     args;
 
     va_start( args, fmt );
-    int ret = vprint( fmt, args);
+
+    int total = nestLevel > 0 ? nestLevel * NESTWIDTH : 0;
+
+    // no error checking needed, an exception indicates an error.
+    Indent( nestLevel );
+
+    total += vprint( fmt, args );
+
     va_end( args );
 
-    return ret;
+    return total;
 }
 
 
-int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... )
+void OUTPUTFORMATTER::Indent( int aNestLevel )
 {
-#define NESTWIDTH           2   ///< how many spaces per nestLevel
+    static const char spaces[] = "                                                                ";
+    const int         chunk = sizeof( spaces ) - 1;
 
-    va_list     args;
+    for( int count = aNestLevel * NESTWIDTH;  count > 0;  count -= chunk )
+        write( spaces, std::min( count, chunk ) );
+}
 
-    va_start( args, fmt );
 
-    int result = 0;
-    int total  = 0;
+void OUTPUTFORMATTER::AppendInt( long aValue )
+{
+    char  buf[24];
+    char* end = buf + sizeof( buf );
+    char* p = end;
+
+    // work on the magnitude as unsigned, so LONG_MIN does not overflow
+    unsigned long magnitude = aValue < 0 ? 0UL - (unsigned long) aValue : aValue;
 
-    for( int i=0; i<nestLevel;  ++i )
+    do
     {
-        // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+        *--p = '0' + ( magnitude % 10 );
+        magnitude /= 10;
+    } while( magnitude );
 
-        total += result;
-    }
+    if( aValue < 0 )
+        *--p = '-';
 
-    // no error checking needed, an exception indicates an error.
-    result = vprint( fmt, args );
+    write( p, end - p );
+}
 
-    va_end( args );
 
-    total += result;
-    return total;
+void OUTPUTFORMATTER::AppendHex( unsigned long aValue )
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    char  buf[24];
+    char* end = buf + sizeof( buf );
+    char* p = end;
+
+    do
+    {
+        *--p = digits[aValue & 0xF];
+        aValue >>= 4;
+    } while( aValue );
+
+    write( p, end - p );
+}
+
+
+void OUTPUTFORMATTER::AppendDouble( double aValue, int aPrecision )
+{
+    char buf[FORMAT_DOUBLE_BUFSIZE];
+
+    write( buf, FormatDouble( buf, aValue, aPrecision ) );
 }
 
 
@@ -528,6 +711,10 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
                             m_filename.GetData() );
         THROW_IO_ERROR( msg );
     }
+
+    // The token functions write many small pieces, give them a buffer large enough
+    // to keep the number of actual writes low
+    setvbuf( m_fp, NULL, _IOFBF, 64 * 1024 );
 }
 
 
@@ -31,6 +31,15 @@
 #include <richio.h>                        // StrPrintf
 #include <kicad_string.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
 
 /**
  * Illegal file name characters used to insure file names will be valid on all supported
@@ -507,3 +516,434 @@ bool ReplaceIllegalFileNameChars( std::string* aName, int aReplaceChar )
 
     return changed;
 }
+
+
+// Powers of ten that are exactly representable in a double
+static const double exactPowersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int maxExactPowerOf10 = 22;
+
+// Integers up to 2^53 are exactly representable in a double
+static const uint64_t maxExactMantissa = 1ULL << 53;
+
+
+// Reads \a aWord at \a aText, ignoring the case.  Returns the end of the word in \a aText,
+// or NULL if \a aText does not start with it.
+static const char* matchWord( const char* aText, const char* aWord )
+{
+    for( ; *aWord; ++aText, ++aWord )
+    {
+        if( tolower( (unsigned char) *aText ) != *aWord )
+            return NULL;
+    }
+
+    return aText;
+}
+
+
+// Reads the hexadecimal number after "0x", like strtod() does.  Returns NULL if there is no
+// hexadecimal digit.
+static const char* parseHexDouble( const char* aText, double* aValue )
+{
+    const char* p = aText;
+    uint64_t    mantissa = 0;
+    int         exponent = 0;       // binary exponent applied to mantissa
+    bool        found = false;
+
+    // 15 digits (60 bits) are more than the 53 bits of a double: the digits after them are
+    // only kept as a sticky bit, so the conversion to double still rounds correctly
+    auto addDigit = [&]( int aDigit, bool aFraction )
+    {
+        found = true;
+
+        if( mantissa < ( 1ULL << 56 ) )
+        {
+            mantissa = mantissa * 16 + aDigit;
+
+            if( aFraction )
+                exponent -= 4;
+        }
+        else
+        {
+            mantissa |= ( aDigit != 0 );
+
+            if( !aFraction )
+                exponent += 4;
+        }
+    };
+
+    for( ; isxdigit( (unsigned char) *p ); ++p )
+        addDigit( isdigit( (unsigned char) *p ) ? *p - '0' : tolower( (unsigned char) *p ) - 'a' + 10, false );
+
+    if( *p == '.' )
+    {
+        for( ++p; isxdigit( (unsigned char) *p ); ++p )
+            addDigit( isdigit( (unsigned char) *p ) ? *p - '0' : tolower( (unsigned char) *p ) - 'a' + 10, true );
+    }
+
+    if( !found )
+        return NULL;
+
+    if( *p == 'p' || *p == 'P' )
+    {
+        const char* q = p + 1;
+        bool        negativeExp = false;
+        int         exp = 0;
+
+        if( *q == '-' || *q == '+' )
+            negativeExp = ( *q++ == '-' );
+
+        if( isdigit( (unsigned char) *q ) )
+        {
+            for( ; isdigit( (unsigned char) *q ); ++q )
+            {
+                if( exp < 100000 )
+                    exp = exp * 10 + ( *q - '0' );
+            }
+
+            exponent += negativeExp ? -exp : exp;
+            p = q;
+        }
+    }
+
+    *aValue = ldexp( (double) mantissa, exponent );
+
+    if( *aValue != 0.0 && !std::isnormal( *aValue ) )
+        errno = ERANGE;
+
+    return p;
+}
+
+
+double ParseDouble( const char* aText, const char** aEnd )
+{
+    const char* p = aText;
+    bool        negative = false;
+    uint64_t    mantissa = 0;
+    int         digits = 0;         // significant digits stored in mantissa
+    int         exponent = 0;       // decimal exponent applied to mantissa
+    bool        truncated = false;  // some non zero digits did not fit in mantissa
+    bool        found = false;
+
+    if( aEnd )
+        *aEnd = aText;
+
+    while( isspace( (unsigned char) *p ) )
+        ++p;
+
+    if( *p == '-' || *p == '+' )
+        negative = ( *p++ == '-' );
+
+    // The other forms accepted by strtod(): hexadecimal numbers, infinities and NaNs
+    if( p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' ) )
+    {
+        double      value;
+        const char* end = parseHexDouble( p + 2, &value );
+
+        if( end )
+        {
+            if( aEnd )
+                *aEnd = end;
+
+            return negative ? -value : value;
+        }
+    }
+    else if( const char* end = matchWord( p, "inf" ) )
+    {
+        if( const char* longEnd = matchWord( end, "inity" ) )
+            end = longEnd;
+
+        if( aEnd )
+            *aEnd = end;
+
+        return negative ? -HUGE_VAL : HUGE_VAL;
+    }
+    else if( const char* end = matchWord( p, "nan" ) )
+    {
+        // An optional "(chars)" sequence follows
+        if( *end == '(' )
+        {
+            const char* q = end + 1;
+
+            while( isalnum( (unsigned char) *q ) || *q == '_' )
+                ++q;
+
+            if( *q == ')' )
+                end = q + 1;
+        }
+
+        if( aEnd )
+            *aEnd = end;
+
+        return negative ? -NAN : NAN;
+    }
+
+    for( ; isdigit( (unsigned char) *p ); ++p )
+    {
+        found = true;
+
+        if( digits < 19 )
+        {
+            mantissa = mantissa * 10 + ( *p - '0' );
+
+            if( mantissa )
+                ++digits;
+        }
+        else
+        {
+            truncated |= ( *p != '0' );
+            ++exponent;
+        }
+    }
+
+    if( *p == '.' )
+    {
+        for( ++p; isdigit( (unsigned char) *p ); ++p )
+        {
+            found = true;
+
+            if( digits < 19 )
+            {
+                mantissa = mantissa * 10 + ( *p - '0' );
+                --exponent;
+
+                if( mantissa )
+                    ++digits;
+            }
+            else
+            {
+                truncated |= ( *p != '0' );
+            }
+        }
+    }
+
+    if( !found )
+        return 0.0;
+
+    const char* numberEnd = p;
+
+    if( *p == 'e' || *p == 'E' )
+    {
+        const char* q = p + 1;
+        bool        negativeExp = false;
+        int         exp = 0;
+
+        if( *q == '-' || *q == '+' )
+            negativeExp = ( *q++ == '-' );
+
+        if( isdigit( (unsigned char) *q ) )
+        {
+            for( ; isdigit( (unsigned char) *q ); ++q )
+            {
+                if( exp < 100000 )
+                    exp = exp * 10 + ( *q - '0' );
+            }
+
+            exponent += negativeExp ? -exp : exp;
+            numberEnd = q;
+        }
+    }
+
+    if( aEnd )
+        *aEnd = numberEnd;
+
+    double value;
+
+    if( mantissa == 0 )
+    {
+        value = 0.0;
+    }
+    else if( !truncated && mantissa <= maxExactMantissa &&
+             exponent >= -maxExactPowerOf10 && exponent <= maxExactPowerOf10 )
+    {
+        // Both operands are exact, so the single multiplication or division is correctly
+        // rounded. This covers every number found in KiCad files.
+        value = (double) mantissa;
+
+        if( exponent < 0 )
+            value /= exactPowersOf10[-exponent];
+        else
+            value *= exactPowersOf10[exponent];
+    }
+    else
+    {
+        // Rare case: let the C++ library do the correct rounding, with an explicit locale
+        std::istringstream stream( std::string( aText, numberEnd ) );
+        stream.imbue( std::locale::classic() );
+        stream >> value;
+
+        if( stream.fail() )
+        {
+            // Out of range: the stream only says so, whatever the sign is
+            errno = ERANGE;
+            value = exponent > 0 ? HUGE_VAL : 0.0;
+
+            return negative ? -value : value;
+        }
+
+        return value;   // stream already applied the sign
+    }
+
+    return negative ? -value : value;
+}
+
+
+// Prints \a aValue with snprintf( \a aFormat ), then replaces the decimal separator of the
+// current locale (which may be several chars long, or not a '.') by a '.'.  printf() only
+// reads the locale, so unlike a LOCALE_IO this can be done from several threads at once.
+static int printNumber( char* aBuffer, const char* aFormat, int aPrecision, double aValue )
+{
+    char buf[FORMAT_DOUBLE_BUFSIZE * 2];
+    int  len = snprintf( buf, sizeof( buf ), aFormat, aPrecision, aValue );
+
+    len = std::min( std::max( len, 0 ), (int) sizeof( buf ) - 1 );
+
+    int  out = 0;
+    bool separator = false;
+
+    for( int i = 0; i < len && out < FORMAT_DOUBLE_BUFSIZE - 1; ++i )
+    {
+        char c = buf[i];
+        bool numberChar = ( c >= '0' && c <= '9' ) || c == '-' || c == '+' ||
+                          ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' );
+
+        if( numberChar )
+        {
+            aBuffer[out++] = c;
+            separator = false;
+        }
+        else if( !separator )
+        {
+            aBuffer[out++] = '.';
+            separator = true;
+        }
+    }
+
+    aBuffer[out] = '\0';
+
+    return out;
+}
+
+
+// Removes the trailing zeros of a number printed in fixed notation, and its decimal point
+// if no decimal is left
+static int trimZeros( char* aBuffer, int aLen )
+{
+    if( !memchr( aBuffer, '.', aLen ) )
+        return aLen;
+
+    while( aLen > 0 && aBuffer[aLen - 1] == '0' )
+        --aLen;
+
+    if( aLen > 0 && aBuffer[aLen - 1] == '.' )
+        --aLen;
+
+    aBuffer[aLen] = '\0';
+
+    return aLen;
+}
+
+
+int FormatDouble( char* aBuffer, double aValue, int aPrecision, bool aFixedSmallValues )
+{
+    double magnitude = fabs( aValue );
+    bool   smallValue = aFixedSmallValues && aValue != 0.0 && magnitude <= 0.0001;
+
+    aPrecision = std::min( std::max( aPrecision, 0 ), 17 );
+
+    // Fast path, for the values that have a short exact decimal form: up to 15 significant
+    // digits (DBL_DIG), "%.*g" prints that form, so it can be printed from an integer.  With
+    // more digits, "%.*g" may print the binary rounding error, as in 9.199999999999999.
+    if( aValue == 0.0 )
+    {
+        strcpy( aBuffer, std::signbit( aValue ) ? "-0" : "0" );
+        return (int) strlen( aBuffer );
+    }
+
+    // "%.0g" is the same as "%.1g"
+    int maxPrecision = std::max( aPrecision, 1 );
+
+    if( std::isfinite( aValue ) &&
+        ( smallValue || ( maxPrecision <= 15 && magnitude >= 0.0001 &&
+                          magnitude < exactPowersOf10[maxPrecision] ) ) )
+    {
+        uint64_t mantissa = 0;
+        int      decimals = 0;
+        bool     found = false;
+
+        // Find the fewest decimals giving back the same value.  The scaled value is an exact
+        // integer below 2^53, so the round trip is the same division as in ParseDouble().
+        for( ; decimals <= maxExactPowerOf10; ++decimals )
+        {
+            double scaled = magnitude * exactPowersOf10[decimals];
+
+            if( scaled >= (double) maxExactMantissa )
+                break;
+
+            mantissa = (uint64_t) ( scaled + 0.5 );
+
+            if( (double) mantissa / exactPowersOf10[decimals] == magnitude )
+            {
+                found = true;
+                break;
+            }
+        }
+
+        int digits = 0;
+
+        for( uint64_t m = mantissa; m; m /= 10 )
+            ++digits;
+
+        // In fixed notation, "%.*f" of the small values keeps aPrecision decimals
+        if( found && ( smallValue ? decimals <= aPrecision : digits <= maxPrecision ) )
+        {
+            char  buf[48];
+            char* end = buf + sizeof( buf );
+            char* p = end;
+            int   count = 0;
+
+            do
+            {
+                *--p = '0' + ( mantissa % 10 );
+                mantissa /= 10;
+
+                if( ++count == decimals )
+                    *--p = '.';
+            } while( mantissa || count < decimals );
+
+            if( *p == '.' )
+                *--p = '0';
+
+            if( aValue < 0.0 )
+                *--p = '-';
+
+            int len = (int) ( end - p );
+
+            memcpy( aBuffer, p, len );
+            aBuffer[len] = '\0';
+
+            return len;
+        }
+    }
+
+    if( smallValue )
+    {
+        // "%g" would give an exponent for these values
+        return trimZeros( aBuffer, printNumber( aBuffer, "%.*f", aPrecision, aValue ) );
+    }
+
+    return printNumber( aBuffer, "%.*g", aPrecision, aValue );
+}
+
+
+std::string FormatDouble( double aValue, int aPrecision, bool aFixedSmallValues )
+{
+    char buf[FORMAT_DOUBLE_BUFSIZE];
+    int  len = FormatDouble( buf, aValue, aPrecision, aFixedSmallValues );
+
+    return std::string( buf, len );
+}
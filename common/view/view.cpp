@@ -35,12 +35,14 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
-#ifdef __WXDEBUG__
 #include <profile.h>
-#endif /* __WXDEBUG__  */
 
 namespace KIGFX {
 
+/// Size (in pixels) below which the items allowing it (see VIEW_ITEM::ViewAllowsSizeCulling())
+/// are not drawn at all
+static const double MIN_ITEM_SCREEN_SIZE = 1.0;
+
 class VIEW;
 
 class VIEW_ITEM_DATA
@@ -91,6 +93,7 @@ private:
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
+    BOX2I   m_bbox;             ///< Bounding box used when the item was last indexed
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -324,6 +327,7 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
+    aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
 
     m_allItems.push_back( aItem );
 
@@ -819,20 +823,32 @@ struct VIEW::drawItem
     drawItem( VIEW* aView, int aLayer, bool aUseDrawPriority, bool aReverseDrawOrder ) :
         view( aView ), layer( aLayer ),
         useDrawPriority( aUseDrawPriority ),
-        reverseDrawOrder( aReverseDrawOrder )
+        reverseDrawOrder( aReverseDrawOrder ),
+        culledCount( 0 )
     {
+        // Minimal item size, converted from screen pixels to world units
+        minSize = MIN_ITEM_SCREEN_SIZE / view->m_gal->GetWorldScale();
     }
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        wxASSERT( aItem->viewPrivData() );
+        auto viewData = aItem->viewPrivData();
+        wxASSERT( viewData );
 
         // Conditions that have to be fulfilled for an item to be drawn
-        bool drawCondition = aItem->viewPrivData()->isRenderable() &&
+        bool drawCondition = viewData->isRenderable() &&
                              aItem->ViewGetLOD( layer, view ) < view->m_scale;
         if( !drawCondition )
             return true;
 
+        // Do not waste time on items that would cover less than the minimal screen size
+        if( aItem->ViewAllowsSizeCulling( layer ) &&
+            std::max( viewData->m_bbox.GetWidth(), viewData->m_bbox.GetHeight() ) < minSize )
+        {
+            culledCount++;
+            return true;
+        }
+
         if( useDrawPriority )
             drawItems.push_back( aItem );
         else
@@ -861,12 +877,16 @@ struct VIEW::drawItem
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
     bool useDrawPriority, reverseDrawOrder;
+    double minSize;
+    int culledCount;
     std::vector<VIEW_ITEM*> drawItems;
 };
 
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    int culledCount = 0;
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
@@ -879,8 +899,12 @@ void VIEW::redrawRect( const BOX2I& aRect )
 
             if( m_useDrawPriority )
                 drawFunc.deferredDraw();
+
+            culledCount += drawFunc.culledCount;
         }
     }
+
+    wxLogTrace( "GAL_PROFILE", wxT( "VIEW::redrawRect(): %d items too small to be drawn" ), culledCount );
 }
 
 
@@ -1178,6 +1202,7 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
     int layers[VIEW_MAX_LAYERS], layers_count;
 
     aItem->ViewGetLayers( layers, layers_count );
+    aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; ++i )
     {
@@ -1222,6 +1247,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
@@ -1271,6 +1297,29 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
+    PROF_COUNTER totalRealTime;
+    std::vector<VIEW_ITEM*> geometryUpdates;
+
+    for( VIEW_ITEM* item : m_allItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        if( viewData && ( viewData->m_requiredUpdate & ( INITIAL_ADD | GEOMETRY | LAYERS ) ) )
+            geometryUpdates.push_back( item );
+    }
+
+    // First compute the GAL-independent part of the new geometry in parallel...
+    PROF_COUNTER prepareTime;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for( int i = 0; i < (int) geometryUpdates.size(); ++i )
+        m_painter->PrepareItem( geometryUpdates[i] );
+
+    prepareTime.Stop();
+
+    // ...then upload it to the GAL, which can only be done from a single thread
     m_gal->BeginUpdate();
 
     for( VIEW_ITEM* item : m_allItems )
@@ -1288,6 +1337,14 @@ void VIEW::UpdateItems()
     }
 
     m_gal->EndUpdate();
+
+    totalRealTime.Stop();
+
+    if( !geometryUpdates.empty() )
+    {
+        wxLogTrace( "GAL_PROFILE", wxT( "VIEW::UpdateItems(): %d items, %.1f ms prepare, %.1f ms total" ),
+                    (int) geometryUpdates.size(), prepareTime.msecs(), totalRealTime.msecs() );
+    }
 }
 
 
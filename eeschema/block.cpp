@@ -129,6 +129,7 @@ void SCH_EDIT_FRAME::HandleBlockPlace( wxDC* DC )
 
         SaveCopyInUndoList( block->GetItems(), UR_MOVED, false, block->GetMoveVector() );
         MoveItemsInList( block->GetItems(), block->GetMoveVector() );
+        GetScreen()->InvalidateItemIndex();
         block->ClearItemsList();
         break;
 
@@ -218,6 +219,7 @@ bool SCH_EDIT_FRAME::HandleBlockEnd( wxDC* aDC )
                 SetCrossHairPosition( rotationPoint );
                 SaveCopyInUndoList( block->GetItems(), UR_ROTATED, false, rotationPoint );
                 RotateListOfItems( block->GetItems(), rotationPoint );
+                GetScreen()->InvalidateItemIndex();
                 OnModify();
             }
 
@@ -332,6 +334,7 @@ bool SCH_EDIT_FRAME::HandleBlockEnd( wxDC* aDC )
                 SetCrossHairPosition( mirrorPoint );
                 SaveCopyInUndoList( block->GetItems(), UR_MIRRORED_X, false, mirrorPoint );
                 MirrorX( block->GetItems(), mirrorPoint );
+                GetScreen()->InvalidateItemIndex();
                 OnModify();
             }
 
@@ -351,6 +354,7 @@ bool SCH_EDIT_FRAME::HandleBlockEnd( wxDC* aDC )
                 SetCrossHairPosition( mirrorPoint );
                 SaveCopyInUndoList( block->GetItems(), UR_MIRRORED_Y, false, mirrorPoint );
                 MirrorY( block->GetItems(), mirrorPoint );
+                GetScreen()->InvalidateItemIndex();
                 OnModify();
             }
 
@@ -536,6 +540,7 @@ void SCH_EDIT_FRAME::PasteListOfItems( wxDC* DC )
     SaveCopyInUndoList( picklist, UR_NEW );
 
     MoveItemsInList( picklist, GetScreen()->m_BlockLocate.GetMoveVector() );
+    GetScreen()->InvalidateItemIndex();
 
     // Clear flags for all items.
     GetScreen()->ClearDrawingState();
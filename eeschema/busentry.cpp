@@ -76,6 +76,7 @@ void SCH_EDIT_FRAME::SetBusEntryShape( wxDC* DC, SCH_BUS_ENTRY_BASE* BusEntry, c
 
     BusEntry->Draw( m_canvas, DC, wxPoint( 0, 0 ), g_XorMode );
     BusEntry->SetBusEntryShape( s_LastShape );
+    GetScreen()->InvalidateItemIndex();
     GetScreen()->TestDanglingEnds();
     BusEntry->Draw( m_canvas, DC, wxPoint( 0, 0 ), g_XorMode );
 
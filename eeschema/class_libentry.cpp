@@ -178,7 +178,8 @@ struct null_deleter
 
 LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
     EDA_ITEM( LIB_PART_T ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_deferredDrawings( false )
 {
     m_name                = aName;
     m_library             = aLibrary;
@@ -208,10 +209,13 @@ LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
 
 LIB_PART::LIB_PART( LIB_PART& aPart, PART_LIB* aLibrary ) :
     EDA_ITEM( aPart ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_deferredDrawings( false )
 {
     LIB_ITEM* newItem;
 
+    aPart.ensureDrawings();
+
     m_library             = aLibrary;
     m_name                = aPart.m_name;
     m_FootprintList       = aPart.m_FootprintList;
@@ -259,6 +263,32 @@ LIB_PART::~LIB_PART()
 }
 
 
+void LIB_PART::SetDeferredDrawings( std::function<void( LIB_PART* )> aLoader )
+{
+    std::lock_guard<std::recursive_mutex> lock( m_drawingsLock );
+
+    m_drawingsLoader = aLoader;
+    m_deferredDrawings = (bool) aLoader;
+}
+
+
+void LIB_PART::loadDeferredDrawings()
+{
+    std::lock_guard<std::recursive_mutex> lock( m_drawingsLock );
+
+    // Already loaded by another thread, or called again by the loader itself
+    if( !m_drawingsLoader )
+        return;
+
+    std::function<void( LIB_PART* )> loader;
+
+    loader.swap( m_drawingsLoader );
+    loader( this );
+
+    m_deferredDrawings = false;
+}
+
+
 const wxString LIB_PART::GetLibraryName()
 {
     if( m_library )
@@ -316,6 +346,8 @@ void LIB_PART::SetName( const wxString& aName )
 void LIB_PART::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDc, const wxPoint& aOffset,
             int aMulti, int aConvert, const PART_DRAW_OPTIONS& aOpts )
 {
+    ensureDrawings();
+
     BASE_SCREEN*   screen = aPanel ? aPanel->GetScreen() : NULL;
 
     GRSetDrawMode( aDc, aOpts.draw_mode );
@@ -456,6 +488,8 @@ void LIB_PART::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDc, const wxPoint& aOffset,
 void LIB_PART::Plot( PLOTTER* aPlotter, int aUnit, int aConvert,
                           const wxPoint& aOffset, const TRANSFORM& aTransform )
 {
+    ensureDrawings();
+
     wxASSERT( aPlotter != NULL );
 
     aPlotter->SetColor( GetLayerColor( LAYER_DEVICE ) );
@@ -534,6 +568,8 @@ void LIB_PART::PlotLibFields( PLOTTER* aPlotter, int aUnit, int aConvert,
 
 void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem, EDA_DRAW_PANEL* aPanel, wxDC* aDc )
 {
+    ensureDrawings();
+
     wxASSERT( aItem != NULL );
 
     // none of the MANDATORY_FIELDS may be removed in RAM, but they may be
@@ -572,6 +608,8 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem, EDA_DRAW_PANEL* aPanel, wxDC* aD
 
 void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
 {
+    ensureDrawings();
+
     wxASSERT( aItem != NULL );
 
     m_drawings.push_back( aItem );
@@ -580,6 +618,8 @@ void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
 
 LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
 {
+    ensureDrawings();
+
     if( m_drawings.empty( aType ) )
         return NULL;
 
@@ -608,6 +648,8 @@ LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
 
 void LIB_PART::GetPins( LIB_PINS& aList, int aUnit, int aConvert )
 {
+    ensureDrawings();
+
     if( m_drawings.empty( LIB_PIN_T ) )
         return;
 
@@ -708,6 +750,8 @@ bool LIB_PART::PinsConflictWith( LIB_PART& aOtherPart, bool aTestNums, bool aTes
 
 bool LIB_PART::Save( OUTPUTFORMATTER& aFormatter )
 {
+    ensureDrawings();
+
     LIB_FIELD&  value = GetValueField();
 
     // First line: it s a comment (component name for readers)
@@ -984,6 +1028,8 @@ ok:
 
 bool LIB_PART::LoadDrawEntries( LINE_READER& aLineReader, wxString& aErrorMsg )
 {
+    ensureDrawings();
+
     char* line;
     LIB_ITEM* newEntry = NULL;
 
@@ -1148,6 +1194,8 @@ bool LIB_PART::LoadFootprints( LINE_READER& aLineReader, wxString& aErrorMsg )
 
 const EDA_RECT LIB_PART::GetUnitBoundingBox( int aUnit, int aConvert ) const
 {
+    ensureDrawings();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -1178,6 +1226,8 @@ const EDA_RECT LIB_PART::GetUnitBoundingBox( int aUnit, int aConvert ) const
 
 const EDA_RECT LIB_PART::GetBodyBoundingBox( int aUnit, int aConvert ) const
 {
+    ensureDrawings();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -1352,6 +1402,8 @@ bool LIB_PART::LoadDateAndTime( char* aLine )
 
 void LIB_PART::SetOffset( const wxPoint& aOffset )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
         item.SetOffset( aOffset );
 }
@@ -1359,12 +1411,16 @@ void LIB_PART::SetOffset( const wxPoint& aOffset )
 
 void LIB_PART::RemoveDuplicateDrawItems()
 {
+    ensureDrawings();
+
     m_drawings.unique();
 }
 
 
 bool LIB_PART::HasConversion() const
 {
+    ensureDrawings();
+
     for( const LIB_ITEM& item : m_drawings )
     {
         if( item.m_Convert > 1 )
@@ -1377,6 +1433,8 @@ bool LIB_PART::HasConversion() const
 
 void LIB_PART::ClearStatus()
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         item.m_Flags = 0;
@@ -1386,6 +1444,8 @@ void LIB_PART::ClearStatus()
 
 int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditPinByPin )
 {
+    ensureDrawings();
+
     int itemCount = 0;
 
     for( LIB_ITEM& item : m_drawings )
@@ -1417,6 +1477,8 @@ int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditP
 
 void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( !item.IsSelected() )
@@ -1430,6 +1492,8 @@ void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
 
 void LIB_PART::ClearSelectedItems()
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         item.m_Flags = 0;
@@ -1439,6 +1503,8 @@ void LIB_PART::ClearSelectedItems()
 
 void LIB_PART::DeleteSelectedItems()
 {
+    ensureDrawings();
+
     LIB_ITEMS_CONTAINER::ITERATOR item = m_drawings.begin();
 
     // We *do not* remove the 2 mandatory fields: reference and value
@@ -1469,6 +1535,8 @@ void LIB_PART::DeleteSelectedItems()
 
 void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
 {
+    ensureDrawings();
+
     std::vector< LIB_ITEM* > tmp;
 
     for( LIB_ITEM& item : m_drawings )
@@ -1500,6 +1568,8 @@ void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
 
 void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( !item.IsSelected() )
@@ -1513,6 +1583,8 @@ void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
 
 void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( !item.IsSelected() )
@@ -1526,6 +1598,8 @@ void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
 
 void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( !item.IsSelected() )
@@ -1540,6 +1614,8 @@ void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert,
                                     KICAD_T aType, const wxPoint& aPoint )
 {
+    ensureDrawings();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( ( aUnit && item.m_Unit && ( aUnit != item.m_Unit) )
@@ -1578,6 +1654,8 @@ LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert, KICAD_T aType,
 
 void LIB_PART::SetUnitCount( int aCount )
 {
+    ensureDrawings();
+
     if( m_unitCount == aCount )
         return;
 
@@ -1625,6 +1703,8 @@ void LIB_PART::SetUnitCount( int aCount )
 
 void LIB_PART::SetConversion( bool aSetConvert )
 {
+    ensureDrawings();
+
     if( aSetConvert == HasConversion() )
         return;
 
@@ -37,6 +37,10 @@
 #include <vector>
 #include <multivector.h>
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+
 class EDA_RECT;
 class LINE_READER;
 class OUTPUTFORMATTER;
@@ -243,6 +247,12 @@ class LIB_PART : public EDA_ITEM
     LIBRENTRYOPTIONS    m_options;          ///< Special part features such as POWER or NORMAL.)
     int                 m_unitCount;        ///< Number of units (parts) per package.
     LIB_ITEMS_CONTAINER m_drawings;         ///< Drawing items of this part.
+
+    /// Parses the drawing items left out by a lazy library load, see SetDeferredDrawings()
+    std::function<void( LIB_PART* )> m_drawingsLoader;
+    std::atomic<bool>                m_deferredDrawings;
+    std::recursive_mutex             m_drawingsLock;
+
     wxArrayString       m_FootprintList;    /**< List of suitable footprint names for the
                                                  part (wild card names accepted). */
     LIB_ALIASES         m_aliases;          ///< List of alias object pointers associated with the
@@ -258,6 +268,15 @@ class LIB_PART : public EDA_ITEM
 private:
     void deleteAllFields();
 
+    /// Makes sure the drawing items are loaded before they are used
+    void ensureDrawings() const
+    {
+        if( m_deferredDrawings )
+            const_cast<LIB_PART*>( this )->loadDeferredDrawings();
+    }
+
+    void loadDeferredDrawings();
+
     // LIB_PART()  { }     // not legal
 
 public:
@@ -692,9 +711,22 @@ public:
      */
     LIB_ITEMS_CONTAINER& GetDrawItems()
     {
+        ensureDrawings();
         return m_drawings;
     }
 
+    /**
+     * Function SetDeferredDrawings
+     * lets a library plugin skip the drawing items of the part when the library is loaded.
+     * \a aLoader is called to add them the first time they are needed, by any function
+     * using the drawing items other than the fields.  It must not throw: errors are
+     * reported by the plugin instead.
+     *
+     * @param aLoader adds the drawing items to the part, or an empty function if the drawing
+     *   items are already loaded.
+     */
+    void SetDeferredDrawings( std::function<void( LIB_PART* )> aLoader );
+
     /**
      * Set the units per part count.
      *
@@ -28,6 +28,9 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <fctsys.h>
 #include <kiface_i.h>
 #include <gr_basic.h>
@@ -460,7 +463,7 @@ void PART_LIBS::FindLibraryNearEntries( std::vector<LIB_ALIAS*>& aCandidates,
 }
 
 
-int PART_LIBS::s_modify_generation = 1;     // starts at 1 and goes up
+std::atomic<int> PART_LIBS::s_modify_generation( 1 );   // starts at 1 and goes up
 
 
 int PART_LIBS::GetModifyHash()
@@ -578,15 +581,19 @@ void PART_LIBS::LoadAllLibraries( PROJECT* aProject, bool aShowProgress )
             lib_dialog.Show();
         }
 
-        wxString progress_message;
+        // The libraries are found first, then loaded by several threads and added
+        // in the search order.
+        struct LIB_LOAD
+        {
+            wxString                  m_fileName;
+            std::unique_ptr<PART_LIB> m_lib;
+            wxString                  m_error;
+        };
+
+        std::vector<LIB_LOAD> loads;
 
         for( unsigned i = 0; i < lib_names.GetCount();  ++i )
         {
-            if( aShowProgress )
-            {
-                lib_dialog.Update( i, _( "Loading " + lib_names[i] ) );
-            }
-
             // lib_names[] does not store the file extension. Set it.
             // Remember lib_names[i] can contain a '.' in name, so using a wxFileName
             // before adding the extension can create incorrect full filename
@@ -620,18 +627,74 @@ void PART_LIBS::LoadAllLibraries( PROJECT* aProject, bool aShowProgress )
                 filename = fn.GetFullPath();
             }
 
-            try
+            // Don't reload the library if it is already loaded.
+            if( FindLibrary( fn.GetName() ) )
+                continue;
+
+            loads.emplace_back();
+            loads.back().m_fileName = filename;
+        }
+
+        // The legacy plugin reads numbers with the C library, so it needs the C locale.
+        // The locale is GLOBAL: it is only threadsafe to switch it before the threads are
+        // created, and restore it after they finish.
+        LOCALE_IO           toggle;
+        std::atomic<size_t> nextLib( 0 );
+        std::atomic<size_t> loadedCount( 0 );
+
+        auto worker = [&]()
+        {
+            for( size_t i = nextLib++; i < loads.size(); i = nextLib++ )
             {
-                AddLibrary( filename );
+                try
+                {
+                    loads[i].m_lib.reset( PART_LIB::LoadLibrary( loads[i].m_fileName ) );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    loads[i].m_error = ioe.What();
+                }
+
+                loadedCount++;
             }
-            catch( const IO_ERROR& ioe )
+        };
+
+        std::vector<std::thread> threads;
+        size_t threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                               loads.size() );
+
+        for( size_t i = 0; i < std::max<size_t>( threadCount, 1 ); ++i )
+            threads.push_back( std::thread( worker ) );
+
+        // Keep the progress dialog alive while the libraries are loading
+        while( loadedCount < loads.size() )
+        {
+            if( aShowProgress )
+                lib_dialog.Update( loadedCount );
+
+            wxMilliSleep( 20 );
+        }
+
+        for( auto& thread : threads )
+            thread.join();
+
+        for( LIB_LOAD& load : loads )
+        {
+            if( !load.m_lib )
             {
                 wxString msg;
                 msg.Printf( _( "Part library '%s' failed to load. Error:\n %s" ),
-                            GetChars( filename ), GetChars( ioe.What() ) );
+                            GetChars( load.m_fileName ), GetChars( load.m_error ) );
 
                 wxLogError( msg );
+                continue;
             }
+
+            // The same library may be listed twice
+            if( FindLibrary( load.m_lib->GetName() ) )
+                continue;
+
+            push_back( load.m_lib.release() );
         }
     }
 
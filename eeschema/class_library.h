@@ -38,6 +38,7 @@
 
 #include <project.h>
 
+#include <atomic>
 #include <map>
 
 class LIB_ID;
@@ -193,7 +194,9 @@ class PART_LIBS : public PART_LIBS_BASE, public PROJECT::_ELEM
 {
 public:
 
-    static int s_modify_generation;     ///< helper for GetModifyHash()
+    /// helper for GetModifyHash().  Atomic, as libraries are loaded by several threads at
+    /// once, and each library cache rebuilt increments it (see LoadAllLibraries()).
+    static std::atomic<int> s_modify_generation;
 
     PART_LIBS()
     {
@@ -32,6 +32,11 @@
 #define _CLASS_NETLIST_OBJECT_H_
 
 
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>
 #include <sch_item_struct.h>
@@ -287,6 +292,21 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    // Used in intermediate calculation: net codes and bus net codes merged by
+    // propagateNetCode(), as union-find forests indexed by code
+    std::vector<int> m_netCodeParent;
+    std::vector<int> m_busNetCodeParent;
+
+    // Used in intermediate calculation: indices of the items of the sheet being connected,
+    // by end point, and of its wire and bus segments, by coordinate
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_sheetItemsByPoint;
+    std::unordered_map<int, std::vector<unsigned>>      m_sheetSegmentsByY;  // horizontal
+    std::unordered_map<int, std::vector<unsigned>>      m_sheetSegmentsByX;  // vertical
+    std::vector<unsigned>                               m_sheetOtherSegments;
+
+    // Used in intermediate calculation: indices of the labels, by label text
+    std::map<wxString, std::vector<unsigned>>           m_labelsByText;
+
 public:
     /**
      * Constructor.
@@ -312,6 +332,15 @@ public:
      */
     bool BuildNetListInfo( SCH_SHEET_LIST& aSheets );
 
+    /**
+     * Function BuildConnections
+     * connects the items already in the list, gives them their net codes and finds the
+     * names of the nets.  This is the part of BuildNetListInfo() done once the items of
+     * the sheets are collected.
+     * @return the number of nets
+     */
+    int BuildConnections();
+
     /**
      * Acces to an item in list
      */
@@ -420,9 +449,31 @@ private:
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
      * when a new connection is found between aOldNetCode and aNewNetCode
+     * The items are not modified: the merge is recorded in m_netCodeParent or
+     * m_busNetCodeParent, and read back by netCode() and busNetCode()
      */
     void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
 
+    /**
+     * @return the net code of \a aItem, once the merges done by propagateNetCode()
+     * are taken into account
+     */
+    int netCode( const NETLIST_OBJECT* aItem );
+
+    /**
+     * @return the bus net code of \a aItem, once the merges done by propagateNetCode()
+     * are taken into account
+     */
+    int busNetCode( const NETLIST_OBJECT* aItem );
+
+    /**
+     * Function indexSheetItems
+     * fills the point and segment indices used by pointToPointConnect() and
+     * segmentToPointConnect() with the items from aIdxStart to aIdxEnd (excluded),
+     * which must all be in the same sheet
+     */
+    void indexSheetItems( unsigned aIdxStart, unsigned aIdxEnd );
+
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
@@ -450,16 +501,20 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search the items of the sheet of aRef having an end point in common with aRef
+     * Propagate the aRef net code (or bus net code) to these items
+     * The items of the sheet must be indexed by indexSheetItems()
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * The items of the sheet must be indexed by indexSheetItems()
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus );
 
 
     /**
@@ -38,6 +38,7 @@
 #include <class_page_info.h>
 #include <kiway_player.h>
 #include <sch_marker.h>
+#include <geometry/item_rtree.h>
 
 #include <../eeschema/general.h>
 
@@ -85,6 +86,25 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    /// Bounding boxes of the items of m_drawList.
+    mutable ITEM_RTREE<SCH_ITEM*> m_itemIndex;
+    mutable bool      m_itemIndexValid; ///< False when m_itemIndex must be built again.
+
+    /**
+     * Function queryItems
+     * fills \a aItems with the items whose bounding box intersects \a aArea, in the order
+     * of the draw list, building the item index first if needed.
+     */
+    void queryItems( const EDA_RECT& aArea, std::vector<SCH_ITEM*>& aItems ) const;
+
+    /**
+     * Function queryItems
+     * fills \a aItems with the items whose bounding box is within \a aAccuracy of
+     * \a aPosition, in the order of the draw list.
+     */
+    void queryItems( const wxPoint& aPosition, int aAccuracy,
+                     std::vector<SCH_ITEM*>& aItems ) const;
+
     /**
      * Function addConnectedItemsToBlock
      * add items connected at \a aPosition to the block pick list.
@@ -142,6 +162,7 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+        InvalidateItemIndex();
     }
 
     /**
@@ -154,8 +175,18 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        InvalidateItemIndex();
     }
 
+    /**
+     * Function InvalidateItemIndex
+     * must be called as soon as items of the screen are moved, rotated, mirrored or change
+     * size in place, so the spatial index used by the item lookups is built again before
+     * the next lookup.  Append(), Remove(), DeleteItem() and the other SCH_SCREEN methods
+     * changing the draw list keep the index up to date themselves.
+     */
+    void InvalidateItemIndex() { m_itemIndexValid = false; }
+
     /**
      * Function GetCurItem
      * returns the currently selected SCH_ITEM, overriding BASE_SCREEN::GetCurItem().
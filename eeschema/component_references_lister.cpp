@@ -31,6 +31,8 @@
 
 #include <wx/regex.h>
 #include <algorithm>
+#include <map>
+#include <set>
 #include <vector>
 
 #include <fctsys.h>
@@ -193,26 +195,18 @@ void SCH_REFERENCE_LIST::RemoveSubComponentsFromList()
 }
 
 
-void SCH_REFERENCE_LIST::GetRefsInUse( int aIndex, std::vector< int >& aIdList, int aMinRefId )
+void SCH_REFERENCE_LIST::GetRefsInUse( std::map< std::string, std::set< int > >& aIdSets ) const
 {
-    aIdList.clear();
+    aIdSets.clear();
 
+    // Components with multiple parts per package store the same number for each part,
+    // the set only keeps it once.
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
-        if(  ( componentFlatList[aIndex].CompareRef( componentFlatList[ii] ) == 0 )
-          && ( componentFlatList[ii].m_NumRef >= aMinRefId )  )
-            aIdList.push_back( componentFlatList[ii].m_NumRef );
-    }
-
-    sort( aIdList.begin(), aIdList.end() );
+        const SCH_REFERENCE& ref = componentFlatList[ii];
 
-    // Ensure each reference number appears only once.  If there are components with
-    // multiple parts per package the same number will be stored for each part.
-    std::vector< int >::iterator it = unique( aIdList.begin(), aIdList.end() );
-
-    // Using the C++ unique algorithm only moves the duplicate entries to the end of
-    // of the array.  This removes the duplicate entries from the array.
-    aIdList.resize( it - aIdList.begin() );
+        aIdSets[ ref.GetRefStr() ].insert( ref.m_NumRef );
+    }
 }
 
 
@@ -235,37 +229,21 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::set<int>& aIdSet, int aFirstValue )
 {
     int expectedId = aFirstValue;
 
     // We search for expected Id a value >= aFirstValue.
     // Skip existing Id < aFirstValue
-    unsigned ii = 0;
-
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId <= aIdList[ii] )
-            break;
-    }
+    std::set<int>::iterator it = aIdSet.lower_bound( aFirstValue );
 
     // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
-
+    // So we search from aFirstValue the first not used value, i.e. the first hole in set.
+    for( ; it != aIdSet.end() && *it == expectedId; ++it )
         expectedId++;
-    }
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
+    // Insert this free Id, before the next Id in use
+    aIdSet.insert( it, expectedId );
     return expectedId;
 }
 
@@ -302,10 +280,16 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
     if( aUseSheetNum )
         minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId + 1;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // These are the sets of all Id already in use, for each reference prefix.
+    // The new Ids are added to them.
+    std::map< std::string, std::set< int > > idSets;
+    GetRefsInUse( idSets );
+
+    std::set<int>* idSet = &idSets[ componentFlatList[first].GetRefStr() ];
+
+    // All the Ids from minRefId to firstFreeId - 1 are in use: the next free Id is
+    // searched from firstFreeId, not from minRefId.
+    int firstFreeId = minRefId;
 #endif
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
@@ -350,7 +334,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             if( aUseSheetNum )
                 minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            idSet = &idSets[ componentFlatList[first].GetRefStr() ];
+            firstFreeId = minRefId;
 #endif
         }
 
@@ -362,7 +347,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 #ifdef USE_OLD_ALGO
                 LastReferenceNumber++;
 #else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = CreateFirstFreeRefId( *idSet, firstFreeId );
+                firstFreeId = LastReferenceNumber + 1;
 #endif
                 componentFlatList[ii].m_NumRef = LastReferenceNumber;
             }
@@ -381,7 +367,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 #ifdef USE_OLD_ALGO
             LastReferenceNumber++;
 #else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = CreateFirstFreeRefId( *idSet, firstFreeId );
+            firstFreeId = LastReferenceNumber + 1;
 #endif
             componentFlatList[ii].m_NumRef = LastReferenceNumber;
 
@@ -63,6 +63,7 @@ static void abortMoveBitmap( EDA_DRAW_PANEL* aPanel, wxDC* aDC )
         // Never delete existing item, because it can be referenced by an undo/redo command
         // Just restore its data
         item->SwapData( olditem );
+        screen->InvalidateItemIndex();
         parent->SetUndoItem( NULL );
     }
 
@@ -94,6 +95,7 @@ static void moveBitmap( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aPosit
 
     // Draw the bitmap at it's new position.
     image->SetPosition( aPanel->GetParent()->GetCrossHairPosition() );
+    screen->InvalidateItemIndex();
     image->Draw( aPanel, aDC, wxPoint( 0, 0 ), GR_DEFAULT_DRAWMODE );
 }
 
@@ -40,9 +40,13 @@
 #include <sch_marker.h>
 #include <sch_component.h>
 #include <sch_sheet.h>
+#include <hashtables.h>
 
 #include <wx/ffile.h>
 
+#include <map>
+#include <unordered_map>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -612,39 +616,78 @@ void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned
 // when they are compared using case insensitive coparisons.
 
 
-// A helper struct to compare NETLIST_OBJECT items by sheetpath and label texts
-// for a std::set<NETLIST_OBJECT*> container
-// the full text is "sheetpath+label" for local labels and "label" for global labels
-struct compare_labels
+// Helper functions to build the warning messages about Similar Labels:
+static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
+
+
+// A helper struct to count the labels identical to a given label:
+//  for global label: global labels in the full project
+//  for local label: all labels in the current sheet
+struct IDENTICAL_LABEL_COUNTS
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
+    std::map<wxString, int>                         m_global;   // by label
+    std::map<std::pair<wxString, wxString>, int>    m_local;    // by sheetpath and label
+
+    int Count( const NETLIST_OBJECT* aLabel, const wxString& aPath ) const
     {
-        wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
-        wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
+        if( aLabel->IsLabelGlobal() )
+            return m_global.at( aLabel->m_Label );
 
-        return str1.Cmp( str2 ) < 0;
+        return m_local.at( std::make_pair( aPath, aLabel->m_Label ) );
     }
 };
 
-struct compare_label_names
+
+// Helper function: creates a marker for each pair of labels of aLabels having the same
+// text when using case insensitive comparisons.  aLabels is sorted by label text, and
+// each text appears only once.  Pairs of global labels are skipped if aSkipGlobals is true.
+static void diagnoseSimilarLabels( const std::vector<NETLIST_OBJECT*>& aLabels,
+                                   bool aSkipGlobals,
+                                   const IDENTICAL_LABEL_COUNTS& aCounts,
+                                   const std::map<NETLIST_OBJECT*, wxString>& aPaths )
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
+    // Labels having the same case folded text, in the order of aLabels
+    std::unordered_map<wxString, std::vector<unsigned>, WXSTRING_HASH> groups;
+    std::vector<std::vector<unsigned>*> groupOf( aLabels.size() );
+    std::vector<unsigned> rankInGroup( aLabels.size() );
+
+    for( unsigned ii = 0; ii < aLabels.size(); ++ii )
     {
-        return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
+        std::vector<unsigned>& group = groups[ aLabels[ii]->m_Label.Lower() ];
+
+        groupOf[ii] = &group;
+        rankInGroup[ii] = group.size();
+        group.push_back( ii );
     }
-};
 
-struct compare_paths
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
+    for( unsigned ii = 0; ii < aLabels.size(); ++ii )
     {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
-    }
-};
+        NETLIST_OBJECT*              ref_item = aLabels[ii];
+        const std::vector<unsigned>& group = *groupOf[ii];
 
-// Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel );
-static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
+        for( unsigned jj = rankInGroup[ii] + 1; jj < group.size(); ++jj )
+        {
+            NETLIST_OBJECT* item = aLabels[ group[jj] ];
+
+            // global label versus global label was already examined.
+            // here, at least one label must be local
+            if( aSkipGlobals && ref_item->IsLabelGlobal() && item->IsLabelGlobal() )
+                continue;
+
+            if( ref_item->m_Label.CmpNoCase( item->m_Label ) != 0 )
+                continue;
+
+            // Create new marker for ERC.
+            int cntA = aCounts.Count( ref_item, aPaths.at( ref_item ) );
+            int cntB = aCounts.Count( item, aPaths.at( item ) );
+
+            if( cntA <= cntB )
+                SimilarLabelsDiagnose( ref_item, item );
+            else
+                SimilarLabelsDiagnose( item, ref_item );
+        }
+    }
+}
 
 
 void NETLIST_OBJECT_LIST::TestforSimilarLabels()
@@ -652,11 +695,13 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     // Similar labels which are different when using case sensitive comparisons
     // but are equal when using case insensitive comparisons
 
-    // list of all labels (used the better item to build diag messages)
-    std::vector<NETLIST_OBJECT*> fullLabelList;
-    // list of all labels , each label appears only once (used to to detect similar labels)
-    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
+    // count of identical labels (used the better item to build diag messages)
+    IDENTICAL_LABEL_COUNTS counts;
+    // sheet path of each label
+    std::map<NETLIST_OBJECT*, wxString> paths;
+    // list of all labels, each label appears only once (used to to detect similar labels)
+    // the key is "sheetpath+label"
+    std::map<wxString, NETLIST_OBJECT*> uniqueLabelList;
 
     // Build a list of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
@@ -666,7 +711,9 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     //    already detected by ERC
     for( unsigned netItem = 0; netItem < size(); ++netItem )
     {
-        switch( GetItemType( netItem ) )
+        NETLIST_OBJECT* item = GetItem( netItem );
+
+        switch( item->m_Type )
         {
         case NET_LABEL:
         case NET_BUSLABELMEMBER:
@@ -675,10 +722,18 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         case NET_HIERLABEL:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBLABEL:
+        {
             // add this label in lists
-            uniqueLabelList.insert( GetItem( netItem ) );
-            fullLabelList.push_back( GetItem( netItem ) );
+            const wxString& path = paths[item] = item->m_SheetPath.Path();
+
+            uniqueLabelList.insert( std::make_pair( path + item->m_Label, item ) );
+
+            if( item->IsLabelGlobal() )
+                counts.m_global[item->m_Label]++;
+
+            counts.m_local[ std::make_pair( path, item->m_Label ) ]++;
             break;
+        }
 
         case NET_SHEETLABEL:
         case NET_SHEETBUSLABELMEMBER:
@@ -688,117 +743,38 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     }
 
     // build global labels and compare
-    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
-    std::set<NETLIST_OBJECT*>::const_iterator it;
+    std::map<wxString, NETLIST_OBJECT*> loc_labelList;
+    std::vector<NETLIST_OBJECT*> labels;
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
+    for( const auto& entry : uniqueLabelList )
     {
-        if( (*it)->IsLabelGlobal() )
-            loc_labelList.insert( *it );
+        if( entry.second->IsLabelGlobal() )
+            loc_labelList.insert( std::make_pair( entry.second->m_Label, entry.second ) );
     }
 
     // compare global labels (same label names appears only once in list)
-    for( it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
-    {
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = it;
+    for( const auto& entry : loc_labelList )
+        labels.push_back( entry.second );
 
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-        {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
-        }
-    }
+    diagnoseSimilarLabels( labels, false, counts, paths );
 
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
+    // Build the labels list of each sheet path (same label names appears only once in list)
+    std::map<wxString, std::map<wxString, NETLIST_OBJECT*>> pathsList;
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
+    for( const auto& entry : uniqueLabelList )
+        pathsList[ paths[entry.second] ].insert( std::make_pair( entry.second->m_Label,
+                                                                 entry.second ) );
 
     // Examine each label inside a sheet path:
-    for( it = pathsList.begin(); it != pathsList.end(); ++it )
-    {
-        loc_labelList.clear();
-
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = uniqueLabelList.begin();
-
-        for( ; it_aux != uniqueLabelList.end(); ++it_aux )
-        {
-            if( (*it)->m_SheetPath.Path() == (*it_aux)->m_SheetPath.Path() )
-                loc_labelList.insert( *it_aux );
-        }
-
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-        std::set<NETLIST_OBJECT*>::const_iterator ref_it;
-
-        for( ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            it_aux = ref_it;
-
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
-                // global label versus global label was already examined.
-                // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
-                    continue;
-
-                if( ref_item->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-                {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, (*it_aux) );
-                    else
-                        SimilarLabelsDiagnose( (*it_aux), ref_item );
-                }
-            }
-        }
-    }
-}
-
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel )
-{
-    int count = 0;
-
-    if( aLabel->IsLabelGlobal() )
+    for( const auto& path : pathsList )
     {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
+        labels.clear();
 
-            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
-                count++;
-        }
-    }
-    else
-    {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
+        for( const auto& entry : path.second )
+            labels.push_back( entry.second );
 
-            if( item->m_Label == aLabel->m_Label &&
-                item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
-                count++;
-        }
+        diagnoseSimilarLabels( labels, true, counts, paths );
     }
-
-    return count;
 }
 
 // Helper function: creates a marker for similar labels ERC warning
@@ -305,6 +305,7 @@ void SCH_EDIT_FRAME::OrientComponent( COMPONENT_ORIENTATION_T aOrientation )
     INSTALL_UNBUFFERED_DC( dc, m_canvas );
 
     component->SetOrientation( aOrientation );
+    screen->InvalidateItemIndex();
 
     m_canvas->CrossHairOn( &dc );
 
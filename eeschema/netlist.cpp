@@ -45,10 +45,18 @@
 #include <sch_sheet.h>
 #include <algorithm>
 #include <invoke_sch_dialog.h>
+#include <profile.h>
 
 #define IS_WIRE false
 #define IS_BUS true
 
+/**
+ * @ingroup trace_env_vars
+ *
+ * Flag to enable netlist build timing debug output.
+ */
+static const wxString traceNetlistBuild = wxT( "KICAD_TRACE_NETLIST_BUILD" );
+
 //Imported function:
 int TestDuplicateSheetNames( bool aCreateMarker );
 
@@ -198,6 +206,7 @@ NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase( bool updateStatusText )
 
 bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
 {
+    PROF_COUNTER    buildTime;
     SCH_SHEET_PATH* sheet;
 
     // Fill list with connected items from the flattened sheet list
@@ -214,20 +223,42 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     if( size() == 0 )
         return false;
 
+    int netCount = BuildConnections();
+
+    buildTime.Stop();
+    wxLogTrace( traceNetlistBuild, wxT( "Built %d nets from %u items of %u sheets in %.1f ms" ),
+                netCount, (unsigned) size(), (unsigned) aSheets.size(), buildTime.msecs() );
+
+    return true;
+}
+
+
+int NETLIST_OBJECT_LIST::BuildConnections()
+{
+    SCH_SHEET_PATH* sheet;
+
     // Sort objects by Sheet
     SortListbySheet();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
+    m_netCodeParent.clear();
+    m_busNetCodeParent.clear();
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned ii = 0, iend = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+        if( ii == iend )   // Sheet change
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            sheet = &(net_item->m_SheetPath);
+
+            for( iend = ii + 1; iend < size(); iend++ )
+            {
+                if( GetItem( iend )->m_SheetPath != *sheet )
+                    break;
+            }
+
+            indexSheetItems( ii, iend );
         }
 
         switch( net_item->m_Type )
@@ -240,83 +271,92 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_PINLABEL:
         case NET_SHEETLABEL:
         case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
+            if( netCode( net_item ) != 0 )
                 break;
 
         case NET_SEGMENT:
             // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
+            if( netCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_JUNCTION:
             // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
+            if( netCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
 
             // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
+            if( busNetCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_LABEL:
         case NET_HIERLABEL:
         case NET_GLOBLABEL:
             // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
+            if( netCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
+            if( busNetCode( net_item ) != 0 )
                 break;
 
         case NET_BUS:
             // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
+            if( busNetCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
             // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
+            if( netCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
         }
     }
 
+    m_sheetItemsByPoint.clear();
+    m_sheetSegmentsByY.clear();
+    m_sheetSegmentsByX.clear();
+    m_sheetOtherSegments.clear();
+
+    // Bus net codes are only merged by physical connections: they are final now.
+    for( unsigned ii = 0; ii < size(); ii++ )
+        GetItem( ii )->m_BusNetCode = busNetCode( GetItem( ii ) );
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -325,6 +365,14 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
+    m_labelsByText.clear();
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        if( GetItem( ii )->IsLabelType() )
+            m_labelsByText[ GetItem( ii )->m_Label ].push_back( ii );
+    }
+
     // Group objects by label.
     for( unsigned ii = 0; ii < size(); ii++ )
     {
@@ -369,6 +417,15 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    m_labelsByText.clear();
+
+    // Store the merged net codes in the items, before sorting them.
+    for( unsigned ii = 0; ii < size(); ii++ )
+        GetItem( ii )->SetNet( netCode( GetItem( ii ) ) );
+
+    m_netCodeParent.clear();
+    m_busNetCodeParent.clear();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -398,7 +455,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // find the best label object to give the best net name to each net
     findBestNetNameForEachNet();
 
-    return true;
+    return NetCode;
 }
 
 // Helper function to give a priority to sort labels:
@@ -618,10 +675,17 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 
 void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
 {
-    if( SheetLabel->GetNet() == 0 )
+    int sheetLabelNetCode = netCode( SheetLabel );
+
+    if( sheetLabelNetCode == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    auto labels = m_labelsByText.find( SheetLabel->m_Label );
+
+    if( labels == m_labelsByText.end() )
+        return;  // no label having this name.
+
+    for( unsigned ii : labels->second )
     {
         NETLIST_OBJECT* ObjetNet = GetItem( ii );
 
@@ -631,17 +695,16 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
-            continue;  //already connected.
+        int objetNetCode = netCode( ObjetNet );
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
+        if( objetNetCode == sheetLabelNetCode )
+            continue;  //already connected.
 
         // Propagate Netcode having all the objects of the same Netcode.
-        if( ObjetNet->GetNet() )
-            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+        if( objetNetCode )
+            propagateNetCode( objetNetCode, sheetLabelNetCode, IS_WIRE );
         else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+            ObjetNet->SetNet( sheetLabelNetCode );
     }
 }
 
@@ -650,206 +713,286 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 {
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
-    // Search is done in the entire list
+    // Search is done in the entire list, the members having the same bus net code and
+    // member value being grouped first
+    std::map<std::pair<int, int>, std::vector<unsigned>> members;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
 
         if( Label->IsLabelBusMemberType() )
+            members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ].push_back( ii );
+    }
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* Label = GetItem( ii );
+
+        if( !Label->IsLabelBusMemberType() )
+            continue;
+
+        if( netCode( Label ) == 0 )
         {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+            // Not yet existiing net code: create a new one.
+            Label->SetNet( m_lastNetCode );
+            m_lastNetCode++;
+        }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+        const std::vector<unsigned>& group =
+                members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ];
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
+        // Once the first member of a group is connected to the others, they all have
+        // its net code
+        if( group.front() != ii )
+            continue;
+
+        for( unsigned jj : group )
+        {
+            if( jj == ii )
+                continue;
+
+            NETLIST_OBJECT* LabelInTst = GetItem( jj );
+
+            if( netCode( LabelInTst ) == 0 )
+                // Append this object to the current net
+                LabelInTst->SetNet( netCode( Label ) );
+            else
+                // Merge the 2 net codes, they are connected.
+                propagateNetCode( netCode( LabelInTst ), netCode( Label ), IS_WIRE );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+/**
+ * Function findRootCode
+ * @return the code \a aCode has been merged into, in the union-find forest \a aParents.
+ * Codes not yet in the forest are added to it, as unmerged codes.
+ */
+static int findRootCode( std::vector<int>& aParents, int aCode )
 {
-    if( aOldNetCode == aNewNetCode )
-        return;
-
-    if( aIsBus == false )    // Propagate NetCode
+    if( aCode >= (int) aParents.size() )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        int first = aParents.size();
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+        aParents.resize( aCode + 1 );
+
+        for( int code = first; code <= aCode; code++ )
+            aParents[code] = code;
+
+        return aCode;
     }
-    else               // Propagate BusNetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+    while( aParents[aCode] != aCode )
+    {
+        // Path halving: keeps the trees flat when some codes are merged many times
+        aParents[aCode] = aParents[ aParents[aCode] ];
+        aCode = aParents[aCode];
     }
+
+    return aCode;
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+int NETLIST_OBJECT_LIST::netCode( const NETLIST_OBJECT* aItem )
 {
-    int netCode;
+    return findRootCode( m_netCodeParent, aItem->GetNet() );
+}
+
+
+int NETLIST_OBJECT_LIST::busNetCode( const NETLIST_OBJECT* aItem )
+{
+    return findRootCode( m_busNetCodeParent, aItem->m_BusNetCode );
+}
+
+
+void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+{
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParent : m_netCodeParent;
+
+    int oldRoot = findRootCode( parents, aOldNetCode );
+    int newRoot = findRootCode( parents, aNewNetCode );
+
+    // The merged net keeps the new code, like if all the items were renamed
+    if( oldRoot != newRoot )
+        parents[oldRoot] = newRoot;
+}
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+
+/// @return a key of \a aPoint for the point index of the sheet items
+static uint64_t pointKey( const wxPoint& aPoint )
+{
+    return ( (uint64_t) (uint32_t) aPoint.x << 32 ) | (uint32_t) aPoint.y;
+}
+
+
+void NETLIST_OBJECT_LIST::indexSheetItems( unsigned aIdxStart, unsigned aIdxEnd )
+{
+    m_sheetItemsByPoint.clear();
+    m_sheetSegmentsByY.clear();
+    m_sheetSegmentsByX.clear();
+    m_sheetOtherSegments.clear();
+
+    for( unsigned i = aIdxStart; i < aIdxEnd; i++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* item = GetItem( i );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        m_sheetItemsByPoint[ pointKey( item->m_Start ) ].push_back( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
+        if( item->m_End != item->m_Start )
+            m_sheetItemsByPoint[ pointKey( item->m_End ) ].push_back( i );
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
+        if( item->m_Type != NET_SEGMENT && item->m_Type != NET_BUS )
+            continue;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
-        }
+        // A point can only be on a horizontal (or vertical) segment if it has
+        // the same y (or x) coordinate
+        if( item->m_Start.y == item->m_End.y )
+            m_sheetSegmentsByY[ item->m_Start.y ].push_back( i );
+        else if( item->m_Start.x == item->m_End.x )
+            m_sheetSegmentsByX[ item->m_Start.x ].push_back( i );
+        else
+            m_sheetOtherSegments.push_back( i );
     }
-    else    // Object type BUS, BUSLABELS, and junctions.
+}
+
+
+/**
+ * Function isConnectedByEndPoints
+ * @return true if \a aItem is connected to the wires (or to the buses if \a aIsBus is true)
+ * having an end point in common with it
+ */
+static bool isConnectedByEndPoints( const NETLIST_OBJECT* aItem, bool aIsBus )
+{
+    switch( aItem->m_Type )
+    {
+    case NET_SEGMENT:
+    case NET_PIN:
+    case NET_LABEL:
+    case NET_HIERLABEL:
+    case NET_GLOBLABEL:
+    case NET_SHEETLABEL:
+    case NET_PINLABEL:
+    case NET_NOCONNECT:
+        return aIsBus == IS_WIRE;
+
+    case NET_BUS:
+    case NET_BUSLABELMEMBER:
+    case NET_SHEETBUSLABELMEMBER:
+    case NET_HIERBUSLABELMEMBER:
+    case NET_GLOBBUSLABELMEMBER:
+        return aIsBus == IS_BUS;
+
+    case NET_JUNCTION:
+        return true;
+
+    case NET_ITEM_UNSPECIFIED:
+        break;
+    }
+
+    return false;
+}
+
+
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus )
+{
+    // Objects other than BUS and BUSLABELS use the net code,
+    // BUS, BUSLABELS, and junctions use the bus net code
+    int refNetCode = aIsBus ? busNetCode( aRef ) : netCode( aRef );
+
+    for( int ii = 0; ii < 2; ii++ )
     {
-        netCode = aRef->m_BusNetCode;
+        const wxPoint& point = ii ? aRef->m_End : aRef->m_Start;
 
-        for( unsigned i = start; i < size(); i++ )
+        if( ii && point == aRef->m_Start )
+            break;
+
+        auto candidates = m_sheetItemsByPoint.find( pointKey( point ) );
+
+        if( candidates == m_sheetItemsByPoint.end() )
+            continue;
+
+        for( unsigned i : candidates->second )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
+            if( !isConnectedByEndPoints( item, aIsBus ) )
                 continue;
 
-            switch( item->m_Type )
+            if( aIsBus == IS_WIRE )
             {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
-
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
-                break;
+                if( netCode( item ) == 0 )
+                    item->SetNet( refNetCode );
+                else
+                    propagateNetCode( netCode( item ), refNetCode, IS_WIRE );
+            }
+            else
+            {
+                if( busNetCode( item ) == 0 )
+                    item->m_BusNetCode = refNetCode;
+                else
+                    propagateNetCode( busNetCode( item ), refNetCode, IS_BUS );
             }
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
-    {
-        NETLIST_OBJECT* segment = GetItem( i );
+    const wxPoint& point = aJonction->m_Start;
+
+    // Only the segments of the sheet of the junction are indexed: there is obviously
+    // no physical connection between elements of different sheets.
+    const std::vector<unsigned>* lists[3] = { nullptr, nullptr, &m_sheetOtherSegments };
+
+    auto horizontal = m_sheetSegmentsByY.find( point.y );
+    auto vertical = m_sheetSegmentsByX.find( point.x );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
+    if( horizontal != m_sheetSegmentsByY.end() )
+        lists[0] = &horizontal->second;
+
+    if( vertical != m_sheetSegmentsByX.end() )
+        lists[1] = &vertical->second;
+
+    for( const std::vector<unsigned>* list : lists )
+    {
+        if( !list )
             continue;
 
-        if( aIsBus == IS_WIRE )
+        for( unsigned i : *list )
         {
-            if( segment->m_Type != NET_SEGMENT )
-                continue;
-        }
-        else
-        {
-            if( segment->m_Type != NET_BUS )
+            NETLIST_OBJECT* segment = GetItem( i );
+
+            if( aIsBus == IS_WIRE )
+            {
+                if( segment->m_Type != NET_SEGMENT )
+                    continue;
+            }
+            else
+            {
+                if( segment->m_Type != NET_BUS )
+                    continue;
+            }
+
+            if( !IsPointOnSegment( segment->m_Start, segment->m_End, point ) )
                 continue;
-        }
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
-        {
             // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
             {
-                if( segment->GetNet() )
-                    propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
+                if( netCode( segment ) )
+                    propagateNetCode( netCode( segment ), netCode( aJonction ), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    segment->SetNet( netCode( aJonction ) );
             }
             else
             {
-                if( segment->m_BusNetCode )
-                    propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
+                if( busNetCode( segment ) )
+                    propagateNetCode( busNetCode( segment ), busNetCode( aJonction ), aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    segment->m_BusNetCode = busNetCode( aJonction );
             }
         }
     }
@@ -858,14 +1001,26 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
 
 void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
 {
-    if( aLabelRef->GetNet() == 0 )
+    int refNetCode = netCode( aLabelRef );
+
+    if( refNetCode == 0 )
+        return;
+
+    // NET_HIERLABEL are used to connect sheets.
+    // NET_LABEL are local to a sheet
+    // NET_GLOBLABEL are global.
+    // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
+    auto labels = m_labelsByText.find( aLabelRef->m_Label );
+
+    if( labels == m_labelsByText.end() )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    for( unsigned i : labels->second )
     {
         NETLIST_OBJECT* item = GetItem( i );
+        int itemNetCode = netCode( item );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( itemNetCode == refNetCode )
             continue;
 
         if( item->m_SheetPath != aLabelRef->m_SheetPath )
@@ -881,20 +1036,10 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
                 continue;
         }
 
-        // NET_HIERLABEL are used to connect sheets.
-        // NET_LABEL are local to a sheet
-        // NET_GLOBLABEL are global.
-        // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        if( itemNetCode )
+            propagateNetCode( itemNetCode, refNetCode, IS_WIRE );
+        else
+            item->SetNet( refNetCode );
     }
 }
 
@@ -236,6 +236,7 @@ void DuplicateItemsInList( SCH_SCREEN* screen, PICKED_ITEMS_LIST& aItemsList,
     }
 
     MoveItemsInList( aItemsList, aMoveVector );
+    screen->InvalidateItemIndex();
 }
 
 
@@ -0,0 +1,310 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <sch_reference_list.h>
+#include <class_libentry.h>
+#include <sch_component.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <profile.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/**
+ * A component to annotate: its reference prefix, its reference number (-1 if it is not
+ * annotated yet) and its sheet number.
+ */
+struct ANNOTATION_ITEM
+{
+    std::string m_prefix;
+    int         m_number;
+    int         m_sheetNumber;
+};
+
+
+/**
+ * The numbers SCH_REFERENCE_LIST::Annotate() gave to the components with one unit per
+ * package, before the numbers in use were kept in sets: the numbers in use are collected
+ * again from the whole list for each new prefix, and the first free number is searched
+ * from the first allowed value for each new component.
+ */
+static void referenceAnnotate( std::vector<ANNOTATION_ITEM>& aItems, bool aUseSheetNum,
+                               int aSheetIntervalId )
+{
+    auto minRefId = [&]( const ANNOTATION_ITEM& aItem )
+    {
+        return aUseSheetNum ? aItem.m_sheetNumber * aSheetIntervalId + 1 : 1;
+    };
+
+    auto refsInUse = [&]( const ANNOTATION_ITEM& aFirst, int aMinRefId )
+    {
+        std::vector<int> ids;
+
+        for( const ANNOTATION_ITEM& item : aItems )
+        {
+            if( item.m_prefix == aFirst.m_prefix && item.m_number >= aMinRefId )
+                ids.push_back( item.m_number );
+        }
+
+        std::sort( ids.begin(), ids.end() );
+        ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
+
+        return ids;
+    };
+
+    unsigned first = 0;
+    int minId = minRefId( aItems[first] );
+    std::vector<int> ids = refsInUse( aItems[first], minId );
+
+    for( unsigned ii = 0; ii < aItems.size(); ii++ )
+    {
+        if( aItems[first].m_prefix != aItems[ii].m_prefix
+            || ( aUseSheetNum && aItems[first].m_sheetNumber != aItems[ii].m_sheetNumber ) )
+        {
+            first = ii;
+            minId = minRefId( aItems[first] );
+            ids = refsInUse( aItems[first], minId );
+        }
+
+        if( aItems[ii].m_number >= 0 )
+            continue;
+
+        // The first hole in the sorted ids, from minId
+        int expectedId = minId;
+        unsigned jj = 0;
+
+        while( jj < ids.size() && ids[jj] < expectedId )
+            jj++;
+
+        while( jj < ids.size() && ids[jj] == expectedId )
+        {
+            jj++;
+            expectedId++;
+        }
+
+        ids.insert( ids.begin() + jj, expectedId );
+        aItems[ii].m_number = expectedId;
+    }
+}
+
+
+/**
+ * A one unit part, and sheets holding the components to annotate.
+ */
+struct AnnotationFixture
+{
+    LIB_PART                                    m_part;
+    std::vector<std::unique_ptr<SCH_SHEET>>     m_sheets;
+    std::vector<SCH_SHEET_PATH>                 m_paths;
+    std::vector<std::unique_ptr<SCH_COMPONENT>> m_components;
+    std::map<SCH_COMPONENT*, ANNOTATION_ITEM>   m_items;
+    std::mt19937                                m_random;
+
+    AnnotationFixture() :
+        m_part( wxT( "R" ) )
+    {
+        for( int i = 0; i < 8; i++ )
+        {
+            m_sheets.emplace_back( new SCH_SHEET );
+            m_sheets.back()->SetTimeStamp( 0x1000 + i );
+
+            SCH_SHEET_PATH path;
+            path.push_back( m_sheets[0].get() );
+
+            if( i > 0 )
+                path.push_back( m_sheets.back().get() );
+
+            m_paths.push_back( path );
+        }
+    }
+
+    int random( int aMax )
+    {
+        return std::uniform_int_distribution<int>( 0, aMax )( m_random );
+    }
+
+    /**
+     * Adds a component to \a aList.
+     * @param aNumber = the number of its reference, or -1 if it is not annotated
+     */
+    void add( SCH_REFERENCE_LIST& aList, const std::string& aPrefix, int aNumber, int aSheet,
+              const wxPoint& aPos )
+    {
+        SCH_SHEET_PATH& path = m_paths[aSheet];
+        SCH_COMPONENT* component = new SCH_COMPONENT( m_part, &path, 1, 0, aPos );
+        std::string ref = aPrefix + ( aNumber < 0 ? "?" : std::to_string( aNumber ) );
+
+        m_components.emplace_back( component );
+        component->SetRef( &path, wxString( ref.c_str() ) );
+
+        SCH_REFERENCE reference( component, &m_part, path );
+        reference.SetSheetNumber( aSheet + 1 );
+        aList.AddItem( reference );
+
+        m_items[component] = { aPrefix, aNumber, aSheet + 1 };
+    }
+
+    /**
+     * Adds \a aCount random components to \a aList, spread over \a aSheetCount sheets.
+     * Half of them are already annotated, with numbers up to \a aMaxNumber, none if it
+     * is 0.
+     */
+    void generate( SCH_REFERENCE_LIST& aList, int aCount, int aSheetCount, int aMaxNumber )
+    {
+        static const char* prefixes[] = { "R", "C", "U", "IC" };
+
+        for( int i = 0; i < aCount; i++ )
+        {
+            int number = aMaxNumber && random( 1 ) ? 1 + random( aMaxNumber - 1 ) : -1;
+
+            add( aList, prefixes[ random( 3 ) ], number, random( aSheetCount - 1 ),
+                 wxPoint( random( 100000 ), random( 100000 ) ) );
+        }
+    }
+
+    /**
+     * Annotates \a aList, annotates a copy of its components with the reference algorithm,
+     * and checks they give the same references.
+     * @param aReportTimes = true to print the time taken by both algorithms
+     */
+    void checkAgainstReference( SCH_REFERENCE_LIST& aList, bool aUseSheetNum,
+                                int aSheetIntervalId, bool aReportTimes = false )
+    {
+        // Like SCH_EDIT_FRAME::AnnotateComponents()
+        aList.SplitReferences();
+        aList.SortByXCoordinate();
+
+        std::vector<ANNOTATION_ITEM> expected;
+
+        for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
+            expected.push_back( m_items[ aList[ii].GetComp() ] );
+
+        // PROF_COUNTER::msecs() keeps counting after Stop(), read the times right away
+        PROF_COUNTER counter;
+        aList.Annotate( aUseSheetNum, aSheetIntervalId, SCH_MULTI_UNIT_REFERENCE_MAP() );
+        counter.Stop();
+        double annotateTime = counter.msecs();
+
+        counter.Start();
+        referenceAnnotate( expected, aUseSheetNum, aSheetIntervalId );
+        counter.Stop();
+        double referenceTime = counter.msecs();
+
+        if( aReportTimes )
+        {
+            BOOST_TEST_MESSAGE( aList.GetCount() << " components: " << annotateTime << " ms, "
+                                << referenceTime << " ms with the reference algorithm" );
+        }
+
+        aList.UpdateAnnotation();
+
+        for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
+        {
+            std::string ref = expected[ii].m_prefix + std::to_string( expected[ii].m_number );
+
+            BOOST_REQUIRE_EQUAL( aList[ii].GetRef(), wxString( ref.c_str() ) );
+        }
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Annotation, AnnotationFixture )
+
+/**
+ * Checks the annotation of a few hand made components.
+ */
+BOOST_AUTO_TEST_CASE( Basic )
+{
+    SCH_REFERENCE_LIST list;
+
+    add( list, "R", 1, 0, wxPoint( 0, 0 ) );
+    add( list, "R", 3, 0, wxPoint( 100, 0 ) );
+    add( list, "R", -1, 0, wxPoint( 200, 0 ) );
+    add( list, "R", -1, 0, wxPoint( 300, 0 ) );
+    add( list, "R", -1, 0, wxPoint( 400, 0 ) );
+    add( list, "C", -1, 0, wxPoint( 500, 0 ) );
+
+    list.SplitReferences();
+    list.SortByXCoordinate();
+    list.Annotate( false, 0, SCH_MULTI_UNIT_REFERENCE_MAP() );
+    list.UpdateAnnotation();
+
+    std::vector<wxString> refs;
+
+    for( unsigned ii = 0; ii < list.GetCount(); ii++ )
+        refs.push_back( list[ii].GetRef() );
+
+    // The holes are filled first
+    std::vector<wxString> expected = { wxT( "C1" ), wxT( "R1" ), wxT( "R3" ), wxT( "R2" ),
+                                       wxT( "R4" ), wxT( "R5" ) };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( refs.begin(), refs.end(), expected.begin(), expected.end() );
+}
+
+/**
+ * Checks the annotation of random component sets against the reference algorithm, with
+ * and without sheet numbers.
+ */
+BOOST_AUTO_TEST_CASE( RandomComponents )
+{
+    for( int seed = 0; seed < 500; seed++ )
+    {
+        SCH_REFERENCE_LIST list;
+
+        m_random.seed( seed );
+        generate( list, 1 + random( 60 ), 1 + random( 4 ), 1 + random( 30 ) );
+
+        BOOST_TEST_CHECKPOINT( "seed " << seed );
+        checkAgainstReference( list, seed % 2, 10 );
+    }
+}
+
+/**
+ * Checks large schematics, not annotated and half annotated, against the reference
+ * algorithm, and reports the time both take.
+ */
+BOOST_AUTO_TEST_CASE( LargeSchematic )
+{
+    for( int count : { 2000, 20000 } )
+    {
+        for( int maxNumber : { 0, count / 2 } )
+        {
+            SCH_REFERENCE_LIST list;
+
+            m_random.seed( count );
+            generate( list, count, 8, maxNumber );
+
+            checkAgainstReference( list, false, 0, true );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
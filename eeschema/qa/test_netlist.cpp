@@ -0,0 +1,618 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <class_netlist_object.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <trigo.h>
+#include <profile.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#define IS_WIRE false
+#define IS_BUS true
+
+
+/**
+ * The connection algorithm NETLIST_OBJECT_LIST used before it was indexed: each item is
+ * compared to all the others, and the merge of two nets renames the items of one of them.
+ * The net codes it gives are the ones the indexed algorithm must give.
+ */
+class REFERENCE_NETLIST
+{
+public:
+    REFERENCE_NETLIST( std::vector<NETLIST_OBJECT*>& aItems ) :
+        m_items( aItems ),
+        m_lastNetCode( 1 ),
+        m_lastBusNetCode( 1 )
+    {
+    }
+
+    void Build();
+
+private:
+    void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, unsigned aStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJunction, bool aIsBus, unsigned aStart );
+    void connectBusLabels();
+    void labelConnect( NETLIST_OBJECT* aLabelRef );
+    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
+
+    std::vector<NETLIST_OBJECT*>& m_items;
+    int m_lastNetCode;
+    int m_lastBusNetCode;
+};
+
+
+void REFERENCE_NETLIST::Build()
+{
+    std::sort( m_items.begin(), m_items.end(),
+               []( const NETLIST_OBJECT* a, const NETLIST_OBJECT* b )
+               {
+                   return a->m_SheetPath.Cmp( b->m_SheetPath ) < 0;
+               } );
+
+    SCH_SHEET_PATH* sheet = &m_items[0]->m_SheetPath;
+
+    for( unsigned ii = 0, istart = 0; ii < m_items.size(); ii++ )
+    {
+        NETLIST_OBJECT* item = m_items[ii];
+
+        if( item->m_SheetPath != *sheet )
+        {
+            sheet = &item->m_SheetPath;
+            istart = ii;
+        }
+
+        switch( item->m_Type )
+        {
+        case NET_PIN:
+        case NET_PINLABEL:
+        case NET_SHEETLABEL:
+        case NET_NOCONNECT:
+            if( item->GetNet() != 0 )
+                break;
+
+        case NET_SEGMENT:
+            if( item->GetNet() == 0 )
+                item->SetNet( m_lastNetCode++ );
+
+            pointToPointConnect( item, IS_WIRE, istart );
+            break;
+
+        case NET_JUNCTION:
+            if( item->GetNet() == 0 )
+                item->SetNet( m_lastNetCode++ );
+
+            segmentToPointConnect( item, IS_WIRE, istart );
+
+            if( item->m_BusNetCode == 0 )
+                item->m_BusNetCode = m_lastBusNetCode++;
+
+            segmentToPointConnect( item, IS_BUS, istart );
+            break;
+
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+            if( item->GetNet() == 0 )
+                item->SetNet( m_lastNetCode++ );
+
+            segmentToPointConnect( item, IS_WIRE, istart );
+            break;
+
+        case NET_SHEETBUSLABELMEMBER:
+            if( item->m_BusNetCode != 0 )
+                break;
+
+        case NET_BUS:
+            if( item->m_BusNetCode == 0 )
+                item->m_BusNetCode = m_lastBusNetCode++;
+
+            pointToPointConnect( item, IS_BUS, istart );
+            break;
+
+        case NET_BUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            if( item->GetNet() == 0 )
+                item->m_BusNetCode = m_lastBusNetCode++;
+
+            segmentToPointConnect( item, IS_BUS, istart );
+            break;
+
+        case NET_ITEM_UNSPECIFIED:
+            break;
+        }
+    }
+
+    connectBusLabels();
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        switch( item->m_Type )
+        {
+        case NET_LABEL:
+        case NET_GLOBLABEL:
+        case NET_PINLABEL:
+        case NET_BUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            labelConnect( item );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        if( item->m_Type == NET_SHEETLABEL || item->m_Type == NET_SHEETBUSLABELMEMBER )
+            sheetLabelConnect( item );
+    }
+
+    // Compress the net codes, like NETLIST_OBJECT_LIST does
+    std::sort( m_items.begin(), m_items.end(),
+               []( const NETLIST_OBJECT* a, const NETLIST_OBJECT* b )
+               {
+                   return a->GetNet() < b->GetNet();
+               } );
+
+    int netCode = 0;
+    int lastNetCode = 0;
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        if( item->GetNet() != lastNetCode )
+        {
+            netCode++;
+            lastNetCode = item->GetNet();
+        }
+
+        item->SetNet( netCode );
+    }
+}
+
+
+void REFERENCE_NETLIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+{
+    if( aOldNetCode == aNewNetCode )
+        return;
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        if( aIsBus == IS_WIRE && item->GetNet() == aOldNetCode )
+            item->SetNet( aNewNetCode );
+        else if( aIsBus == IS_BUS && item->m_BusNetCode == aOldNetCode )
+            item->m_BusNetCode = aNewNetCode;
+    }
+}
+
+
+void REFERENCE_NETLIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus,
+                                             unsigned aStart )
+{
+    int netCode = aIsBus == IS_WIRE ? aRef->GetNet() : aRef->m_BusNetCode;
+
+    for( unsigned i = aStart; i < m_items.size(); i++ )
+    {
+        NETLIST_OBJECT* item = m_items[i];
+
+        if( item->m_SheetPath != aRef->m_SheetPath )
+            continue;
+
+        bool isBusItem = false;
+
+        switch( item->m_Type )
+        {
+        case NET_SEGMENT:
+        case NET_PIN:
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+        case NET_SHEETLABEL:
+        case NET_PINLABEL:
+        case NET_NOCONNECT:
+            break;
+
+        case NET_JUNCTION:
+            // Junctions connect both wires and buses
+            isBusItem = aIsBus;
+            break;
+
+        case NET_BUS:
+        case NET_BUSLABELMEMBER:
+        case NET_SHEETBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            isBusItem = true;
+            break;
+
+        case NET_ITEM_UNSPECIFIED:
+            continue;
+        }
+
+        if( isBusItem != aIsBus )
+            continue;
+
+        if( aRef->m_Start != item->m_Start && aRef->m_Start != item->m_End
+            && aRef->m_End != item->m_Start && aRef->m_End != item->m_End )
+            continue;
+
+        if( aIsBus == IS_WIRE )
+        {
+            if( item->GetNet() == 0 )
+                item->SetNet( netCode );
+            else
+                propagateNetCode( item->GetNet(), netCode, IS_WIRE );
+        }
+        else
+        {
+            if( item->m_BusNetCode == 0 )
+                item->m_BusNetCode = netCode;
+            else
+                propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
+        }
+    }
+}
+
+
+void REFERENCE_NETLIST::segmentToPointConnect( NETLIST_OBJECT* aJunction, bool aIsBus,
+                                               unsigned aStart )
+{
+    for( unsigned i = aStart; i < m_items.size(); i++ )
+    {
+        NETLIST_OBJECT* segment = m_items[i];
+
+        if( segment->m_SheetPath != aJunction->m_SheetPath )
+            continue;
+
+        if( segment->m_Type != ( aIsBus == IS_WIRE ? NET_SEGMENT : NET_BUS ) )
+            continue;
+
+        if( !IsPointOnSegment( segment->m_Start, segment->m_End, aJunction->m_Start ) )
+            continue;
+
+        if( aIsBus == IS_WIRE )
+        {
+            if( segment->GetNet() )
+                propagateNetCode( segment->GetNet(), aJunction->GetNet(), IS_WIRE );
+            else
+                segment->SetNet( aJunction->GetNet() );
+        }
+        else
+        {
+            if( segment->m_BusNetCode )
+                propagateNetCode( segment->m_BusNetCode, aJunction->m_BusNetCode, IS_BUS );
+            else
+                segment->m_BusNetCode = aJunction->m_BusNetCode;
+        }
+    }
+}
+
+
+void REFERENCE_NETLIST::connectBusLabels()
+{
+    for( unsigned ii = 0; ii < m_items.size(); ii++ )
+    {
+        NETLIST_OBJECT* label = m_items[ii];
+
+        if( !label->IsLabelBusMemberType() )
+            continue;
+
+        if( label->GetNet() == 0 )
+            label->SetNet( m_lastNetCode++ );
+
+        for( unsigned jj = ii + 1; jj < m_items.size(); jj++ )
+        {
+            NETLIST_OBJECT* other = m_items[jj];
+
+            if( !other->IsLabelBusMemberType() || other->m_BusNetCode != label->m_BusNetCode
+                || other->m_Member != label->m_Member )
+                continue;
+
+            if( other->GetNet() == 0 )
+                other->SetNet( label->GetNet() );
+            else
+                propagateNetCode( other->GetNet(), label->GetNet(), IS_WIRE );
+        }
+    }
+}
+
+
+void REFERENCE_NETLIST::labelConnect( NETLIST_OBJECT* aLabelRef )
+{
+    if( aLabelRef->GetNet() == 0 )
+        return;
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        if( item->GetNet() == aLabelRef->GetNet() )
+            continue;
+
+        if( item->m_SheetPath != aLabelRef->m_SheetPath )
+        {
+            if( item->m_Type != NET_PINLABEL && item->m_Type != NET_GLOBLABEL
+                && item->m_Type != NET_GLOBBUSLABELMEMBER )
+                continue;
+
+            if( ( item->m_Type == NET_GLOBLABEL || item->m_Type == NET_GLOBBUSLABELMEMBER )
+                && item->m_Type != aLabelRef->m_Type )
+                continue;
+        }
+
+        if( !item->IsLabelType() || item->m_Label != aLabelRef->m_Label )
+            continue;
+
+        if( item->GetNet() )
+            propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
+        else
+            item->SetNet( aLabelRef->GetNet() );
+    }
+}
+
+
+void REFERENCE_NETLIST::sheetLabelConnect( NETLIST_OBJECT* aSheetLabel )
+{
+    if( aSheetLabel->GetNet() == 0 )
+        return;
+
+    for( NETLIST_OBJECT* item : m_items )
+    {
+        if( item->m_SheetPath != aSheetLabel->m_SheetPathInclude )
+            continue;
+
+        if( item->m_Type != NET_HIERLABEL && item->m_Type != NET_HIERBUSLABELMEMBER )
+            continue;
+
+        if( item->GetNet() == aSheetLabel->GetNet() || item->m_Label != aSheetLabel->m_Label )
+            continue;
+
+        if( item->GetNet() )
+            propagateNetCode( item->GetNet(), aSheetLabel->GetNet(), IS_WIRE );
+        else
+            item->SetNet( aSheetLabel->GetNet() );
+    }
+}
+
+
+/**
+ * A root sheet and its sub-sheets, used to generate the items of random schematics.
+ */
+struct NetlistFixture
+{
+    std::vector<std::unique_ptr<SCH_SHEET>> m_sheets;
+    std::vector<SCH_SHEET_PATH>             m_paths;
+    std::mt19937                            m_random;
+
+    NetlistFixture()
+    {
+        for( int i = 0; i < 8; i++ )
+        {
+            m_sheets.emplace_back( new SCH_SHEET );
+            m_sheets.back()->SetTimeStamp( 0x1000 + i );
+
+            SCH_SHEET_PATH path;
+            path.push_back( m_sheets[0].get() );
+
+            if( i > 0 )
+                path.push_back( m_sheets.back().get() );
+
+            m_paths.push_back( path );
+        }
+    }
+
+    int random( int aMax )
+    {
+        return std::uniform_int_distribution<int>( 0, aMax )( m_random );
+    }
+
+    /**
+     * Adds \a aCount random items to \a aList, spread over \a aSheetCount sheets.  The
+     * coordinates are picked in a \a aGridSize x \a aGridSize grid so that many items
+     * touch each other, and the labels are picked among \a aLabelCount names.
+     */
+    void generate( NETLIST_OBJECT_LIST& aList, int aCount, int aSheetCount, int aGridSize,
+                   int aLabelCount )
+    {
+        static const NETLIST_ITEM_T types[] =
+        {
+            NET_SEGMENT, NET_BUS, NET_JUNCTION, NET_LABEL, NET_GLOBLABEL, NET_HIERLABEL,
+            NET_SHEETLABEL, NET_BUSLABELMEMBER, NET_GLOBBUSLABELMEMBER, NET_HIERBUSLABELMEMBER,
+            NET_SHEETBUSLABELMEMBER, NET_PINLABEL, NET_PIN, NET_NOCONNECT
+        };
+
+        const int typeCount = sizeof( types ) / sizeof( types[0] );
+
+        for( int i = 0; i < aCount; i++ )
+        {
+            NETLIST_OBJECT* item = new NETLIST_OBJECT;
+            int step = 100;
+
+            item->m_Type = types[ random( typeCount - 1 ) ];
+            item->m_SheetPath = m_paths[ random( aSheetCount - 1 ) ];
+            item->m_SheetPathInclude = m_paths[ random( aSheetCount - 1 ) ];
+            item->m_Label = wxString::Format( wxT( "N%d" ), random( aLabelCount - 1 ) );
+            item->m_Member = random( 1 );
+            item->m_Start = wxPoint( random( aGridSize ) * step, random( aGridSize ) * step );
+            item->m_End = item->m_Start;
+
+            if( item->m_Type == NET_SEGMENT || item->m_Type == NET_BUS )
+            {
+                int length = ( random( 6 ) - 3 ) * step;
+
+                switch( random( 3 ) )
+                {
+                case 0: item->m_End.x += length; break;
+                case 1: item->m_End.y += length; break;
+                case 2: item->m_End += wxPoint( length, length ); break;
+                default: item->m_End = wxPoint( random( aGridSize ) * step, 0 ); break;
+                }
+            }
+
+            aList.push_back( item );
+        }
+    }
+
+    /**
+     * Connects the items of \a aList with NETLIST_OBJECT_LIST and with the reference
+     * algorithm, and checks they give the same net codes.
+     * @param aReportTimes = true to print the time taken by both algorithms
+     */
+    void checkAgainstReference( NETLIST_OBJECT_LIST& aList, bool aReportTimes = false )
+    {
+        // Copies of the items for the reference, aList is reordered by BuildConnections()
+        std::vector<std::pair<NETLIST_OBJECT*, std::unique_ptr<NETLIST_OBJECT>>> items;
+        std::vector<NETLIST_OBJECT*> referenceItems;
+
+        for( NETLIST_OBJECT* item : aList )
+        {
+            items.emplace_back( item, std::unique_ptr<NETLIST_OBJECT>(
+                                              new NETLIST_OBJECT( *item ) ) );
+            referenceItems.push_back( items.back().second.get() );
+        }
+
+        // PROF_COUNTER::msecs() keeps counting after Stop(), read the times right away
+        PROF_COUNTER counter;
+        aList.BuildConnections();
+        counter.Stop();
+        double buildTime = counter.msecs();
+
+        counter.Start();
+        REFERENCE_NETLIST reference( referenceItems );
+        reference.Build();
+        counter.Stop();
+        double referenceTime = counter.msecs();
+
+        if( aReportTimes )
+        {
+            BOOST_TEST_MESSAGE( aList.size() << " items: " << buildTime << " ms, "
+                                << referenceTime << " ms with the reference algorithm" );
+        }
+
+        // The net names are chosen from the net codes, by unchanged code
+        for( auto& item : items )
+        {
+            BOOST_REQUIRE_EQUAL( item.first->GetNet(), item.second->GetNet() );
+            BOOST_REQUIRE_EQUAL( item.first->m_BusNetCode, item.second->m_BusNetCode );
+        }
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Netlist, NetlistFixture )
+
+/**
+ * Checks the connections of a few hand made items.
+ */
+BOOST_AUTO_TEST_CASE( Basic )
+{
+    NETLIST_OBJECT_LIST list;
+
+    auto add = [&]( NETLIST_ITEM_T aType, int aSheet, wxPoint aStart, wxPoint aEnd,
+                    const wxString& aLabel = wxEmptyString )
+    {
+        NETLIST_OBJECT* item = new NETLIST_OBJECT;
+
+        item->m_Type = aType;
+        item->m_SheetPath = m_paths[aSheet];
+        item->m_Start = aStart;
+        item->m_End = aEnd;
+        item->m_Label = aLabel;
+        list.push_back( item );
+
+        return item;
+    };
+
+    NETLIST_OBJECT* pin1 = add( NET_PIN, 0, wxPoint( 0, 0 ), wxPoint( 0, 0 ) );
+    NETLIST_OBJECT* wire1 = add( NET_SEGMENT, 0, wxPoint( 0, 0 ), wxPoint( 1000, 0 ) );
+    NETLIST_OBJECT* wire2 = add( NET_SEGMENT, 0, wxPoint( 500, 0 ), wxPoint( 500, 500 ) );
+    NETLIST_OBJECT* junction = add( NET_JUNCTION, 0, wxPoint( 500, 0 ), wxPoint( 500, 0 ) );
+    NETLIST_OBJECT* label1 = add( NET_LABEL, 0, wxPoint( 500, 300 ), wxPoint( 500, 300 ),
+                                  wxT( "A" ) );
+    NETLIST_OBJECT* label2 = add( NET_LABEL, 0, wxPoint( 5000, 0 ), wxPoint( 5000, 0 ),
+                                  wxT( "A" ) );
+    NETLIST_OBJECT* pin2 = add( NET_PIN, 0, wxPoint( 5000, 0 ), wxPoint( 5000, 0 ) );
+
+    // Same label, other sheet: not connected
+    NETLIST_OBJECT* label3 = add( NET_LABEL, 1, wxPoint( 500, 300 ), wxPoint( 500, 300 ),
+                                  wxT( "A" ) );
+
+    // Wire crossing another one without a junction: not connected
+    NETLIST_OBJECT* wire3 = add( NET_SEGMENT, 0, wxPoint( 800, -500 ), wxPoint( 800, 500 ) );
+
+    BOOST_CHECK_EQUAL( list.BuildConnections(), 3 );
+
+    BOOST_CHECK_EQUAL( wire1->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_EQUAL( wire2->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_EQUAL( junction->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_EQUAL( label1->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_EQUAL( label2->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_EQUAL( pin2->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_NE( label3->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_NE( wire3->GetNet(), pin1->GetNet() );
+    BOOST_CHECK_NE( wire3->GetNet(), label3->GetNet() );
+
+    BOOST_CHECK_EQUAL( pin1->GetConnectionType(), PAD_CONNECT );
+}
+
+/**
+ * Checks the net codes of random schematics against the reference algorithm.
+ */
+BOOST_AUTO_TEST_CASE( RandomSchematics )
+{
+    for( int seed = 0; seed < 2000; seed++ )
+    {
+        NETLIST_OBJECT_LIST list;
+
+        m_random.seed( seed );
+        generate( list, 1 + random( 80 ), 1 + random( 3 ), 4, 3 );
+
+        BOOST_TEST_CHECKPOINT( "seed " << seed );
+        checkAgainstReference( list );
+    }
+}
+
+/**
+ * Checks a large schematic against the reference algorithm, and reports the time both
+ * take.
+ */
+BOOST_AUTO_TEST_CASE( LargeSchematic )
+{
+    for( int count : { 2000, 20000 } )
+    {
+        NETLIST_OBJECT_LIST list;
+
+        m_random.seed( count );
+        generate( list, count, 8, 200, count / 20 );
+
+        checkAgainstReference( list, true );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,441 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <class_netlist_object.h>
+#include <class_sch_screen.h>
+#include <sch_marker.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <erc.h>
+#include <profile.h>
+
+#include <cctype>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <set>
+#include <vector>
+
+
+/**
+ * A marker of similar labels: the error code and the positions of both labels.
+ */
+struct SIMILAR_LABELS
+{
+    int     m_code;
+    wxPoint m_posA;
+    wxPoint m_posB;
+
+    bool operator==( const SIMILAR_LABELS& aOther ) const
+    {
+        return m_code == aOther.m_code && m_posA == aOther.m_posA && m_posB == aOther.m_posB;
+    }
+
+    bool operator!=( const SIMILAR_LABELS& aOther ) const
+    {
+        return !( *this == aOther );
+    }
+};
+
+
+std::ostream& operator<<( std::ostream& aStream, const SIMILAR_LABELS& aLabels )
+{
+    return aStream << "(" << aLabels.m_code << ", " << aLabels.m_posA.x << ", "
+                   << aLabels.m_posB.x << ")";
+}
+
+
+/**
+ * The similar labels test NETLIST_OBJECT_LIST used before it grouped the labels by text:
+ * all the pairs of labels of the project, and of each sheet, are compared, and the labels
+ * identical to a label are counted by scanning all the labels.  The markers it gives, in
+ * their order, are the ones the new test must give.
+ */
+class REFERENCE_SIMILAR_LABELS
+{
+public:
+    std::vector<SIMILAR_LABELS> Test( std::vector<NETLIST_OBJECT*>& aItems );
+
+private:
+    struct compare_labels
+    {
+        bool operator()( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 ) const
+        {
+            wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
+            wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
+
+            return str1.Cmp( str2 ) < 0;
+        }
+    };
+
+    struct compare_label_names
+    {
+        bool operator()( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 ) const
+        {
+            return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
+        }
+    };
+
+    struct compare_paths
+    {
+        bool operator()( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 ) const
+        {
+            return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
+        }
+    };
+
+    int countIdenticalLabels( NETLIST_OBJECT* aLabel );
+    void diagnose( NETLIST_OBJECT* aLabelA, NETLIST_OBJECT* aLabelB );
+
+    std::vector<NETLIST_OBJECT*> m_fullLabelList;
+    std::vector<SIMILAR_LABELS>  m_markers;
+};
+
+
+std::vector<SIMILAR_LABELS> REFERENCE_SIMILAR_LABELS::Test( std::vector<NETLIST_OBJECT*>& aItems )
+{
+    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
+
+    for( NETLIST_OBJECT* item : aItems )
+    {
+        switch( item->m_Type )
+        {
+        case NET_LABEL:
+        case NET_BUSLABELMEMBER:
+        case NET_PINLABEL:
+        case NET_GLOBBUSLABELMEMBER:
+        case NET_HIERLABEL:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBLABEL:
+            uniqueLabelList.insert( item );
+            m_fullLabelList.push_back( item );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Global labels
+    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
+
+    for( NETLIST_OBJECT* label : uniqueLabelList )
+    {
+        if( label->IsLabelGlobal() )
+            loc_labelList.insert( label );
+    }
+
+    for( auto it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
+    {
+        for( auto it_aux = std::next( it ); it_aux != loc_labelList.end(); ++it_aux )
+        {
+            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
+                diagnose( *it, *it_aux );
+        }
+    }
+
+    // Labels of each sheet path
+    std::set<NETLIST_OBJECT*, compare_paths> pathsList( uniqueLabelList.begin(),
+                                                         uniqueLabelList.end() );
+
+    for( NETLIST_OBJECT* path : pathsList )
+    {
+        loc_labelList.clear();
+
+        for( NETLIST_OBJECT* label : uniqueLabelList )
+        {
+            if( path->m_SheetPath.Path() == label->m_SheetPath.Path() )
+                loc_labelList.insert( label );
+        }
+
+        for( auto it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
+        {
+            for( auto it_aux = std::next( it ); it_aux != loc_labelList.end(); ++it_aux )
+            {
+                if( (*it)->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
+                    continue;
+
+                if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
+                    diagnose( *it, *it_aux );
+            }
+        }
+    }
+
+    return m_markers;
+}
+
+
+int REFERENCE_SIMILAR_LABELS::countIdenticalLabels( NETLIST_OBJECT* aLabel )
+{
+    int count = 0;
+
+    for( NETLIST_OBJECT* item : m_fullLabelList )
+    {
+        if( aLabel->IsLabelGlobal() )
+        {
+            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
+                count++;
+        }
+        else if( item->m_Label == aLabel->m_Label
+                 && item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+void REFERENCE_SIMILAR_LABELS::diagnose( NETLIST_OBJECT* aLabelA, NETLIST_OBJECT* aLabelB )
+{
+    if( countIdenticalLabels( aLabelA ) > countIdenticalLabels( aLabelB ) )
+        std::swap( aLabelA, aLabelB );
+
+    SIMILAR_LABELS marker;
+
+    marker.m_code = aLabelA->IsLabelGlobal() && aLabelB->IsLabelGlobal() ?
+                            ERCE_SIMILAR_GLBL_LABELS : ERCE_SIMILAR_LABELS;
+    marker.m_posA = aLabelA->m_Start;
+    marker.m_posB = aLabelB->m_Start;
+    m_markers.push_back( marker );
+}
+
+
+/**
+ * Sheets sharing one screen, so that all the markers are appended to the same list, in
+ * the order they are created.
+ */
+struct SimilarLabelsFixture
+{
+    std::vector<std::unique_ptr<SCH_SHEET>> m_sheets;
+    std::vector<SCH_SHEET_PATH>             m_paths;
+    SCH_SCREEN*                             m_screen;
+    std::mt19937                            m_random;
+
+    SimilarLabelsFixture()
+    {
+        m_screen = new SCH_SCREEN( nullptr );
+
+        for( int i = 0; i < 8; i++ )
+        {
+            m_sheets.emplace_back( new SCH_SHEET );
+            m_sheets.back()->SetTimeStamp( 0x1000 + i );
+            m_sheets.back()->SetScreen( m_screen );
+
+            SCH_SHEET_PATH path;
+            path.push_back( m_sheets[0].get() );
+
+            if( i > 0 )
+                path.push_back( m_sheets.back().get() );
+
+            m_paths.push_back( path );
+        }
+    }
+
+    int random( int aMax )
+    {
+        return std::uniform_int_distribution<int>( 0, aMax )( m_random );
+    }
+
+    /**
+     * Adds \a aCount random labels to \a aList, spread over \a aSheetCount sheets.  The
+     * texts are \a aTextCount different words written with random cases, and each label
+     * has its own position, which identifies it in the markers.
+     */
+    void generate( NETLIST_OBJECT_LIST& aList, int aCount, int aSheetCount, int aTextCount )
+    {
+        static const NETLIST_ITEM_T types[] =
+        {
+            NET_LABEL, NET_GLOBLABEL, NET_HIERLABEL, NET_PINLABEL, NET_BUSLABELMEMBER,
+            NET_GLOBBUSLABELMEMBER, NET_HIERBUSLABELMEMBER, NET_SHEETLABEL,
+            NET_SHEETBUSLABELMEMBER, NET_PIN, NET_SEGMENT
+        };
+
+        const int typeCount = sizeof( types ) / sizeof( types[0] );
+
+        for( int i = 0; i < aCount; i++ )
+        {
+            NETLIST_OBJECT* item = new NETLIST_OBJECT;
+            std::string text = "net" + std::to_string( random( aTextCount - 1 ) );
+
+            for( char& c : text )
+            {
+                if( random( 3 ) == 0 )
+                    c = toupper( c );
+            }
+
+            item->m_Type = types[ random( typeCount - 1 ) ];
+            item->m_SheetPath = m_paths[ random( aSheetCount - 1 ) ];
+            item->m_Label = wxString( text );
+            item->m_Start = wxPoint( i, 0 );
+            aList.push_back( item );
+        }
+    }
+
+    /**
+     * @return the markers of the screen, in their order
+     */
+    std::vector<SIMILAR_LABELS> getMarkers()
+    {
+        std::vector<SIMILAR_LABELS> markers;
+
+        for( SCH_ITEM* item = m_screen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->Type() != SCH_MARKER_T )
+                continue;
+
+            const DRC_ITEM& reporter = static_cast<SCH_MARKER*>( item )->GetReporter();
+            SIMILAR_LABELS marker;
+
+            marker.m_code = reporter.GetErrorCode();
+            marker.m_posA = reporter.GetPointA();
+            marker.m_posB = reporter.GetPointB();
+            markers.push_back( marker );
+        }
+
+        return markers;
+    }
+
+    /**
+     * Runs the similar labels test of \a aList and of the reference, and checks they give
+     * the same markers in the same order.
+     * @param aReportTimes = true to print the time taken by both tests
+     */
+    void checkAgainstReference( NETLIST_OBJECT_LIST& aList, bool aReportTimes = false )
+    {
+        m_screen->FreeDrawList();
+
+        std::vector<NETLIST_OBJECT*> items( aList.begin(), aList.end() );
+
+        // PROF_COUNTER::msecs() keeps counting after Stop(), read the times right away
+        PROF_COUNTER counter;
+        aList.TestforSimilarLabels();
+        counter.Stop();
+        double testTime = counter.msecs();
+
+        counter.Start();
+        REFERENCE_SIMILAR_LABELS reference;
+        std::vector<SIMILAR_LABELS> expected = reference.Test( items );
+        counter.Stop();
+        double referenceTime = counter.msecs();
+
+        if( aReportTimes )
+        {
+            BOOST_TEST_MESSAGE( aList.size() << " items, " << expected.size() << " markers: "
+                                << testTime << " ms, " << referenceTime
+                                << " ms with the reference test" );
+        }
+
+        std::vector<SIMILAR_LABELS> markers = getMarkers();
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( markers.begin(), markers.end(),
+                                       expected.begin(), expected.end() );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SimilarLabels, SimilarLabelsFixture )
+
+/**
+ * Checks the markers of a few hand made labels.
+ */
+BOOST_AUTO_TEST_CASE( Basic )
+{
+    NETLIST_OBJECT_LIST list;
+
+    auto add = [&]( NETLIST_ITEM_T aType, int aSheet, int aPos, const wxString& aLabel )
+    {
+        NETLIST_OBJECT* item = new NETLIST_OBJECT;
+
+        item->m_Type = aType;
+        item->m_SheetPath = m_paths[aSheet];
+        item->m_Start = wxPoint( aPos, 0 );
+        item->m_Label = aLabel;
+        list.push_back( item );
+    };
+
+    // Local labels of the same sheet, the most used text is reported second
+    add( NET_LABEL, 0, 1, wxT( "clk" ) );
+    add( NET_LABEL, 0, 2, wxT( "CLK" ) );
+    add( NET_LABEL, 0, 3, wxT( "CLK" ) );
+
+    // Local labels of other sheets are not compared
+    add( NET_LABEL, 1, 4, wxT( "Clk" ) );
+
+    // Global labels are compared in the whole project
+    add( NET_GLOBLABEL, 1, 5, wxT( "vcc" ) );
+    add( NET_GLOBLABEL, 2, 6, wxT( "VCC" ) );
+
+    // Sheet labels are not tested
+    add( NET_SHEETLABEL, 2, 7, wxT( "vCC" ) );
+
+    list.TestforSimilarLabels();
+
+    std::vector<SIMILAR_LABELS> expected =
+    {
+        { ERCE_SIMILAR_GLBL_LABELS, wxPoint( 6, 0 ), wxPoint( 5, 0 ) },
+        { ERCE_SIMILAR_LABELS, wxPoint( 1, 0 ), wxPoint( 2, 0 ) },
+    };
+    std::vector<SIMILAR_LABELS> markers = getMarkers();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( markers.begin(), markers.end(),
+                                   expected.begin(), expected.end() );
+}
+
+/**
+ * Checks the markers of random label sets against the reference test.
+ */
+BOOST_AUTO_TEST_CASE( RandomLabels )
+{
+    for( int seed = 0; seed < 500; seed++ )
+    {
+        NETLIST_OBJECT_LIST list;
+
+        m_random.seed( seed );
+        generate( list, 1 + random( 60 ), 1 + random( 4 ), 1 + random( 5 ) );
+
+        BOOST_TEST_CHECKPOINT( "seed " << seed );
+        checkAgainstReference( list );
+    }
+}
+
+/**
+ * Checks a large label set against the reference test, and reports the time both take.
+ */
+BOOST_AUTO_TEST_CASE( LargeSchematic )
+{
+    for( int count : { 2000, 20000 } )
+    {
+        NETLIST_OBJECT_LIST list;
+
+        m_random.seed( count );
+        generate( list, count, 8, count / 10 );
+
+        checkAgainstReference( list, true );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,404 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <symbol_lib_index.h>
+#include <common.h>
+#include <profile.h>
+#include <richio.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/init.h>
+#include <wx/utils.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/**
+ * Initializes wxWidgets, and keeps the index files of the tests out of the user's
+ * configuration directory.
+ */
+struct SYMBOL_LIB_INDEX_ENVIRONMENT
+{
+    SYMBOL_LIB_INDEX_ENVIRONMENT()
+    {
+        wxSetEnv( wxT( "XDG_CONFIG_HOME" ), RootDir() + wxT( "config" ) );
+    }
+
+    ~SYMBOL_LIB_INDEX_ENVIRONMENT()
+    {
+        wxFileName::Rmdir( RootDir(), wxPATH_RMDIR_RECURSIVE );
+    }
+
+    static wxString RootDir()
+    {
+        static const wxString root = wxFileName::GetTempDir() + wxFileName::GetPathSeparator()
+                + wxString::Format( wxT( "qa_symbol_lib_index_%lu" ), wxGetProcessId() )
+                + wxFileName::GetPathSeparator();
+
+        return root;
+    }
+
+    wxInitializer m_wxInit;
+};
+
+BOOST_GLOBAL_FIXTURE( SYMBOL_LIB_INDEX_ENVIRONMENT );
+
+
+/// A part with drawings, and footprint filters which look like keywords
+static const char* resistor =
+        "DEF R R 0 0 N Y 1 F N\n"
+        "F0 \"R\" 80 0 50 V V C CNN\n"
+        "F1 \"R\" 0 0 50 V V C CNN\n"
+        "ALIAS R_Small\n"
+        "$FPLIST\n"
+        " DRAW\n"
+        " R_*\n"
+        "$ENDFPLIST\n"
+        "DRAW\n"
+        "S -40 -100 40 100 0 1 10 N\n"
+        "X ~ 1 0 150 50 D 50 50 1 1 P\n"
+        "X ~ 2 0 -150 50 U 50 50 1 1 P\n"
+        "ENDDRAW\n"
+        "ENDDEF\n";
+
+/// A part without drawings
+static const char* empty =
+        "DEF EMPTY U 0 40 Y Y 1 F N\n"
+        "F0 \"U\" 0 0 50 H V C CNN\n"
+        "F1 \"EMPTY\" 0 0 50 H V C CNN\n"
+        "ENDDEF\n";
+
+
+/**
+ * A library and its document file, in their own directory.
+ */
+struct SymbolLibIndexFixture
+{
+    wxString m_libFileName;
+    wxString m_docFileName;
+
+    SymbolLibIndexFixture()
+    {
+        static int count = 0;
+
+        wxString dir = SYMBOL_LIB_INDEX_ENVIRONMENT::RootDir()
+                + wxString::Format( wxT( "lib%d" ), count++ );
+
+        wxFileName::Mkdir( dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+        m_libFileName = dir + wxFileName::GetPathSeparator() + wxT( "symbols.lib" );
+        m_docFileName = dir + wxFileName::GetPathSeparator() + wxT( "symbols.dcm" );
+    }
+
+    /**
+     * Writes \a aContent to \a aFileName, and sets its modification time \a aAgeHours ago
+     * (0 keeps the current time).
+     */
+    void writeFile( const wxString& aFileName, const std::string& aContent, int aAgeHours = 1 )
+    {
+        wxFFile file( aFileName, wxT( "wb" ) );
+
+        file.Write( aContent.c_str(), aContent.size() );
+        file.Close();
+
+        if( aAgeHours > 0 )
+        {
+            wxDateTime time = wxDateTime::Now() - wxTimeSpan::Hours( aAgeHours );
+            wxFileName( aFileName ).SetTimes( &time, &time, NULL );
+        }
+    }
+
+    void writeLibrary( const std::string& aParts, int aAgeHours = 1 )
+    {
+        writeFile( m_libFileName, "EESchema-LIBRARY Version 2.3\n#encoding utf-8\n" + aParts
+                   + "#\n#End Library\n", aAgeHours );
+    }
+
+    void writeDocs( const std::string& aDescription, int aAgeHours = 1 )
+    {
+        writeFile( m_docFileName, "EESchema-DOCLIB  Version 2.0\n#\n$CMP R\nD " + aDescription
+                   + "\n$ENDCMP\n#\n#End Doc Library\n", aAgeHours );
+    }
+
+    /// Scans the library and writes its index, as the legacy plugin does after loading it
+    void writeIndex()
+    {
+        SYMBOL_LIB_INDEX index( m_libFileName, m_docFileName );
+        SYMBOL_LIB_INDEX::ALIAS alias = { wxT( "R" ), wxT( "Resistor (\"small\")" ),
+                                          wxT( "R res" ), wxT( "r.pdf" ) };
+
+        index.Scan();
+        index.SetVersion( 2, 3, 0 );
+        index.GetAliases().push_back( alias );
+        index.Write();
+    }
+
+    /// @return the lines of the library file from the line at \a aOffset to ENDDRAW
+    std::string readDrawings( long long aOffset, unsigned aLine )
+    {
+        FILE* fp = wxFopen( m_libFileName, wxT( "rt" ) );
+
+        BOOST_REQUIRE( fp != NULL );
+        BOOST_REQUIRE_EQUAL( fseek( fp, (long) aOffset, SEEK_SET ), 0 );
+
+        FILE_LINE_READER reader( fp, m_libFileName, true, aLine - 1 );
+        std::string      text;
+
+        while( const char* line = reader.ReadLine() )
+        {
+            text.append( line, reader.Length() );
+
+            if( strncmp( line, "ENDDRAW", 7 ) == 0 )
+                break;
+        }
+
+        return text;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SymbolLibIndex, SymbolLibIndexFixture )
+
+/**
+ * Checks the part definitions and drawing positions found by Scan().
+ */
+BOOST_AUTO_TEST_CASE( Scan )
+{
+    writeLibrary( std::string( "#\n# R\n#\n" ) + resistor + "#\n# EMPTY\n#\n" + empty );
+
+    SYMBOL_LIB_INDEX index( m_libFileName, m_docFileName );
+
+    index.Scan();
+
+    BOOST_REQUIRE_EQUAL( index.GetParts().size(), 2 );
+
+    const SYMBOL_LIB_INDEX::PART& r = index.GetParts()[0];
+    std::string                   definition( resistor );
+    size_t                        draw = definition.find( "DRAW\nS" );
+    size_t                        endDraw = definition.find( "ENDDRAW\n" ) + 8;
+
+    BOOST_CHECK_EQUAL( r.m_definition, definition.substr( 0, draw )
+                                       + definition.substr( endDraw ) );
+    BOOST_CHECK_EQUAL( r.m_line, 6 );
+    BOOST_CHECK_EQUAL( r.m_drawLine, 14 );
+    BOOST_CHECK_EQUAL( readDrawings( r.m_drawOffset, r.m_drawLine ),
+                       definition.substr( draw, endDraw - draw ) );
+
+    const SYMBOL_LIB_INDEX::PART& u = index.GetParts()[1];
+
+    BOOST_CHECK_EQUAL( u.m_definition, std::string( empty ) );
+    BOOST_CHECK_EQUAL( u.m_drawOffset, -1 );
+}
+
+/**
+ * Checks that an index file reads back as it was written.
+ */
+BOOST_AUTO_TEST_CASE( ReadBack )
+{
+    writeLibrary( std::string( resistor ) + empty );
+    writeDocs( "Resistor" );
+    writeIndex();
+
+    SYMBOL_LIB_INDEX scanned( m_libFileName, m_docFileName );
+    SYMBOL_LIB_INDEX index( m_libFileName, m_docFileName );
+
+    scanned.Scan();
+
+    BOOST_REQUIRE( index.Read() );
+    BOOST_CHECK_EQUAL( index.GetVersionMajor(), 2 );
+    BOOST_CHECK_EQUAL( index.GetVersionMinor(), 3 );
+    BOOST_REQUIRE_EQUAL( index.GetParts().size(), scanned.GetParts().size() );
+
+    for( size_t i = 0; i < index.GetParts().size(); i++ )
+    {
+        const SYMBOL_LIB_INDEX::PART& part = index.GetParts()[i];
+        const SYMBOL_LIB_INDEX::PART& expected = scanned.GetParts()[i];
+
+        BOOST_CHECK_EQUAL( part.m_definition, expected.m_definition );
+        BOOST_CHECK_EQUAL( part.m_line, expected.m_line );
+        BOOST_CHECK_EQUAL( part.m_drawOffset, expected.m_drawOffset );
+        BOOST_CHECK_EQUAL( part.m_drawLine, expected.m_drawLine );
+    }
+
+    BOOST_REQUIRE_EQUAL( index.GetAliases().size(), 1 );
+    BOOST_CHECK( index.GetAliases()[0].m_description == wxT( "Resistor (\"small\")" ) );
+    BOOST_CHECK( index.GetAliases()[0].m_keywords == wxT( "R res" ) );
+    BOOST_CHECK( index.GetAliases()[0].m_docFileName == wxT( "r.pdf" ) );
+}
+
+/**
+ * Checks that the index is not used once the library or its document file changed.
+ */
+BOOST_AUTO_TEST_CASE( Modified )
+{
+    writeLibrary( resistor );
+    writeDocs( "Resistor" );
+    writeIndex();
+
+    BOOST_CHECK( SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+
+    writeDocs( "Resistor, modified", 2 );
+    BOOST_CHECK( !SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+
+    writeIndex();
+    BOOST_CHECK( SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+
+    writeLibrary( std::string( resistor ) + empty, 2 );
+    BOOST_CHECK( !SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+
+    // Removing the document file makes the index out of date too
+    writeIndex();
+    wxRemoveFile( m_docFileName );
+    BOOST_CHECK( !SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+}
+
+/**
+ * Checks that a library modified just now is not indexed, as it could still be modified
+ * with the same time stamp.
+ */
+BOOST_AUTO_TEST_CASE( RecentFile )
+{
+    writeLibrary( resistor, 0 );
+    writeIndex();
+
+    BOOST_CHECK( !SYMBOL_LIB_INDEX( m_libFileName, m_docFileName ).Read() );
+}
+
+/**
+ * Checks that a damaged index file is ignored.
+ */
+BOOST_AUTO_TEST_CASE( DamagedIndex )
+{
+    writeLibrary( resistor );
+    writeIndex();
+
+    // Truncate every index file, this library's is one of them
+    wxString indexDir = GetKicadConfigPath() + wxFileName::GetPathSeparator() + wxT( "sym-index" );
+    wxDir dir( indexDir );
+    wxString indexName;
+
+    BOOST_REQUIRE( dir.IsOpened() );
+
+    for( bool found = dir.GetFirst( &indexName, wxT( "*.idx" ), wxDIR_FILES ); found;
+         found = dir.GetNext( &indexName ) )
+    {
+        wxFFile index( indexDir + wxFileName::GetPathSeparator() + indexName, wxT( "w" ) );
+        index.Write( wxT( "(symbol_lib_index (version" ) );
+    }
+
+    SYMBOL_LIB_INDEX index( m_libFileName, m_docFileName );
+
+    BOOST_CHECK( !index.Read() );
+    BOOST_CHECK( index.GetParts().empty() );
+}
+
+/**
+ * Checks a large library, and reports the time taken to read its index and to read the
+ * library and document files as the legacy plugin does without an index.
+ */
+BOOST_AUTO_TEST_CASE( LargeLibrary )
+{
+    std::string parts, docs = "EESchema-DOCLIB  Version 2.0\n";
+
+    // 16 pin ICs, whose drawings take most of the library, as in the usual libraries
+    for( int i = 0; i < 10000; i++ )
+    {
+        std::string name = "U" + std::to_string( i );
+        std::string part( resistor );
+        std::string pins;
+
+        for( int pin = 1; pin <= 16; pin++ )
+        {
+            pins += "X IN" + std::to_string( pin ) + " " + std::to_string( pin ) + " -400 "
+                    + std::to_string( 400 - pin * 50 ) + " 150 R 50 50 1 1 I\n";
+        }
+
+        part.replace( part.find( "DEF R " ) + 4, 1, name );
+        part.replace( part.find( "ALIAS R_Small" ) + 6, 7, name + "_Small" );
+        part.replace( part.find( "X ~ 1" ), part.find( "ENDDRAW" ) - part.find( "X ~ 1" ),
+                      pins );
+        parts += "#\n# " + name + "\n#\n" + part;
+        docs += "#\n$CMP " + name + "\nD Integrated circuit " + name + "\nK IC\n$ENDCMP\n";
+    }
+
+    writeLibrary( parts );
+    writeFile( m_docFileName, docs + "#\n#End Doc Library\n" );
+    writeIndex();
+
+    // PROF_COUNTER::msecs() keeps counting after Stop(), read the times right away
+    PROF_COUNTER counter;
+    SYMBOL_LIB_INDEX index( m_libFileName, m_docFileName );
+    bool read = index.Read();
+    counter.Stop();
+    double indexTime = counter.msecs();
+
+    // Without an index, every line of the library is read and the drawings are copied to
+    // be parsed later, then the document file is read
+    counter.Start();
+    FILE_LINE_READER         libReader( m_libFileName );
+    std::vector<std::string> drawings;
+
+    while( const char* line = libReader.ReadLine() )
+    {
+        if( strncmp( line, "DRAW\n", 5 ) != 0 )
+            continue;
+
+        std::string text( line, libReader.Length() );
+
+        while( ( line = libReader.ReadLine() ) != NULL )
+        {
+            text.append( line, libReader.Length() );
+
+            if( strncmp( line, "ENDDRAW", 7 ) == 0 )
+                break;
+        }
+
+        drawings.push_back( text );
+    }
+
+    FILE_LINE_READER docReader( m_docFileName );
+
+    while( docReader.ReadLine() )
+        ;
+
+    counter.Stop();
+    double fileTime = counter.msecs();
+
+    BOOST_TEST_MESSAGE( "10000 parts: index read in " << indexTime << " ms, library and "
+                        "document files read in " << fileTime << " ms" );
+
+    BOOST_REQUIRE( read );
+    BOOST_CHECK_EQUAL( index.GetParts().size(), 10000 );
+    BOOST_CHECK_EQUAL( drawings.size(), 10000 );
+    BOOST_CHECK( index.GetParts().back().m_definition.find( "ENDDRAW" ) == std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -686,6 +686,8 @@ void SCH_EAGLE_PLUGIN::loadSheet( wxXmlNode* aSheetNode, int aSheetIndex )
         item->ClearFlags();
         item = item->Next();
     }
+
+    m_currentSheet->GetScreen()->InvalidateItemIndex();
 }
 
 
@@ -1766,6 +1768,7 @@ void SCH_EAGLE_PLUGIN::moveLabels( SCH_ITEM* aWire, const wxPoint& aNewEndPoint
                         ( (SCH_LINE*) aWire )->GetEndPoint(), 0 ) )
             {
                 item->SetPosition( aNewEndPoint );
+                m_currentSheet->GetScreen()->InvalidateItemIndex();
             }
         }
     }
@@ -22,6 +22,9 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -31,6 +34,7 @@
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <profile.h>
 #include <core/typeinfo.h>
 #include <properties.h>
 
@@ -46,6 +50,7 @@
 #include <sch_sheet.h>
 #include <sch_bitmap.h>
 #include <sch_legacy_plugin.h>
+#include <symbol_lib_index.h>
 #include <template_fieldnames.h>
 #include <class_sch_screen.h>
 #include <class_libentry.h>
@@ -150,7 +155,7 @@ static bool strCompare( const char* aString, const char* aLine, const char** aOu
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static int parseInt( FILE_LINE_READER& aReader, const char* aLine, const char** aOutput = NULL )
+static int parseInt( LINE_READER& aReader, const char* aLine, const char** aOutput = NULL )
 {
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
@@ -194,7 +199,7 @@ static int parseInt( FILE_LINE_READER& aReader, const char* aLine, const char**
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static unsigned long parseHex( FILE_LINE_READER& aReader, const char* aLine,
+static unsigned long parseHex( LINE_READER& aReader, const char* aLine,
                                const char** aOutput = NULL )
 {
     if( !*aLine )
@@ -242,7 +247,7 @@ static unsigned long parseHex( FILE_LINE_READER& aReader, const char* aLine,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a valid integer.
  */
-static double parseDouble( FILE_LINE_READER& aReader, const char* aLine,
+static double parseDouble( LINE_READER& aReader, const char* aLine,
                            const char** aOutput = NULL )
 {
     if( !*aLine )
@@ -285,7 +290,7 @@ static double parseDouble( FILE_LINE_READER& aReader, const char* aLine,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the parsed token is not a a single character token.
  */
-static char parseChar( FILE_LINE_READER& aReader, const char* aCurrentToken,
+static char parseChar( LINE_READER& aReader, const char* aCurrentToken,
                        const char** aNextToken = NULL )
 {
     while( *aCurrentToken && isspace( *aCurrentToken ) )
@@ -327,7 +332,7 @@ static char parseChar( FILE_LINE_READER& aReader, const char* aCurrentToken,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the \a aCanBeEmpty is false and no string was parsed.
  */
-static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
+static void parseUnquotedString( wxString& aString, LINE_READER& aReader,
                                  const char* aCurrentToken, const char** aNextToken = NULL,
                                  bool aCanBeEmpty = false )
 {
@@ -391,7 +396,7 @@ static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
  * @throws An #IO_ERROR on an unexpected end of line.
  * @throws A #PARSE_ERROR if the \a aCanBeEmpty is false and no string was parsed.
  */
-static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
+static void parseQuotedString( wxString& aString, LINE_READER& aReader,
                                const char* aCurrentToken, const char** aNextToken = NULL,
                                bool aCanBeEmpty = false )
 {
@@ -493,24 +498,26 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
-    LIB_PART*       loadPart( FILE_LINE_READER& aReader );
-    void            loadHeader( FILE_LINE_READER& aReader );
-    void            loadAliases( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    void            loadField( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    void            loadDrawEntries( std::unique_ptr< LIB_PART >& aPart,
-                                     FILE_LINE_READER&            aReader );
+    LIB_PART*       loadPart( LINE_READER& aReader );
+    void            loadHeader( LINE_READER& aReader );
+    void            loadAliases( std::unique_ptr< LIB_PART >& aPart, LINE_READER& aReader );
+    void            loadField( std::unique_ptr< LIB_PART >& aPart, LINE_READER& aReader );
+    void            loadDrawEntries( LIB_PART* aPart, LINE_READER& aReader );
+    void            deferDrawEntries( LIB_PART* aPart, LINE_READER& aReader );
     void            loadFootprintFilters( std::unique_ptr< LIB_PART >& aPart,
-                                          FILE_LINE_READER&            aReader );
+                                          LINE_READER&                 aReader );
     void            loadDocs();
-    LIB_ARC*        loadArc( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_CIRCLE*     loadCircle( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_TEXT*       loadText( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_RECTANGLE*  loadRectangle( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_PIN*        loadPin( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_POLYLINE*   loadPolyLine( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-    LIB_BEZIER*     loadBezier( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
-
-    FILL_T          parseFillMode( FILE_LINE_READER& aReader, const char* aLine,
+    void            loadIndex( const SYMBOL_LIB_INDEX& aIndex );
+    void            writeIndex( SYMBOL_LIB_INDEX& aIndex, size_t aPartCount );
+    LIB_ARC*        loadArc( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_CIRCLE*     loadCircle( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_TEXT*       loadText( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_RECTANGLE*  loadRectangle( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_PIN*        loadPin( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_POLYLINE*   loadPolyLine( LIB_PART* aPart, LINE_READER& aReader );
+    LIB_BEZIER*     loadBezier( LIB_PART* aPart, LINE_READER& aReader );
+
+    FILL_T          parseFillMode( LINE_READER& aReader, const char* aLine,
                                    const char** aOutput );
     bool            checkForDuplicates( wxString& aAliasName );
     LIB_ALIAS*      removeAlias( LIB_ALIAS* aAlias );
@@ -572,6 +579,7 @@ void SCH_LEGACY_PLUGIN::init( KIWAY* aKiway, const PROPERTIES* aProperties )
 {
     m_version = 0;
     m_rootSheet = NULL;
+    m_fixedOnLoad = false;
     m_props = aProperties;
     m_kiway = aKiway;
     m_cache = NULL;
@@ -621,59 +629,140 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
-
 void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
+    PROF_COUNTER loadTime;
 
-    if( !aSheet->GetScreen() )
+    // The hierarchy is loaded one level at a time: the files of the sheets found in the
+    // files of a level are independent, and loaded in parallel.  Each file is loaded in
+    // its own SCH_SCREEN, which is linked to its sheet before the next level is searched
+    // so files used by several sheets are only loaded once.
+    struct SHEET_LOAD
     {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+        SCH_SHEET*          m_sheet;
+        wxString            m_fileName;
+        bool                m_fixed;
+        std::exception_ptr  m_error;
+    };
 
-        if( !fileName.IsAbsolute() )
-            fileName.MakeAbsolute( m_path );
+    std::vector<SCH_SHEET*> sheets( 1, aSheet );
+    unsigned                fileCount = 0;
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    while( !sheets.empty() )
+    {
+        std::vector<SHEET_LOAD> loads;
 
-        if( screen )
+        for( SCH_SHEET* sheet : sheets )
         {
-            aSheet->SetScreen( screen );
+            if( sheet->GetScreen() )
+                continue;
+
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET
+            // object only stores the file name and extension.  Add the project path to the
+            // file name and extension to compare when calling SCH_SHEET::SearchHierarchy().
+            wxFileName  fileName = sheet->GetFileName();
+            SCH_SCREEN* screen = NULL;
+
+            if( !fileName.IsAbsolute() )
+                fileName.MakeAbsolute( m_path );
+
+            m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+
+            if( screen )
+            {
+                sheet->SetScreen( screen );
+
+                // Do not need to load the sub-sheets - this has already been done.
+                continue;
+            }
+
+            sheet->SetScreen( new SCH_SCREEN( m_kiway ) );
+            sheet->GetScreen()->SetFileName( fileName.GetFullPath() );
 
-            // Do not need to load the sub-sheets - this has already been done.
+            loads.push_back( { sheet, fileName.GetFullPath(), false, nullptr } );
         }
-        else
+
+        std::atomic<size_t> nextLoad( 0 );
+
+        auto loader = [&]()
+        {
+            for( size_t i = nextLoad++; i < loads.size(); i = nextLoad++ )
+            {
+                // Each file has its own parser, as the file version is parser state.
+                SCH_LEGACY_PLUGIN parser;
+
+                parser.init( m_kiway, m_props );
+                parser.m_path = m_path;
+
+                try
+                {
+                    parser.loadFile( loads[i].m_fileName, loads[i].m_sheet->GetScreen() );
+                }
+                catch( ... )
+                {
+                    loads[i].m_error = std::current_exception();
+                }
+
+                loads[i].m_fixed = parser.m_fixedOnLoad;
+            }
+        };
+
+        // The C locale needed by the parser is set by Load() before the threads are created.
+        std::vector<std::thread> threads;
+        size_t threadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                               loads.size() );
+
+        for( size_t i = 1; i < threadCount; ++i )
+            threads.push_back( std::thread( loader ) );
+
+        loader();
+
+        for( std::thread& thread : threads )
+            thread.join();
+
+        fileCount += loads.size();
+        sheets.clear();
+
+        for( SHEET_LOAD& load : loads )
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
-            loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
+            // Report the first error, in the hierarchy order.  The screens already loaded
+            // are freed with their sheets.
+            if( load.m_error )
+                std::rethrow_exception( load.m_error );
 
-            EDA_ITEM* item = aSheet->GetScreen()->GetDrawItems();
+            if( load.m_fixed && m_rootSheet->GetScreen() )
+                m_rootSheet->GetScreen()->SetModify();
 
-            while( item )
+            for( EDA_ITEM* item = load.m_sheet->GetScreen()->GetDrawItems(); item;
+                 item = item->Next() )
             {
                 if( item->Type() == SCH_SHEET_T )
                 {
                     SCH_SHEET* sheet = (SCH_SHEET*) item;
 
-                    // Set the parent to aSheet.  This effectively creates a method to find
-                    // the root sheet from any sheet so a pointer to the root sheet does not
-                    // need to be stored globally.  Note: this is not the same as a hierarchy.
-                    // Complex hierarchies can have multiple copies of a sheet.  This only
-                    // provides a simple tree to find the root sheet.
-                    sheet->SetParent( aSheet );
-
-                    // Recursion starts here.
-                    loadHierarchy( sheet );
+                    // Set the parent to the sheet of the file.  This effectively creates a
+                    // method to find the root sheet from any sheet so a pointer to the root
+                    // sheet does not need to be stored globally.  Note: this is not the same
+                    // as a hierarchy.  Complex hierarchies can have multiple copies of a
+                    // sheet.  This only provides a simple tree to find the root sheet.
+                    sheet->SetParent( load.m_sheet );
+                    sheets.push_back( sheet );
                 }
+                else if( item->Type() == SCH_BITMAP_T )
+                {
+                    // wxBitmap is not thread safe, it is built from the decoded image here
+                    BITMAP_BASE* image = ( (SCH_BITMAP*) item )->GetImage();
 
-                item = item->Next();
+                    if( image->GetImageData() )
+                        image->SetBitmap( new wxBitmap( *image->GetImageData() ) );
+                }
             }
         }
     }
+
+    loadTime.Stop();
+    wxLogTrace( traceSchLegacyPlugin, wxT( "Loaded %u schematic files in %.1f ms" ),
+                fileCount, loadTime.msecs() );
 }
 
 
@@ -721,7 +810,7 @@ void SCH_LEGACY_PLUGIN::loadFile( const wxString& aFileName, SCH_SCREEN* aScreen
 }
 
 
-void SCH_LEGACY_PLUGIN::loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen )
+void SCH_LEGACY_PLUGIN::loadHeader( LINE_READER& aReader, SCH_SCREEN* aScreen )
 {
     const char* line = aReader.ReadLine();
 
@@ -759,7 +848,7 @@ void SCH_LEGACY_PLUGIN::loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScre
 }
 
 
-void SCH_LEGACY_PLUGIN::loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen )
+void SCH_LEGACY_PLUGIN::loadPageSettings( LINE_READER& aReader, SCH_SCREEN* aScreen )
 {
     wxASSERT( aScreen != NULL );
 
@@ -863,7 +952,7 @@ void SCH_LEGACY_PLUGIN::loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN*
 }
 
 
-SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
+SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( LINE_READER& aReader )
 {
     std::unique_ptr< SCH_SHEET > sheet( new SCH_SHEET() );
 
@@ -1000,7 +1089,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
 }
 
 
-SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
+SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( LINE_READER& aReader )
 {
     std::unique_ptr< SCH_BITMAP > bitmap( new SCH_BITMAP );
 
@@ -1040,11 +1129,12 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
                 {
                     // all the PNG date is read.
                     // We expect here m_image and m_bitmap are void
+                    // Files are parsed in worker threads: only the image is decoded here,
+                    // the wxBitmap is created by loadHierarchy() on the calling thread.
                     wxImage* image = new wxImage();
                     wxMemoryInputStream istream( stream );
                     image->LoadFile( istream, wxBITMAP_TYPE_PNG );
                     bitmap->GetImage()->SetImage( image );
-                    bitmap->GetImage()->SetBitmap( new wxBitmap( *image ) );
                     break;
                 }
 
@@ -1077,7 +1167,7 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
 }
 
 
-SCH_JUNCTION* SCH_LEGACY_PLUGIN::loadJunction( FILE_LINE_READER& aReader )
+SCH_JUNCTION* SCH_LEGACY_PLUGIN::loadJunction( LINE_READER& aReader )
 {
     std::unique_ptr< SCH_JUNCTION > junction( new SCH_JUNCTION );
 
@@ -1099,7 +1189,7 @@ SCH_JUNCTION* SCH_LEGACY_PLUGIN::loadJunction( FILE_LINE_READER& aReader )
 }
 
 
-SCH_NO_CONNECT* SCH_LEGACY_PLUGIN::loadNoConnect( FILE_LINE_READER& aReader )
+SCH_NO_CONNECT* SCH_LEGACY_PLUGIN::loadNoConnect( LINE_READER& aReader )
 {
     std::unique_ptr< SCH_NO_CONNECT > no_connect( new SCH_NO_CONNECT );
 
@@ -1121,7 +1211,7 @@ SCH_NO_CONNECT* SCH_LEGACY_PLUGIN::loadNoConnect( FILE_LINE_READER& aReader )
 }
 
 
-SCH_LINE* SCH_LEGACY_PLUGIN::loadWire( FILE_LINE_READER& aReader )
+SCH_LINE* SCH_LEGACY_PLUGIN::loadWire( LINE_READER& aReader )
 {
     std::unique_ptr< SCH_LINE > wire( new SCH_LINE );
 
@@ -1213,7 +1303,7 @@ SCH_LINE* SCH_LEGACY_PLUGIN::loadWire( FILE_LINE_READER& aReader )
 }
 
 
-SCH_BUS_ENTRY_BASE* SCH_LEGACY_PLUGIN::loadBusEntry( FILE_LINE_READER& aReader )
+SCH_BUS_ENTRY_BASE* SCH_LEGACY_PLUGIN::loadBusEntry( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -1258,7 +1348,7 @@ SCH_BUS_ENTRY_BASE* SCH_LEGACY_PLUGIN::loadBusEntry( FILE_LINE_READER& aReader )
 }
 
 
-SCH_TEXT* SCH_LEGACY_PLUGIN::loadText( FILE_LINE_READER& aReader )
+SCH_TEXT* SCH_LEGACY_PLUGIN::loadText( LINE_READER& aReader )
 {
     const char*   line = aReader.Line();
 
@@ -1354,7 +1444,7 @@ SCH_TEXT* SCH_LEGACY_PLUGIN::loadText( FILE_LINE_READER& aReader )
 }
 
 
-SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
+SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -1411,9 +1501,9 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
             {
                 unit = 1;
 
-                // Set the file as modified so the user can be warned.
-                if( m_rootSheet && m_rootSheet->GetScreen() )
-                    m_rootSheet->GetScreen()->SetModify();
+                // Set the file as modified so the user can be warned, once it is loaded:
+                // files are loaded in parallel, the root screen cannot be modified here.
+                m_fixedOnLoad = true;
             }
 
             component->SetUnit( unit );
@@ -2244,7 +2334,20 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file '%s'",
                 m_libFileName.GetFullPath() );
 
+    wxFileName docFileName = m_libFileName;
+
+    docFileName.SetExt( DOC_EXT );
+
+    SYMBOL_LIB_INDEX index( m_libFileName.GetFullPath(), docFileName.GetFullPath() );
+
+    if( index.Read() )
+    {
+        loadIndex( index );
+        return;
+    }
+
     FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    size_t           partCount = 0;
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
@@ -2300,7 +2403,7 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         {
             // Read one DEF/ENDDEF part entry from library:
             loadPart( reader );
-
+            partCount++;
         }
     }
 
@@ -2313,6 +2416,120 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 
     if( USE_OLD_DOC_FILE_FORMAT( m_versionMajor, m_versionMinor ) )
         loadDocs();
+
+    writeIndex( index, partCount );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadIndex( const SYMBOL_LIB_INDEX& aIndex )
+{
+    wxString                     source = m_libFileName.GetFullPath();
+    SYMBOL_LIB_INDEX::FILE_STAMP stamp = aIndex.GetLibraryStamp();
+
+    m_versionMajor = aIndex.GetVersionMajor();
+    m_versionMinor = aIndex.GetVersionMinor();
+    m_libType = aIndex.GetLibType();
+
+    for( const SYMBOL_LIB_INDEX::PART& indexed : aIndex.GetParts() )
+    {
+        STRING_LINE_READER reader( indexed.m_definition, source, indexed.m_line - 1 );
+
+        reader.ReadLine();
+
+        LIB_PART* part = loadPart( reader );
+
+        if( indexed.m_drawOffset < 0 )
+            continue;
+
+        // The drawing items are read from the library file the first time they are needed,
+        // as long as the file is the one the index was made from
+        long long drawOffset = indexed.m_drawOffset;
+        unsigned  drawLine = indexed.m_drawLine;
+
+        part->SetDeferredDrawings( [this, source, stamp, drawOffset, drawLine](
+                LIB_PART* aDeferred )
+        {
+            try
+            {
+                if( SYMBOL_LIB_INDEX::GetFileStamp( source ) != stamp )
+                    THROW_IO_ERROR( _( "the library file was modified since it was loaded" ) );
+
+                FILE* fp = wxFopen( source, wxT( "rt" ) );
+
+                if( !fp || fseek( fp, (long) drawOffset, SEEK_SET ) != 0 )
+                {
+                    if( fp )
+                        fclose( fp );
+
+                    THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for "
+                                                         "reading" ), GetChars( source ) ) );
+                }
+
+                FILE_LINE_READER fileReader( fp, source, true, drawLine - 1 );
+
+                fileReader.ReadLine();
+                loadDrawEntries( aDeferred, fileReader );
+            }
+            catch( const IO_ERROR& ioe )
+            {
+                wxLogError( _( "Symbol '%s' failed to load. Error:\n %s" ),
+                            GetChars( aDeferred->GetName() ), GetChars( ioe.What() ) );
+            }
+        } );
+    }
+
+    for( const SYMBOL_LIB_INDEX::ALIAS& indexed : aIndex.GetAliases() )
+    {
+        LIB_ALIAS_MAP::iterator it = m_aliases.find( indexed.m_name );
+
+        if( it == m_aliases.end() )
+            continue;
+
+        it->second->SetDescription( indexed.m_description );
+        it->second->SetKeyWords( indexed.m_keywords );
+        it->second->SetDocFileName( indexed.m_docFileName );
+    }
+
+    ++m_modHash;
+    m_fileModTime = GetLibModificationTime();
+
+    wxLogTrace( traceSchLegacyPlugin, "Loaded %u symbols of '%s' from its index",
+                (unsigned) aIndex.GetParts().size(), GetChars( source ) );
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::writeIndex( SYMBOL_LIB_INDEX& aIndex, size_t aPartCount )
+{
+    try
+    {
+        aIndex.Scan();
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceSchLegacyPlugin, "Cannot index '%s': %s",
+                    GetChars( m_libFileName.GetFullPath() ), GetChars( ioe.What() ) );
+        return;
+    }
+
+    // Both readers must agree on the parts, or the index would not rebuild this library
+    if( aIndex.GetParts().size() != aPartCount )
+        return;
+
+    aIndex.SetVersion( m_versionMajor, m_versionMinor, m_libType );
+
+    for( LIB_ALIAS_MAP::iterator it = m_aliases.begin();  it != m_aliases.end();  ++it )
+    {
+        SYMBOL_LIB_INDEX::ALIAS alias;
+
+        alias.m_name = it->first;
+        alias.m_description = it->second->GetDescription();
+        alias.m_keywords = it->second->GetKeyWords();
+        alias.m_docFileName = it->second->GetDocFileName();
+
+        aIndex.GetAliases().push_back( alias );
+    }
+
+    aIndex.Write();
 }
 
 
@@ -2410,7 +2627,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
+void SCH_LEGACY_PLUGIN_CACHE::loadHeader( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -2432,7 +2649,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
 }
 
 
-LIB_PART* SCH_LEGACY_PLUGIN_CACHE::loadPart( FILE_LINE_READER& aReader )
+LIB_PART* SCH_LEGACY_PLUGIN_CACHE::loadPart( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -2556,7 +2773,7 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::loadPart( FILE_LINE_READER& aReader )
         else if( *line == 'F' )                          // Fields
             loadField( part, aReader );
         else if( strCompare( "DRAW", line, &line ) )     // Drawing objects.
-            loadDrawEntries( part, aReader );
+            deferDrawEntries( part.get(), aReader );
         else if( strCompare( "$FPLIST", line, &line ) )  // Footprint filter list
             loadFootprintFilters( part, aReader );
         else if( strCompare( "ENDDEF", line, &line ) )   // End of part description
@@ -2605,7 +2822,7 @@ bool SCH_LEGACY_PLUGIN_CACHE::checkForDuplicates( wxString& aAliasName )
 
 
 void SCH_LEGACY_PLUGIN_CACHE::loadAliases( std::unique_ptr< LIB_PART >& aPart,
-                                           FILE_LINE_READER&            aReader )
+                                           LINE_READER&                 aReader )
 {
     wxString newAlias;
     const char* line = aReader.Line();
@@ -2628,7 +2845,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadAliases( std::unique_ptr< LIB_PART >& aPart,
 
 
 void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
-                                         FILE_LINE_READER&            aReader )
+                                         LINE_READER&                 aReader )
 {
     const char* line = aReader.Line();
 
@@ -2773,8 +2990,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr< LIB_PART >& aPart,
-                                               FILE_LINE_READER&            aReader )
+void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -2834,7 +3050,50 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr< LIB_PART >& aPar
 }
 
 
-FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( FILE_LINE_READER& aReader, const char* aLine,
+void SCH_LEGACY_PLUGIN_CACHE::deferDrawEntries( LIB_PART* aPart, LINE_READER& aReader )
+{
+    // The drawing items are the bulk of a library, but they are only needed once a symbol
+    // is drawn or used in a schematic.  Keep the text of the DRAW section, and parse it the
+    // first time the part needs it.
+    unsigned    firstLine = aReader.LineNumber();
+    std::string text( aReader.Line(), aReader.Length() );
+    const char* line = aReader.ReadLine();
+
+    while( line )
+    {
+        text.append( line, aReader.Length() );
+
+        if( strCompare( "ENDDRAW", line ) )
+        {
+            wxString source = aReader.GetSource();
+
+            aPart->SetDeferredDrawings( [this, text, source, firstLine]( LIB_PART* aDeferred )
+            {
+                STRING_LINE_READER reader( text, source, firstLine - 1 );
+
+                try
+                {
+                    reader.ReadLine();
+                    loadDrawEntries( aDeferred, reader );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    wxLogError( _( "Symbol '%s' failed to load. Error:\n %s" ),
+                                GetChars( aDeferred->GetName() ), GetChars( ioe.What() ) );
+                }
+            } );
+
+            return;
+        }
+
+        line = aReader.ReadLine();
+    }
+
+    SCH_PARSE_ERROR( "file ended prematurely loading component draw element", aReader, line );
+}
+
+
+FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( LINE_READER& aReader, const char* aLine,
                                                const char** aOutput )
 {
     FILL_T mode;
@@ -2861,14 +3120,13 @@ FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( FILE_LINE_READER& aReader, const
 }
 
 
-LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr< LIB_PART >& aPart,
-                                           FILE_LINE_READER&            aReader )
+LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "A", line, &line ), NULL, "Invalid LIB_ARC definition" );
 
-    std::unique_ptr< LIB_ARC > arc( new LIB_ARC( aPart.get() ) );
+    std::unique_ptr< LIB_ARC > arc( new LIB_ARC( aPart ) );
 
     wxPoint center;
 
@@ -2927,14 +3185,13 @@ LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr< LIB_PART >& aPart,
-                                                 FILE_LINE_READER&            aReader )
+LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "C", line, &line ), NULL, "Invalid LIB_CIRCLE definition" );
 
-    std::unique_ptr< LIB_CIRCLE > circle( new LIB_CIRCLE( aPart.get() ) );
+    std::unique_ptr< LIB_CIRCLE > circle( new LIB_CIRCLE( aPart ) );
 
     wxPoint center;
 
@@ -2954,14 +3211,13 @@ LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr< LIB_PART >& aP
 }
 
 
-LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
-                                             FILE_LINE_READER&            aReader )
+LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "T", line, &line ), NULL, "Invalid LIB_TEXT definition" );
 
-    std::unique_ptr< LIB_TEXT > text( new LIB_TEXT( aPart.get() ) );
+    std::unique_ptr< LIB_TEXT > text( new LIB_TEXT( aPart ) );
 
     text->SetTextAngle( (double) parseInt( aReader, line, &line ) );
 
@@ -3061,14 +3317,13 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr< LIB_PART >& aPart,
-                                                       FILE_LINE_READER&            aReader )
+LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "S", line, &line ), NULL, "Invalid LIB_RECTANGLE definition" );
 
-    std::unique_ptr< LIB_RECTANGLE > rectangle( new LIB_RECTANGLE( aPart.get() ) );
+    std::unique_ptr< LIB_RECTANGLE > rectangle( new LIB_RECTANGLE( aPart ) );
 
     wxPoint pos;
 
@@ -3093,14 +3348,13 @@ LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr< LIB_PART
 }
 
 
-LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
-                                           FILE_LINE_READER&            aReader )
+LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "X", line, &line ), NULL, "Invalid LIB_PIN definition" );
 
-    std::unique_ptr< LIB_PIN > pin( new LIB_PIN( aPart.get() ) );
+    std::unique_ptr< LIB_PIN > pin( new LIB_PIN( aPart ) );
 
     wxString name, number;
 
@@ -3280,14 +3534,13 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
 }
 
 
-LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr< LIB_PART >& aPart,
-                                                     FILE_LINE_READER&            aReader )
+LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "P", line, &line ), NULL, "Invalid LIB_POLYLINE definition" );
 
-    std::unique_ptr< LIB_POLYLINE > polyLine( new LIB_POLYLINE( aPart.get() ) );
+    std::unique_ptr< LIB_POLYLINE > polyLine( new LIB_POLYLINE( aPart ) );
 
     int points = parseInt( aReader, line, &line );
     polyLine->SetUnit( parseInt( aReader, line, &line ) );
@@ -3310,14 +3563,13 @@ LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr< LIB_PART >
 }
 
 
-LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( std::unique_ptr< LIB_PART >& aPart,
-                                                 FILE_LINE_READER&            aReader )
+LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( LIB_PART* aPart, LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "B", line, &line ), NULL, "Invalid LIB_BEZIER definition" );
 
-    std::unique_ptr< LIB_BEZIER > bezier( new LIB_BEZIER( aPart.get() ) );
+    std::unique_ptr< LIB_BEZIER > bezier( new LIB_BEZIER( aPart ) );
 
     int points = parseInt( aReader, line, &line );
     bezier->SetUnit( parseInt( aReader, line, &line ) );
@@ -3341,7 +3593,7 @@ LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( std::unique_ptr< LIB_PART >& aP
 
 
 void SCH_LEGACY_PLUGIN_CACHE::loadFootprintFilters( std::unique_ptr< LIB_PART >& aPart,
-                                                    FILE_LINE_READER&            aReader )
+                                                    LINE_READER&                 aReader )
 {
     const char* line = aReader.Line();
 
@@ -3370,6 +3622,10 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // Drawing items not loaded yet may be read from the file about to be overwritten
+    for( LIB_ALIAS_MAP::iterator it = m_aliases.begin();  it != m_aliases.end();  it++ )
+        it->second->GetPart()->ensureDrawings();
+
     std::unique_ptr< FILE_OUTPUTFORMATTER > formatter( new FILE_OUTPUTFORMATTER( m_libFileName.GetFullPath() ) );
     formatter->Print( 0, "%s %d.%d\n", LIBFILE_IDENT, LIB_VERSION_MAJOR, LIB_VERSION_MINOR );
     formatter->Print( 0, "#encoding utf-8\n");
@@ -128,17 +128,17 @@ public:
 
 private:
     void loadHierarchy( SCH_SHEET* aSheet );
-    void loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
-    void loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
+    void loadHeader( LINE_READER& aReader, SCH_SCREEN* aScreen );
+    void loadPageSettings( LINE_READER& aReader, SCH_SCREEN* aScreen );
     void loadFile( const wxString& aFileName, SCH_SCREEN* aScreen );
-    SCH_SHEET* loadSheet( FILE_LINE_READER& aReader );
-    SCH_BITMAP* loadBitmap( FILE_LINE_READER& aReader );
-    SCH_JUNCTION* loadJunction( FILE_LINE_READER& aReader );
-    SCH_NO_CONNECT* loadNoConnect( FILE_LINE_READER& aReader );
-    SCH_LINE* loadWire( FILE_LINE_READER& aReader );
-    SCH_BUS_ENTRY_BASE* loadBusEntry( FILE_LINE_READER& aReader );
-    SCH_TEXT* loadText( FILE_LINE_READER& aReader );
-    SCH_COMPONENT* loadComponent( FILE_LINE_READER& aReader );
+    SCH_SHEET* loadSheet( LINE_READER& aReader );
+    SCH_BITMAP* loadBitmap( LINE_READER& aReader );
+    SCH_JUNCTION* loadJunction( LINE_READER& aReader );
+    SCH_NO_CONNECT* loadNoConnect( LINE_READER& aReader );
+    SCH_LINE* loadWire( LINE_READER& aReader );
+    SCH_BUS_ENTRY_BASE* loadBusEntry( LINE_READER& aReader );
+    SCH_TEXT* loadText( LINE_READER& aReader );
+    SCH_COMPONENT* loadComponent( LINE_READER& aReader );
 
     void saveComponent( SCH_COMPONENT* aComponent );
     void saveField( SCH_FIELD* aField );
@@ -161,6 +161,7 @@ protected:
     const PROPERTIES* m_props;      ///< Passed via Save() or Load(), no ownership, may be NULL.
     KIWAY*            m_kiway;      ///< Required for path to legacy component libraries.
     SCH_SHEET*        m_rootSheet;  ///< The root sheet of the schematic being loaded..
+    bool              m_fixedOnLoad; ///< Set when a file being loaded had to be fixed.
     FILE_OUTPUTFORMATTER* m_out;    ///< The output formatter for saving SCH_SCREEN objects.
     SCH_LEGACY_PLUGIN_CACHE* m_cache;
 
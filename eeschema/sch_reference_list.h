@@ -40,6 +40,7 @@
 #include <sch_text.h>
 
 #include <map>
+#include <set>
 
 class SCH_REFERENCE;
 class SCH_REFERENCE_LIST;
@@ -413,13 +414,11 @@ public:
 
     /**
      * Function GetRefsInUse
-     * adds all the reference designator numbers greater than \a aMinRefId to \a aIdList
-     * skipping the reference at \a aIndex.
-     * @param aIndex = the current component index to use for reference prefix filtering.
-     * @param aIdList = the buffer to fill
-     * @param aMinRefId = the min id value to store. all values < aMinRefId are ignored
+     * fills \a aIdSets with the reference designator numbers in use, for each reference
+     * prefix of the list.  The list is only scanned once, whatever the number of prefixes.
+     * @param aIdSets = the map to fill, by reference prefix (the reference without number)
      */
-    void GetRefsInUse( int aIndex, std::vector< int >& aIdList, int aMinRefId );
+    void GetRefsInUse( std::map< std::string, std::set< int > >& aIdSets ) const;
 
     /**
      * Function GetLastReference
@@ -467,16 +466,15 @@ private:
 
     /**
      * Function CreateFirstFreeRefId
-     * searches for the first free reference number in \a aListId of reference numbers in use.
-     * This function just searches for a hole in a list of incremented numbers, this list must
-     * be sorted by increasing values and each value can be stored only once.  The new value
-     * is added to the list.
-     * @see BuildRefIdInUseList to prepare this list
-     * @param aIdList The buffer that contains the reference numbers in use.
+     * searches for the first free reference number in \a aIdSet of reference numbers in use.
+     * This function just searches for a hole in the set from \a aFirstValue.  The new value
+     * is added to the set.
+     * @see GetRefsInUse to prepare this set
+     * @param aIdSet The set that contains the reference numbers in use.
      * @param aFirstValue The first expected free value
      * @return The first free (not yet used) value.
      */
-    int CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue );
+    int CreateFirstFreeRefId( std::set<int>& aIdSet, int aFirstValue );
 };
 
 #endif    // _SCH_REFERENCE_LIST_H_
@@ -54,6 +54,11 @@
 #include <sch_text.h>
 #include <lib_pin.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
 
@@ -89,10 +94,109 @@ static GRID_TYPE SchematicGridList[] = {
 };
 
 
+/**
+ * Class ITEM_GRID
+ * is a uniform grid of buckets used to find the items near a point or a box without
+ * testing every item of the screen.  An item is stored in every cell covered by the box
+ * it is added with.  Items covering too many cells are kept in a separate list, which is
+ * returned by every query.
+ */
+template <typename T>
+class ITEM_GRID
+{
+public:
+    void Add( const wxPoint& aStart, const wxPoint& aEnd, T aItem )
+    {
+        int x0 = cell( std::min( aStart.x, aEnd.x ) );
+        int x1 = cell( std::max( aStart.x, aEnd.x ) );
+        int y0 = cell( std::min( aStart.y, aEnd.y ) );
+        int y1 = cell( std::max( aStart.y, aEnd.y ) );
+
+        if( (long long) ( x1 - x0 + 1 ) * ( y1 - y0 + 1 ) > MAX_CELLS )
+        {
+            m_large.push_back( aItem );
+            return;
+        }
+
+        for( int x = x0; x <= x1; x++ )
+        {
+            for( int y = y0; y <= y1; y++ )
+                m_cells[ key( x, y ) ].push_back( aItem );
+        }
+    }
+
+    void Add( const wxPoint& aPosition, T aItem )
+    {
+        Add( aPosition, aPosition, aItem );
+    }
+
+    /**
+     * Function Query
+     * appends the items stored in the cells covered by the box from \a aStart to \a aEnd
+     * to \a aItems.  An item covering several of these cells is appended more than once.
+     */
+    void Query( const wxPoint& aStart, const wxPoint& aEnd, std::vector<T>& aItems ) const
+    {
+        int x0 = cell( std::min( aStart.x, aEnd.x ) );
+        int x1 = cell( std::max( aStart.x, aEnd.x ) );
+        int y0 = cell( std::min( aStart.y, aEnd.y ) );
+        int y1 = cell( std::max( aStart.y, aEnd.y ) );
+
+        for( int x = x0; x <= x1; x++ )
+        {
+            for( int y = y0; y <= y1; y++ )
+            {
+                auto it = m_cells.find( key( x, y ) );
+
+                if( it != m_cells.end() )
+                    aItems.insert( aItems.end(), it->second.begin(), it->second.end() );
+            }
+        }
+
+        aItems.insert( aItems.end(), m_large.begin(), m_large.end() );
+    }
+
+    void Query( const wxPoint& aPosition, std::vector<T>& aItems ) const
+    {
+        Query( aPosition, aPosition, aItems );
+    }
+
+private:
+    enum
+    {
+        CELL_SIZE = 500,        ///< in mils, ten times the default grid
+        MAX_CELLS = 256
+    };
+
+    static int cell( int aCoord )
+    {
+        // Round towards negative infinity, so cells do not straddle the axes.
+        return aCoord >= 0 ? aCoord / CELL_SIZE : ( aCoord + 1 ) / CELL_SIZE - 1;
+    }
+
+    static uint64_t key( int aX, int aY )
+    {
+        return ( (uint64_t) (uint32_t) aX << 32 ) | (uint32_t) aY;
+    }
+
+    std::unordered_map<uint64_t, std::vector<T>> m_cells;
+    std::vector<T>                               m_large;
+};
+
+
+/// Sorts \a aIndices and removes the duplicates.
+static void uniqueIndices( std::vector<unsigned>& aIndices )
+{
+    std::sort( aIndices.begin(), aIndices.end() );
+    aIndices.erase( std::unique( aIndices.begin(), aIndices.end() ), aIndices.end() );
+}
+
+
 SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     BASE_SCREEN( SCH_SCREEN_T ),
     KIWAY_HOLDER( aKiway ),
-    m_paper( wxT( "A4" ) )
+    m_paper( wxT( "A4" ) ),
+    m_itemIndexValid( false )
 {
     m_modification_sync = 0;
 
@@ -148,12 +252,15 @@ void SCH_SCREEN::Clear()
 
 void SCH_SCREEN::FreeDrawList()
 {
+    m_itemIndex.Clear();
+    m_itemIndexValid = false;
     m_drawList.DeleteAll();
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
+    m_itemIndex.Remove( aItem );
     m_drawList.Remove( aItem );
 }
 
@@ -176,6 +283,7 @@ void SCH_SCREEN::DeleteItem( SCH_ITEM* aItem )
     }
     else
     {
+        m_itemIndex.Remove( aItem );
         delete m_drawList.Remove( aItem );
     }
 }
@@ -197,9 +305,68 @@ bool SCH_SCREEN::CheckIfOnDrawList( SCH_ITEM* aItem )
 }
 
 
+/**
+ * Function itemIndexBox
+ * returns the box \a aItem is indexed with: its bounding box, grown to include its
+ * connection points and the pins of sheets, which can be outside of it.
+ */
+static EDA_RECT itemIndexBox( SCH_ITEM* aItem )
+{
+    EDA_RECT             box = aItem->GetBoundingBox();
+    std::vector<wxPoint> points;
+
+    box.Normalize();
+    aItem->GetConnectionPoints( points );
+
+    for( const wxPoint& point : points )
+        box.Merge( point );
+
+    if( aItem->Type() == SCH_SHEET_T )
+    {
+        for( SCH_SHEET_PIN& pin : ( (SCH_SHEET*) aItem )->GetPins() )
+            box.Merge( pin.GetBoundingBox() );
+    }
+
+    // The hit tests include the edges of the boxes.
+    box.Inflate( 1 );
+
+    return box;
+}
+
+
+void SCH_SCREEN::queryItems( const EDA_RECT& aArea, std::vector<SCH_ITEM*>& aItems ) const
+{
+    if( !m_itemIndexValid )
+    {
+        m_itemIndex.Clear();
+
+        for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+            m_itemIndex.Insert( item, itemIndexBox( item ) );
+
+        m_itemIndexValid = true;
+    }
+
+    m_itemIndex.Query( aArea, aItems );
+}
+
+
+void SCH_SCREEN::queryItems( const wxPoint& aPosition, int aAccuracy,
+                             std::vector<SCH_ITEM*>& aItems ) const
+{
+    EDA_RECT area( aPosition, wxSize( 0, 0 ) );
+
+    area.Inflate( aAccuracy );
+    queryItems( area, aItems );
+}
+
+
 SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) const
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, aAccuracy, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( item->HitTest( aPosition, aAccuracy ) && (aType == NOT_USED) )
             return item;
@@ -260,6 +427,8 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
             break;
         }
     }
+
+    m_itemIndexValid = false;
 }
 
 
@@ -286,6 +455,7 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
     }
 
     m_drawList.Append( aWireList );
+    m_itemIndexValid = false;
 }
 
 
@@ -294,7 +464,14 @@ void SCH_SCREEN::MarkConnections( SCH_LINE* aSegment )
     wxCHECK_RET( (aSegment) && (aSegment->Type() == SCH_LINE_T),
                  wxT( "Invalid object pointer." ) );
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    // Only the items touching the segment can be connected to its ends.
+    std::vector<SCH_ITEM*> items;
+    wxPoint start = aSegment->GetStartPoint();
+    wxPoint end = aSegment->GetEndPoint();
+
+    queryItems( EDA_RECT( start, wxSize( end.x - start.x, end.y - start.y ) ), items );
+
+    for( SCH_ITEM* item : items )
     {
         if( item->GetFlags() & CANDIDATE )
             continue;
@@ -422,47 +599,110 @@ bool SCH_SCREEN::IsTerminalPoint( const wxPoint& aPosition, int aLayer )
 
 bool SCH_SCREEN::SchematicCleanUp()
 {
-    bool      modified = false;
-
-    for( SCH_ITEM* item = m_drawList.begin() ; item; item = item->Next() )
+    bool                    modified = false;
+    std::vector<SCH_ITEM*>  items;
+    std::vector<bool>       deleted;
+    ITEM_GRID<unsigned>     lineGrid;
+    ITEM_GRID<unsigned>     junctionGrid;
+    std::deque<unsigned>    lines;      // lines still to be tested for overlaps
+    std::vector<unsigned>   candidates;
+
+    // Items are indexed by their position in the draw list, so the first of two duplicate
+    // items is always the one kept.
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( ( item->Type() != SCH_LINE_T ) && ( item->Type() != SCH_JUNCTION_T ) )
-            continue;
-
-        bool restart;
+        if( item->Type() == SCH_LINE_T )
+        {
+            SCH_LINE* line = (SCH_LINE*) item;
 
-        for( SCH_ITEM* testItem = item->Next(); testItem; testItem = restart ? m_drawList.begin() : testItem->Next() )
+            lineGrid.Add( line->GetStartPoint(), line->GetEndPoint(), items.size() );
+            lines.push_back( items.size() );
+        }
+        else if( item->Type() == SCH_JUNCTION_T )
         {
-            restart = false;
+            EDA_RECT bbox = item->GetBoundingBox();
+            SCH_ITEM* kept = NULL;
 
-            if( ( item->Type() == SCH_LINE_T ) && ( testItem->Type() == SCH_LINE_T ) )
-            {
-                SCH_LINE* line = (SCH_LINE*) item;
+            candidates.clear();
+            junctionGrid.Query( bbox.GetOrigin(), bbox.GetEnd(), candidates );
+            uniqueIndices( candidates );
 
-                if( line->MergeOverlap( (SCH_LINE*) testItem ) )
+            for( unsigned ii : candidates )
+            {
+                if( item->HitTest( items[ii]->GetPosition() ) )
                 {
-                    // Keep the current flags, because the deleted segment can be flagged.
-                    item->SetFlags( testItem->GetFlags() );
-                    DeleteItem( testItem );
-                    restart = true;
-                    modified = true;
+                    kept = items[ii];
+                    break;
                 }
             }
-            else if ( ( ( item->Type() == SCH_JUNCTION_T )
-                      && ( testItem->Type() == SCH_JUNCTION_T ) ) && ( testItem != item ) )
+
+            if( kept )
             {
-                if ( testItem->HitTest( item->GetPosition() ) )
-                {
-                    // Keep the current flags, because the deleted segment can be flagged.
-                    item->SetFlags( testItem->GetFlags() );
-                    DeleteItem( testItem );
-                    restart = true;
-                    modified = true;
-                }
+                // Keep the current flags, because the deleted junction can be flagged.
+                kept->SetFlags( item->GetFlags() );
+                items.push_back( item );
+                deleted.push_back( true );
+                continue;
+            }
+
+            junctionGrid.Add( item->GetPosition(), items.size() );
+        }
+        else
+        {
+            continue;
+        }
+
+        items.push_back( item );
+        deleted.push_back( false );
+    }
+
+    while( !lines.empty() )
+    {
+        unsigned index = lines.front();
+        SCH_LINE* line = (SCH_LINE*) items[index];
+
+        lines.pop_front();
+
+        if( deleted[index] )
+            continue;
+
+        candidates.clear();
+        lineGrid.Query( line->GetStartPoint(), line->GetEndPoint(), candidates );
+        uniqueIndices( candidates );
+
+        for( unsigned ii : candidates )
+        {
+            if( ii == index || deleted[ii] )
+                continue;
+
+            if( line->MergeOverlap( (SCH_LINE*) items[ii] ) )
+            {
+                // Keep the current flags, because the deleted segment can be flagged.
+                line->SetFlags( items[ii]->GetFlags() );
+                deleted[ii] = true;
+
+                // The merged line can now overlap other lines: index its new extent
+                // and test it again.
+                lineGrid.Add( line->GetStartPoint(), line->GetEndPoint(), index );
+                lines.push_front( index );
+                break;
             }
         }
     }
 
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+    {
+        if( deleted[ii] )
+        {
+            DeleteItem( items[ii] );
+            modified = true;
+        }
+    }
+
+    // The merged lines are longer
+    if( modified )
+        m_itemIndexValid = false;
+
     TestDanglingEnds();
 
     return modified;
@@ -546,6 +786,9 @@ void SCH_SCREEN::CheckComponentsToPartsLinks()
 
             SCH_COMPONENT::ResolveAll( c, libs );
 
+            // the components change size when they are resolved
+            InvalidateItemIndex();
+
             m_modification_sync = mod_hash;     // note the last mod_hash
         }
     }
@@ -623,11 +866,13 @@ void SCH_SCREEN::ClearDrawingState()
 LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent,
                              bool aEndPointOnly ) const
 {
-    SCH_ITEM*       item;
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, 0, items );
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : items )
     {
         if( item->Type() != SCH_COMPONENT_T )
             continue;
@@ -696,8 +941,11 @@ SCH_SHEET* SCH_SCREEN::GetSheet( const wxString& aName )
 SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 {
     SCH_SHEET_PIN* sheetPin = NULL;
+    std::vector<SCH_ITEM*> items;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPosition, 0, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( item->Type() != SCH_SHEET_T )
             continue;
@@ -715,10 +963,12 @@ SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 
 int SCH_SCREEN::CountConnectedItems( const wxPoint& aPos, bool aTestJunctions ) const
 {
-    SCH_ITEM* item;
     int       count = 0;
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPos, 0, items );
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : items )
     {
         if( item->Type() == SCH_JUNCTION_T  && !aTestJunctions )
             continue;
@@ -841,13 +1091,15 @@ void SCH_SCREEN::SelectBlockItems()
 
 void SCH_SCREEN::addConnectedItemsToBlock( const SCH_ITEM* aItem, const wxPoint& position )
 {
-    SCH_ITEM* item;
     ITEM_PICKER picker;
+    std::vector<SCH_ITEM*> items;
 
     if( aItem->IsUnconnected() )
         return;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( position, 0, items );
+
+    for( SCH_ITEM* item : items )
     {
         bool addinlist = true;
         picker.SetItem( item );
@@ -927,16 +1179,64 @@ int SCH_SCREEN::UpdatePickList()
 
 bool SCH_SCREEN::TestDanglingEnds()
 {
-    SCH_ITEM* item;
     std::vector< DANGLING_END_ITEM > endPoints;
+    std::vector< DANGLING_END_ITEM > nearEndPoints;
+    std::vector< SCH_ITEM* > items;
+    std::vector< unsigned > firstEndPoint;  // index in endPoints of the end points of each item
+    std::vector< unsigned > candidates;
+    ITEM_GRID< unsigned > grid;
     bool hasStateChanged = false;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    {
+        items.push_back( item );
+        firstEndPoint.push_back( endPoints.size() );
         item->GetEndPoints( endPoints );
+    }
+
+    firstEndPoint.push_back( endPoints.size() );
+
+    // Wires and buses are stored in the list as a pair, start and end, and are indexed by
+    // their segment. The other end points are indexed by their position.
+    for( unsigned ii = 0; ii < endPoints.size(); ii++ )
+    {
+        const DANGLING_END_ITEM& endPoint = endPoints[ii];
+
+        if( ( endPoint.GetType() == WIRE_START_END || endPoint.GetType() == BUS_START_END )
+                && ii + 1 < endPoints.size() )
+        {
+            grid.Add( endPoint.GetPosition(), endPoints[ii + 1].GetPosition(), ii );
+            ii++;
+        }
+        else
+        {
+            grid.Add( endPoint.GetPosition(), ii );
+        }
+    }
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    // Each item is only tested against the end points near its own end points, in the
+    // original order so the wire and bus pairs are kept.
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        if( item->IsDanglingStateChanged( endPoints ) )
+        candidates.clear();
+
+        for( unsigned jj = firstEndPoint[ii]; jj < firstEndPoint[ii + 1]; jj++ )
+            grid.Query( endPoints[jj].GetPosition(), candidates );
+
+        uniqueIndices( candidates );
+        nearEndPoints.clear();
+
+        for( unsigned index : candidates )
+        {
+            nearEndPoints.push_back( endPoints[index] );
+
+            if( ( endPoints[index].GetType() == WIRE_START_END
+                    || endPoints[index].GetType() == BUS_START_END )
+                    && index + 1 < endPoints.size() )
+                nearEndPoints.push_back( endPoints[index + 1] );
+        }
+
+        if( items[ii]->IsDanglingStateChanged( nearEndPoints ) )
         {
             hasStateChanged = true;
         }
@@ -951,8 +1251,11 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
     SCH_LINE* segment;
     SCH_LINE* newSegment;
     bool brokenSegments = false;
+    std::vector<SCH_ITEM*> items;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPoint, 0, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( (item->Type() != SCH_LINE_T) || (item->GetLayer() == LAYER_NOTES) )
             continue;
@@ -967,10 +1270,12 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
         newSegment->SetStartPoint( aPoint );
         segment->SetEndPoint( aPoint );
         m_drawList.Insert( newSegment, segment->Next() );
-        item = newSegment;
         brokenSegments = true;
     }
 
+    if( brokenSegments )
+        m_itemIndexValid = false;
+
     return brokenSegments;
 }
 
@@ -1006,7 +1311,11 @@ bool SCH_SCREEN::BreakSegmentsOnJunctions()
 
 int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, 0, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( item->Type() == SCH_LINE_T && item->HitTest( aPosition )
             && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
@@ -1025,7 +1334,11 @@ int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 
 SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, 0, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( (item->Type() == SCH_LINE_T) && item->HitTest( aPosition )
             && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
@@ -1041,7 +1354,11 @@ SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLayer,
                                SCH_LINE_TEST_T aSearchType )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, aAccuracy, items );
+
+    for( SCH_ITEM* item : items )
     {
         if( item->Type() != SCH_LINE_T )
             continue;
@@ -1074,7 +1391,11 @@ SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLay
 
 SCH_TEXT* SCH_SCREEN::GetLabel( const wxPoint& aPosition, int aAccuracy )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    std::vector<SCH_ITEM*> items;
+
+    queryItems( aPosition, aAccuracy, items );
+
+    for( SCH_ITEM* item : items )
     {
         switch( item->Type() )
         {
@@ -1145,6 +1466,7 @@ int SCH_SCREEN::GetConnection( const wxPoint& aPosition, PICKED_ITEMS_LIST& aLis
     SCH_ITEM* item;
     EDA_ITEM* tmp;
     EDA_ITEMS list;
+    std::vector<SCH_ITEM*> items;
 
     // Clear flags member for all items.
     ClearDrawingState();
@@ -1199,20 +1521,26 @@ int SCH_SCREEN::GetConnection( const wxPoint& aPosition, PICKED_ITEMS_LIST& aLis
 
             /* If the wire start point is connected to a wire that was already found
              * and now is not connected, add the wire to the list. */
-            for( tmp = m_drawList.begin(); tmp; tmp = tmp->Next() )
+            tmp = NULL;
+            queryItems( segment->GetStartPoint(), 0, items );
+
+            for( SCH_ITEM* candidate : items )
             {
-                // Ensure tmp is a previously deleted segment:
-                if( ( tmp->GetFlags() & STRUCT_DELETED ) == 0 )
+                // Ensure candidate is a previously deleted segment:
+                if( ( candidate->GetFlags() & STRUCT_DELETED ) == 0 )
                     continue;
 
-                if( tmp->Type() != SCH_LINE_T )
+                if( candidate->Type() != SCH_LINE_T )
                     continue;
 
-                SCH_LINE* testSegment = (SCH_LINE*) tmp;
+                SCH_LINE* testSegment = (SCH_LINE*) candidate;
 
-               // Test for segment connected to the previously deleted segment:
+                // Test for segment connected to the previously deleted segment:
                 if( testSegment->IsEndPoint( segment->GetStartPoint() ) )
+                {
+                    tmp = candidate;
                     break;
+                }
             }
 
             // when tmp != NULL, segment is a new candidate:
@@ -1223,20 +1551,26 @@ int SCH_SCREEN::GetConnection( const wxPoint& aPosition, PICKED_ITEMS_LIST& aLis
 
             /* If the wire end point is connected to a wire that has already been found
              * and now is not connected, add the wire to the list. */
-            for( tmp = m_drawList.begin(); tmp; tmp = tmp->Next() )
+            tmp = NULL;
+            queryItems( segment->GetEndPoint(), 0, items );
+
+            for( SCH_ITEM* candidate : items )
             {
-                // Ensure tmp is a previously deleted segment:
-                if( ( tmp->GetFlags() & STRUCT_DELETED ) == 0 )
+                // Ensure candidate is a previously deleted segment:
+                if( ( candidate->GetFlags() & STRUCT_DELETED ) == 0 )
                     continue;
 
-                if( tmp->Type() != SCH_LINE_T )
+                if( candidate->Type() != SCH_LINE_T )
                     continue;
 
-                SCH_LINE* testSegment = (SCH_LINE*) tmp;
+                SCH_LINE* testSegment = (SCH_LINE*) candidate;
 
                 // Test for segment connected to the previously deleted segment:
                 if( testSegment->IsEndPoint( segment->GetEndPoint() ) )
+                {
+                    tmp = candidate;
                     break;
+                }
             }
 
             // when tmp != NULL, segment is a new candidate:
@@ -709,6 +709,7 @@ static void moveItemWithMouseCursor( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
     cpos -= item->GetStoredPos();
 
     item->SetPosition( cpos );
+    screen->InvalidateItemIndex();
 
     // Draw the item item at it's new position.
     item->SetWireImage();  // While moving, the item may choose to render differently
@@ -760,6 +761,7 @@ static void abortMoveItem( EDA_DRAW_PANEL* aPanel, wxDC* aDC )
         // Never delete existing item, because it can be referenced by an undo/redo command
         // Just restore its data
         currentItem->SwapData( oldItem );
+        screen->InvalidateItemIndex();
 
         // Erase the wire representation before the 'normal' view is drawn.
         if ( item->IsWireImage() )
@@ -368,6 +368,9 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
             break;
         }
     }
+
+    // The restored items can be anywhere on the screen
+    GetScreen()->InvalidateItemIndex();
 }
 
 
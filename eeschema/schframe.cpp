@@ -773,6 +773,9 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetModify();
     GetScreen()->SetSave();
 
+    // Edit dialogs change the items in place
+    GetScreen()->InvalidateItemIndex();
+
     m_foundItems.SetForceSearch();
 
     m_canvas->Refresh();
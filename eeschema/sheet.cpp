@@ -270,7 +270,7 @@ bool SCH_EDIT_FRAME::EditSheet( SCH_SHEET* aSheet, SCH_SHEET_PATH* aHierarchy )
 static void resizeSheetWithMouseCursor( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aPosition,
                                         bool aErase )
 {
-    BASE_SCREEN*   screen = aPanel->GetScreen();
+    SCH_SCREEN*    screen = (SCH_SCREEN*) aPanel->GetScreen();
     SCH_SHEET*     sheet = dynamic_cast<SCH_SHEET*>( screen->GetCurItem() );
 
     if( sheet == nullptr )  // Be sure we are using the right object
@@ -303,6 +303,7 @@ static void resizeSheetWithMouseCursor( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const
     wxPoint grid = aPanel->GetParent()->GetNearestGridPosition(
                     wxPoint( pos.x + width, pos.y + height ) );
     sheet->Resize( wxSize( grid.x - pos.x, grid.y - pos.y ) );
+    screen->InvalidateItemIndex();
 
     sheet->Draw( aPanel, aDC, wxPoint( 0, 0 ), g_XorMode );
 }
@@ -0,0 +1,398 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <symbol_lib_index.h>
+
+#include <common.h>
+#include <dsnlexer.h>
+#include <fctsys.h>
+#include <macros.h>
+#include <richio.h>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/time.h>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+/**
+ * @ingroup trace_env_vars
+ *
+ * Flag to enable symbol library index debug output.
+ */
+static const wxString traceSymbolIndex = wxT( "KICAD_TRACE_SYM_INDEX" );
+
+/// Bump this when the content of the index files changes, old files are then ignored
+static const int SYMBOL_LIB_INDEX_VERSION = 1;
+
+/// Files modified this close to the indexing time (in ns) may be modified again with the same
+/// time stamp, as seen with the resolution of the file system (2 s on FAT)
+static const long long RACY_MOD_TIME = 3000000000LL;
+
+static const KEYWORD empty_keywords[1] = {};
+
+
+/// Reads the next symbol and checks it is \a aText
+static void needSymbol( DSNLEXER& aLexer, const char* aText )
+{
+    aLexer.NeedSYMBOL();
+
+    if( strcmp( aLexer.CurText(), aText ) != 0 )
+        aLexer.Expecting( aText );
+}
+
+
+static long long needNumber( DSNLEXER& aLexer, const char* aExpectation )
+{
+    aLexer.NeedNUMBER( aExpectation );
+
+    return strtoll( aLexer.CurText(), NULL, 10 );
+}
+
+
+/// Reads the next string or symbol and returns it as UTF8 text
+static wxString needText( DSNLEXER& aLexer )
+{
+    aLexer.NeedSYMBOLorNUMBER();
+
+    return aLexer.FromUTF8();
+}
+
+
+/// @return true if the legacy library line \a aLine starts with the keyword \a aKeyword
+static bool isKeyword( const char* aLine, const char* aKeyword )
+{
+    size_t len = strlen( aKeyword );
+
+    return strncmp( aLine, aKeyword, len ) == 0
+           && ( aLine[len] == 0 || isspace( (unsigned char) aLine[len] ) );
+}
+
+
+SYMBOL_LIB_INDEX::SYMBOL_LIB_INDEX( const wxString& aLibraryFileName,
+                                    const wxString& aDocFileName ) :
+    m_libraryFileName( aLibraryFileName ),
+    m_versionMajor( -1 ),
+    m_versionMinor( -1 ),
+    m_libType( 0 )
+{
+    m_libStamp = GetFileStamp( aLibraryFileName );
+    m_docStamp = GetFileStamp( aDocFileName );
+}
+
+
+SYMBOL_LIB_INDEX::FILE_STAMP SYMBOL_LIB_INDEX::GetFileStamp( const wxString& aFileName )
+{
+    FILE_STAMP   stamp = { -1, -1 };
+    wxStructStat stat;
+
+    if( wxStat( aFileName, &stat ) != 0 )
+        return stamp;
+
+#if defined( __WINDOWS__ )
+    // The stat() time only has a 1 s resolution, the file time read by wxWidgets has 1 ms
+    stamp.m_modTime = wxFileName( aFileName ).GetModificationTime().GetValue().GetValue()
+                      * 1000000LL;
+#elif defined( __APPLE__ )
+    stamp.m_modTime = (long long) stat.st_mtimespec.tv_sec * 1000000000LL
+                      + stat.st_mtimespec.tv_nsec;
+#else
+    stamp.m_modTime = (long long) stat.st_mtim.tv_sec * 1000000000LL + stat.st_mtim.tv_nsec;
+#endif
+
+    stamp.m_size = (long long) stat.st_size;
+
+    return stamp;
+}
+
+
+wxString SYMBOL_LIB_INDEX::indexFileName() const
+{
+    // The configuration path only depends on the environment, which is set up once
+    static const wxString indexDir = GetKicadConfigPath() + wxFileName::GetPathSeparator()
+                                     + wxT( "sym-index" );
+
+    // One file per library path, named after the FNV-1a hash of the path.  The path itself
+    // is stored in the file, so a collision only means parsing the library again.
+    std::string path( TO_UTF8( m_libraryFileName ) );
+    uint64_t    hash = 14695981039346656037ULL;
+
+    for( char c : path )
+    {
+        hash ^= (unsigned char) c;
+        hash *= 1099511628211ULL;
+    }
+
+    return indexDir + wxFileName::GetPathSeparator()
+           + wxString::Format( wxT( "%016llx.idx" ), (unsigned long long) hash );
+}
+
+
+bool SYMBOL_LIB_INDEX::Read()
+{
+    wxString fileName = indexFileName();
+
+    m_parts.clear();
+    m_aliases.clear();
+
+    if( m_libStamp.m_size < 0 || !wxFileExists( fileName ) )
+        return false;
+
+    try
+    {
+        FILE_LINE_READER reader( fileName );
+        DSNLEXER         lexer( empty_keywords, 0, &reader );
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "symbol_lib_index" );
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "version" );
+
+        if( needNumber( lexer, "version" ) != SYMBOL_LIB_INDEX_VERSION )
+            return false;
+
+        lexer.NeedRIGHT();
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "library" );
+
+        if( needText( lexer ) != m_libraryFileName )
+            return false;
+
+        lexer.NeedRIGHT();
+
+        // The stamps of the files the index was made from
+        FILE_STAMP libStamp, docStamp;
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "files" );
+        libStamp.m_modTime = needNumber( lexer, "library time" );
+        libStamp.m_size = needNumber( lexer, "library size" );
+        docStamp.m_modTime = needNumber( lexer, "document time" );
+        docStamp.m_size = needNumber( lexer, "document size" );
+        lexer.NeedRIGHT();
+
+        if( libStamp != m_libStamp || docStamp != m_docStamp )
+        {
+            wxLogTrace( traceSymbolIndex, wxT( "Index of '%s' is out of date" ),
+                        GetChars( m_libraryFileName ) );
+            return false;
+        }
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "format" );
+        m_versionMajor = (int) needNumber( lexer, "major version" );
+        m_versionMinor = (int) needNumber( lexer, "minor version" );
+        m_libType = (int) needNumber( lexer, "library type" );
+        lexer.NeedRIGHT();
+
+        for( int token = lexer.NextTok(); token != DSN_RIGHT; token = lexer.NextTok() )
+        {
+            if( token != DSN_LEFT )
+                lexer.Expecting( DSN_LEFT );
+
+            lexer.NeedSYMBOL();
+            std::string item = lexer.CurText();
+
+            if( item == "part" )
+            {
+                PART part;
+
+                part.m_line = (unsigned) needNumber( lexer, "line" );
+                part.m_drawOffset = needNumber( lexer, "drawing offset" );
+                part.m_drawLine = (unsigned) needNumber( lexer, "drawing line" );
+
+                // The definition is kept in the encoding of the library file
+                lexer.NeedSYMBOLorNUMBER();
+                part.m_definition = lexer.CurStr();
+
+                m_parts.push_back( part );
+            }
+            else if( item == "alias" )
+            {
+                ALIAS alias;
+
+                alias.m_name = needText( lexer );
+                alias.m_description = needText( lexer );
+                alias.m_keywords = needText( lexer );
+                alias.m_docFileName = needText( lexer );
+
+                m_aliases.push_back( alias );
+            }
+            else
+            {
+                lexer.Expecting( "part or alias" );
+            }
+
+            lexer.NeedRIGHT();
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceSymbolIndex, wxT( "Ignoring index of '%s': %s" ),
+                    GetChars( m_libraryFileName ), GetChars( ioe.What() ) );
+        m_parts.clear();
+        m_aliases.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void SYMBOL_LIB_INDEX::Scan()
+{
+    m_parts.clear();
+
+    FILE* fp = wxFopen( m_libraryFileName, wxT( "rt" ) );
+
+    if( !fp )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename '%s' for reading" ),
+                                          GetChars( m_libraryFileName ) ) );
+    }
+
+    // The reader reads one character at a time, so ftell() is the start of the next line.
+    // It is only needed where a DRAW line may follow: the drawings are most of the file.
+    FILE_LINE_READER reader( fp, m_libraryFileName );
+    PART*            part = NULL;
+    bool             inDrawings = false;
+    bool             inFootprints = false;
+    long long        lineOffset = -1;
+
+    while( const char* line = reader.ReadLine() )
+    {
+        if( !part )
+        {
+            if( !isKeyword( line, "DEF" ) )
+                continue;
+
+            m_parts.emplace_back();
+            part = &m_parts.back();
+            part->m_line = reader.LineNumber();
+            part->m_drawOffset = -1;
+            part->m_drawLine = 0;
+        }
+        else if( inDrawings )
+        {
+            inDrawings = !isKeyword( line, "ENDDRAW" );
+
+            if( !inDrawings )
+                lineOffset = ftell( fp );
+
+            continue;
+        }
+        else if( inFootprints )
+        {
+            // Footprint filters are free text, which must not be taken for keywords
+            inFootprints = !isKeyword( line, "$ENDFPLIST" );
+        }
+        else if( isKeyword( line, "DRAW" ) )
+        {
+            part->m_drawOffset = lineOffset;
+            part->m_drawLine = reader.LineNumber();
+            inDrawings = true;
+            continue;
+        }
+        else if( isKeyword( line, "$FPLIST" ) )
+        {
+            inFootprints = true;
+        }
+
+        part->m_definition.append( line, reader.Length() );
+
+        if( !inFootprints && isKeyword( line, "ENDDEF" ) )
+            part = NULL;
+        else
+            lineOffset = ftell( fp );
+    }
+}
+
+
+void SYMBOL_LIB_INDEX::Write()
+{
+    long long now = wxGetUTCTimeMillis().GetValue() * 1000000LL;
+
+    // A file modified again with the same size within the resolution of its time stamp
+    // would look unchanged: recent files are not indexed, the next load parses them again
+    if( m_libStamp.m_size < 0 || m_libStamp.m_modTime > now - RACY_MOD_TIME
+            || m_docStamp.m_modTime > now - RACY_MOD_TIME )
+    {
+        return;
+    }
+
+    wxFileName fileName( indexFileName() );
+
+    if( !fileName.DirExists() )
+        fileName.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    // Written to a temporary file first, so other instances never read a partial index
+    wxString tempName = wxFileName::CreateTempFileName( fileName.GetPathWithSep() + wxT( "sym" ) );
+
+    if( tempName.IsEmpty() )
+        return;
+
+    try
+    {
+        FILE_OUTPUTFORMATTER out( tempName );
+
+        out.Print( 0, "(symbol_lib_index (version %d)\n", SYMBOL_LIB_INDEX_VERSION );
+        out.Print( 1, "(library %s)\n", out.Quotew( m_libraryFileName ).c_str() );
+        out.Print( 1, "(files %lld %lld %lld %lld)\n", m_libStamp.m_modTime, m_libStamp.m_size,
+                   m_docStamp.m_modTime, m_docStamp.m_size );
+        out.Print( 1, "(format %d %d %d)\n", m_versionMajor, m_versionMinor, m_libType );
+
+        for( const PART& part : m_parts )
+        {
+            out.Print( 1, "(part %u %lld %u\n", part.m_line, part.m_drawOffset,
+                       part.m_drawLine );
+            out.Print( 2, "%s)\n", out.Quotes( part.m_definition ).c_str() );
+        }
+
+        for( const ALIAS& alias : m_aliases )
+        {
+            out.Print( 1, "(alias %s %s %s %s)\n", out.Quotew( alias.m_name ).c_str(),
+                       out.Quotew( alias.m_description ).c_str(),
+                       out.Quotew( alias.m_keywords ).c_str(),
+                       out.Quotew( alias.m_docFileName ).c_str() );
+        }
+
+        out.Print( 0, ")\n" );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceSymbolIndex, wxT( "Cannot write index of '%s': %s" ),
+                    GetChars( m_libraryFileName ), GetChars( ioe.What() ) );
+        wxRemoveFile( tempName );
+        return;
+    }
+
+    if( !wxRenameFile( tempName, fileName.GetFullPath(), true ) )
+        wxRemoveFile( tempName );
+}
@@ -0,0 +1,153 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SYMBOL_LIB_INDEX_H
+#define SYMBOL_LIB_INDEX_H
+
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class SYMBOL_LIB_INDEX
+ * is a persistent summary of a legacy symbol library: the definition of each part without
+ * its drawing items, the position of the drawing items in the library file, and the
+ * description, keywords and document file of each alias.
+ * <p>
+ * Index files are kept in the user's configuration directory, one per library path.  While
+ * the library file and its document file are unchanged, they let the legacy plugin list the
+ * library, e.g. in the component chooser, without reading either file: the drawing items of
+ * a part are read from the library file the first time they are needed.
+ */
+class SYMBOL_LIB_INDEX
+{
+public:
+    /// Modification time, in ns since the epoch, and size of a file, both -1 if it does
+    /// not exist
+    struct FILE_STAMP
+    {
+        long long   m_modTime;
+        long long   m_size;
+
+        bool operator==( const FILE_STAMP& aOther ) const
+        {
+            return m_modTime == aOther.m_modTime && m_size == aOther.m_size;
+        }
+
+        bool operator!=( const FILE_STAMP& aOther ) const { return !( *this == aOther ); }
+    };
+
+    struct PART
+    {
+        std::string m_definition;       ///< DEF ... ENDDEF lines, without the DRAW section
+        unsigned    m_line;             ///< line number of the DEF line in the library file
+        long long   m_drawOffset;       ///< offset of the DRAW line in the library file, or
+                                        ///< -1 if the part has no drawing items
+        unsigned    m_drawLine;         ///< line number of the DRAW line
+    };
+
+    struct ALIAS
+    {
+        wxString    m_name;
+        wxString    m_description;
+        wxString    m_keywords;
+        wxString    m_docFileName;
+    };
+
+    /**
+     * Constructor SYMBOL_LIB_INDEX
+     * records the current stamps of the library and document files, which the index file
+     * must match to be used.
+     *
+     * @param aLibraryFileName is the full path of the .lib file.
+     * @param aDocFileName is the full path of its .dcm file, which may not exist.
+     */
+    SYMBOL_LIB_INDEX( const wxString& aLibraryFileName, const wxString& aDocFileName );
+
+    /**
+     * Function GetFileStamp
+     * @return the current modification time and size of \a aFileName.
+     */
+    static FILE_STAMP GetFileStamp( const wxString& aFileName );
+
+    /**
+     * Function Read
+     * fills the index with the content of the index file of the library.
+     * @return false if there is no index file, if it is not usable, or if the library or
+     *   document file changed since it was written.
+     */
+    bool Read();
+
+    /**
+     * Function Scan
+     * reads the part definitions and the position of their drawing items from the library
+     * file.  The version and aliases are not read: the plugin sets them once it has loaded
+     * the library.
+     *
+     * @throw IO_ERROR if the library file cannot be read.
+     */
+    void Scan();
+
+    /**
+     * Function Write
+     * saves the index to the index file, unless the library or document file was modified
+     * too recently for its stamp to be trusted.  Failures are only traced: without an index
+     * file, the next load simply parses the library again.
+     */
+    void Write();
+
+    void SetVersion( int aMajor, int aMinor, int aLibType )
+    {
+        m_versionMajor = aMajor;
+        m_versionMinor = aMinor;
+        m_libType = aLibType;
+    }
+
+    int GetVersionMajor() const { return m_versionMajor; }
+    int GetVersionMinor() const { return m_versionMinor; }
+    int GetLibType() const { return m_libType; }
+
+    /// Stamp of the library file when the index was created
+    const FILE_STAMP& GetLibraryStamp() const { return m_libStamp; }
+
+    const std::vector<PART>& GetParts() const { return m_parts; }
+
+    std::vector<ALIAS>& GetAliases() { return m_aliases; }
+
+private:
+    /// Full path of the index file of m_libraryFileName
+    wxString indexFileName() const;
+
+    wxString            m_libraryFileName;
+    FILE_STAMP          m_libStamp;
+    FILE_STAMP          m_docStamp;
+    int                 m_versionMajor;
+    int                 m_versionMinor;
+    int                 m_libType;
+    std::vector<PART>   m_parts;
+    std::vector<ALIAS>  m_aliases;
+};
+
+#endif // SYMBOL_LIB_INDEX_H
@@ -30,12 +30,17 @@
 #define CLASS_PCB_SCREEN_H_
 
 
+#include <algorithm>
+
 #include <class_base_screen.h>
 #include <class_board_item.h>
 
 
 class UNDO_REDO_CONTAINER;
 
+/// Default memory budget of the undo list of a board, in MB
+#define DEFAULT_MAX_UNDO_MEMORY 256
+
 
 /* Handle info to display a board */
 class PCB_SCREEN : public BASE_SCREEN
@@ -84,9 +89,28 @@ public:
     /* full undo redo management : */
 
     // use BASE_SCREEN::ClearUndoRedoList()
-    // use BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aItem )
     // use BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aItem )
 
+    /**
+     * Function PushCommandToUndoList
+     * adds a command to the undo list like BASE_SCREEN::PushCommandToUndoList(), then
+     * deletes the oldest commands while the item copies of the list use more memory than
+     * the budget set by SetMaxUndoMemory().  The last command is always kept.
+     */
+    void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem ) override;
+
+    /**
+     * Function GetUndoRedoMemory
+     * @return an estimate of the memory used by the item copies of the undo and redo
+     * lists, in bytes.
+     */
+    size_t GetUndoRedoMemory() const;
+
+    /// @return the memory budget of the undo list in MB, 0 if there is no limit
+    int GetMaxUndoMemory() const { return m_undoMemoryMax; }
+
+    void SetMaxUndoMemory( int aMegaBytes ) { m_undoMemoryMax = std::max( aMegaBytes, 0 ); }
+
     /**
      * Function ClearUndoORRedoList
      * free the undo or redo list from List element
@@ -100,6 +124,9 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) override;
+
+private:
+    int         m_undoMemoryMax;    ///< memory budget of the undo list in MB, 0 for no limit
 };
 
 #endif  // CLASS_PCB_SCREEN_H_
@@ -224,6 +224,7 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags = wxEXEC_ASYNC,
 
 /**
  * @return an unique time stamp that changes after each call
+ * This function is thread safe.
  */
 time_t GetNewTimeStamp();
 
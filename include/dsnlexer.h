@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of the current line, for errors
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -516,7 +517,9 @@ public:
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        // The lines of some LINE_READERs are not nul terminated (see MEMORY_LINE_READER)
+        curLine.assign( start, limit );
+        return curLine.c_str();
     }
 
     /**
@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __ITEM_RTREE_H
+#define __ITEM_RTREE_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <class_eda_rect.h>
+#include <geometry/rtree.h>
+
+/**
+ * Class ITEM_RTREE
+ * implements an R-tree of the bounding boxes of items (e.g. the items of a schematic
+ * screen or the top level items of a board).
+ * <p>
+ * Each item remembers the box it was inserted with, so it can be removed without a
+ * search of the whole tree, and the order it was inserted in, so the queries return
+ * the items in the order of their list.  Non-owning.
+ * </p>
+ */
+template <class T>
+class ITEM_RTREE : public RTree<T, int, 2, float>
+{
+    typedef RTree<T, int, 2, float> BASE;
+
+public:
+    ITEM_RTREE() :
+        m_count( 0 )
+    {
+    }
+
+    /**
+     * Function Insert()
+     * inserts \a aItem with the bounding box \a aBox.  The items of a list must be
+     * inserted in the order of the list.
+     */
+    void Insert( T aItem, const EDA_RECT& aBox )
+    {
+        ENTRY&  entry   = m_entries[aItem];
+        EDA_RECT box    = aBox;
+
+        box.Normalize();
+
+        entry.m_box = box;
+        entry.m_order = m_count++;
+
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+        BASE::Insert( mmin, mmax, aItem );
+    }
+
+    /**
+     * Function Remove()
+     * removes \a aItem from the tree.  Nothing is done if it is not in the tree.
+     */
+    void Remove( T aItem )
+    {
+        auto it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        const EDA_RECT& box = it->second.m_box;
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+        BASE::Remove( mmin, mmax, aItem );
+        m_entries.erase( it );
+    }
+
+    /**
+     * Function Clear()
+     * removes all the items from the tree.
+     */
+    void Clear()
+    {
+        BASE::RemoveAll();
+        m_entries.clear();
+        m_count = 0;
+    }
+
+    /**
+     * Function Query()
+     * fills \a aItems with the items whose bounding box intersects \a aBounds, in the
+     * order they were inserted in.
+     */
+    void Query( const EDA_RECT& aBounds, std::vector<T>& aItems )
+    {
+        EDA_RECT bounds = aBounds;
+
+        bounds.Normalize();
+
+        const int mmin[2] = { bounds.GetX(), bounds.GetY() };
+        const int mmax[2] = { bounds.GetRight(), bounds.GetBottom() };
+
+        aItems.clear();
+
+        auto visitor = [&aItems]( T aItem ) -> bool
+        {
+            aItems.push_back( aItem );
+            return true;
+        };
+
+        BASE::Search( mmin, mmax, visitor );
+
+        std::sort( aItems.begin(), aItems.end(), [this]( T aLeft, T aRight )
+        {
+            return m_entries[aLeft].m_order < m_entries[aRight].m_order;
+        } );
+    }
+
+private:
+    struct ENTRY
+    {
+        EDA_RECT    m_box;
+        unsigned    m_order;
+    };
+
+    std::unordered_map<T, ENTRY> m_entries;
+    unsigned                     m_count;
+};
+
+#endif // __ITEM_RTREE_H
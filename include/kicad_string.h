@@ -173,6 +173,53 @@ wxString GetIllegalFileNameWxChars();
  */
 bool ReplaceIllegalFileNameChars( std::string* aName, int aReplaceChar = 0 );
 
+/**
+ * Function ParseDouble
+ * converts the beginning of \a aText to a double, like strtod(), but always using '.' as
+ * the decimal separator whatever the current locale is.  It does not need a LOCALE_IO and
+ * can be called from several threads at once.
+ *
+ * Like strtod(), it also reads hexadecimal numbers, infinities and NaNs.
+ *
+ * @param aText is the C string to read the number from.
+ * @param aEnd (if not NULL) receives the address of the first character after the number,
+ *   or \a aText if no number could be read.
+ * @return the number read. errno is set to ERANGE if it does not fit in a double.
+ */
+double ParseDouble( const char* aText, const char** aEnd = NULL );
+
+/**
+ * Function FormatDouble
+ * prints \a aValue like printf( "%.*g", aPrecision, aValue ) does in the "C" locale: the
+ * decimal separator is always a '.', whatever the current locale is.  When
+ * \a aFixedSmallValues is true, the non zero values not bigger than 1e-4 are printed like
+ * "%.*f" instead, without trailing zeros, so they are not written with an exponent.
+ * It does not need a LOCALE_IO and can be called from several threads at once.
+ *
+ * @param aValue is the number to print.
+ * @param aPrecision is the number of significant digits ("%g") or of decimals ("%f").
+ * @param aFixedSmallValues selects the fixed point notation for the small values.
+ * @return the formatted number.
+ */
+std::string FormatDouble( double aValue, int aPrecision = 16, bool aFixedSmallValues = true );
+
+/// Size of the buffer needed by the allocation free version of FormatDouble()
+#define FORMAT_DOUBLE_BUFSIZE   64
+
+/**
+ * Function FormatDouble
+ * is the same as above, but prints into \a aBuffer instead of returning a new string.
+ *
+ * @param aBuffer receives the nul terminated number, and must hold at least
+ *   FORMAT_DOUBLE_BUFSIZE chars.
+ * @param aValue is the number to print.
+ * @param aPrecision is the number of significant digits ("%g") or of decimals ("%f").
+ * @param aFixedSmallValues selects the fixed point notation for the small values.
+ * @return int - the length of the formatted number.
+ */
+int FormatDouble( char* aBuffer, double aValue, int aPrecision = 16,
+                  bool aFixedSmallValues = true );
+
 #ifndef HAVE_STRTOKR
 // common/strtok_r.c optionally:
 extern "C" char* strtok_r( char* str, const char* delim, char** nextp );
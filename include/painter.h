@@ -324,6 +324,16 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function PrepareItem
+     * Computes the parts of an item's geometry that do not depend on the GAL (e.g. polygon
+     * triangulation), so the following Draw() call only has to upload it. It may be called
+     * from several threads at once for different items, so it must not touch the GAL nor
+     * any painter state.
+     * @param aItem is the item that is going to be redrawn.
+     */
+    virtual void PrepareItem( const VIEW_ITEM* aItem ) {}
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
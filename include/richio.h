@@ -268,8 +268,12 @@ public:
      *
      * @param aSource describes the source of aString for error reporting purposes
      *  can be anything meaninful, such as wxT( "clipboard" ).
+     *
+     * @param aStartingLineNumber is the initial line number to report on error, useful
+     *  when aString is an excerpt of a larger source.
      */
-    STRING_LINE_READER( const std::string& aString, const wxString& aSource );
+    STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
 
     /**
      * Constructor STRING_LINE_READER( const STRING_LINE_READER& )
@@ -283,6 +287,71 @@ public:
 };
 
 
+/**
+ * Class MEMORY_LINE_READER
+ * is a LINE_READER that returns the lines of a memory buffer in place, without
+ * copying them.  Unlike the other LINE_READERs, the lines are NOT nul terminated:
+ * Length() must be used to find their end.  This is fine for DSNLEXER, which is
+ * the intended user.  The buffer is not owned and must outlive the reader.
+ */
+class MEMORY_LINE_READER : public LINE_READER
+{
+protected:
+    const char*     m_buffer;
+    size_t          m_size;
+    size_t          m_ndx;
+
+public:
+
+    /**
+     * Constructor MEMORY_LINE_READER
+     *
+     * @param aBuffer is the text to read lines from, separated with '\n' characters.
+     * @param aSize is the number of bytes in aBuffer.
+     * @param aSource describes the source of aBuffer for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     */
+    MEMORY_LINE_READER( const char* aBuffer, size_t aSize, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
+
+    ~MEMORY_LINE_READER();
+
+    char* ReadLine() override;
+};
+
+
+/**
+ * Class MAPPED_FILE_LINE_READER
+ * is a MEMORY_LINE_READER that maps a whole file in memory, so reading a large
+ * file costs neither a read() system call nor a copy per line.
+ */
+class MAPPED_FILE_LINE_READER : public MEMORY_LINE_READER
+{
+#ifdef _WIN32
+    void*   m_file;
+    void*   m_mapping;
+#endif
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     *
+     * @param aFileName is the name of the file to map and to use for error reporting purposes.
+     * @throw IO_ERROR if @a aFileName cannot be opened or mapped.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    ///> Returns the content of the whole file
+    const char* Data() const { return m_buffer; }
+
+    ///> Returns the size of the file
+    size_t Size() const { return m_size; }
+};
+
+
 /**
  * Class INPUTSTREAM_LINE_READER
  * is a LINE_READER that reads from a wxInputStream object.
@@ -329,7 +398,6 @@ class OUTPUTFORMATTER
     std::vector<char>   m_buffer;
     char                quoteChar[2];
 
-    int sprint( const char* fmt, ... );
     int vprint( const char* fmt,  va_list ap );
 
 
@@ -433,6 +501,57 @@ public:
 
      std::string Quotew( const wxString& aWrapee );
 
+    //-----<token functions>----------------------------------------------
+    // These write a single token each, without the format string parsing and the
+    // temporary strings of Print().  They are meant for the bulk of large files, such
+    // as the thousands of points of a zone or the tracks of a board.
+
+    /**
+     * Function Indent
+     * writes the spaces Print() would write before its text for \a aNestLevel.
+     */
+    void Indent( int aNestLevel );
+
+    /**
+     * Function Append
+     * writes \a aText as is.
+     * @throw IO_ERROR, if there is a problem outputting, such as a full disk.
+     */
+    void Append( const char* aText, int aCount )
+    {
+        if( aCount > 0 )
+            write( aText, aCount );
+    }
+
+    void Append( const char* aText )        { Append( aText, (int) strlen( aText ) ); }
+    void Append( const std::string& aText ) { Append( aText.data(), (int) aText.size() ); }
+
+    /**
+     * Function AppendInt
+     * writes \a aValue in decimal, like Print( 0, "%ld", aValue ).
+     */
+    void AppendInt( long aValue );
+
+    /**
+     * Function AppendHex
+     * writes \a aValue in upper case hexadecimal, like Print( 0, "%lX", aValue ).
+     */
+    void AppendHex( unsigned long aValue );
+
+    /**
+     * Function AppendDouble
+     * writes \a aValue with FormatDouble(), so it does not need a LOCALE_IO.
+     */
+    void AppendDouble( double aValue, int aPrecision = 16 );
+
+    /**
+     * Function AppendQuoted
+     * writes \a aText quoted as by Quotew() if it needs to be.
+     */
+    void AppendQuoted( const wxString& aText ) { Append( Quotew( aText ) ); }
+
+    //-----</token functions>---------------------------------------------
+
     //-----</interface functions>-----------------------------------------
 };
 
@@ -142,6 +142,21 @@ public:
         return 0;
     }
 
+    /**
+     * Function ViewAllowsSizeCulling()
+     * Tells if the item may be skipped while drawing when its bounding box covers less
+     * than a pixel (e.g. footprint texts when looking at a whole large board). Items whose
+     * absence would change the look of the board, such as copper, should not allow it:
+     * dense fields of tiny pads or vias would vanish.
+     * @param aLayer: current drawing layer
+     * @return true if the item does not have to be drawn when it is very small on the screen.
+     */
+    virtual bool ViewAllowsSizeCulling( int aLayer ) const
+    {
+        // By default always show the item
+        return false;
+    }
+
 public:
 
     VIEW_ITEM_DATA* viewPrivData() const
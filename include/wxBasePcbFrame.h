@@ -78,6 +78,7 @@ public:
 protected:
     BOARD*              m_Pcb;
     GENERAL_COLLECTOR*  m_Collector;
+    int                 m_undoMemoryMax;    ///< undo memory budget in MB, handed to the screens
     PCB_GENERAL_SETTINGS m_configSettings;
 
     /// Auxiliary tool bar typically shown below the main tool bar at the top of the
@@ -73,6 +73,7 @@ static const wxChar DisplayModuleEdgeEntry[] = wxT( "DiModEd" );
 static const wxChar DisplayModuleTextEntry[] = wxT( "DiModTx" );
 static const wxChar FastGrid1Entry[] = wxT( "FastGrid1" );
 static const wxChar FastGrid2Entry[] = wxT( "FastGrid2" );
+static const wxChar MaxUndoMemoryEntry[] = wxT( "PcbMaxUndoMemory" );
 
 
 BEGIN_EVENT_TABLE( PCB_BASE_FRAME, EDA_DRAW_FRAME )
@@ -109,6 +110,7 @@ PCB_BASE_FRAME::PCB_BASE_FRAME( KIWAY* aKiway, wxWindow* aParent, FRAME_T aFrame
 
     m_FastGrid1           = 0;
     m_FastGrid2           = 0;
+    m_undoMemoryMax       = DEFAULT_MAX_UNDO_MEMORY;
 
     m_auxiliaryToolBar    = NULL;
 
@@ -774,6 +776,8 @@ void PCB_BASE_FRAME::LoadSettings( wxConfigBase* aCfg )
     aCfg->Read( baseCfgName + FastGrid2Entry, &itmp, ( long )0);
     m_FastGrid2 = itmp;
 
+    aCfg->Read( baseCfgName + MaxUndoMemoryEntry, &m_undoMemoryMax, DEFAULT_MAX_UNDO_MEMORY );
+
     aCfg->Read( baseCfgName + DisplayModuleTextEntry, &m_DisplayOptions.m_DisplayModTextFill, true );
 }
 
@@ -794,6 +798,9 @@ void PCB_BASE_FRAME::SaveSettings( wxConfigBase* aCfg )
     aCfg->Write( baseCfgName + DisplayModuleTextEntry, m_DisplayOptions.m_DisplayModTextFill );
     aCfg->Write( baseCfgName + FastGrid1Entry, ( long )m_FastGrid1 );
     aCfg->Write( baseCfgName + FastGrid2Entry, ( long )m_FastGrid2 );
+
+    if( GetScreen() )
+        aCfg->Write( baseCfgName + MaxUndoMemoryEntry, GetScreen()->GetMaxUndoMemory() );
 }
 
 
@@ -802,6 +809,9 @@ void PCB_BASE_FRAME::OnModify()
     GetScreen()->SetModify();
     GetScreen()->SetSave();
 
+    // Items may have been moved or resized
+    GetBoard()->InvalidateItemIndex();
+
     if( IsGalCanvasActive() )
     {
         UpdateStatusBar();
@@ -73,6 +73,89 @@ wxPoint BOARD_ITEM::ZeroOffset( 0, 0 );
 // so dummyColorsSettings provide this default initialization
 static COLORS_DESIGN_SETTINGS dummyColorsSettings( FRAME_PCB );
 
+/// Margin of the boxes of the item index, for the items hit at a distance, like the zone
+/// outlines (see MAX_DIST_IN_MM in class_zone.cpp)
+#define ITEM_INDEX_MARGIN Millimeter2iu( 0.5 )
+
+
+/**
+ * Function itemArea
+ * @return the area where \a aItem, or one of its children, can be hit.  It is larger than
+ * the bounding box of some items.
+ */
+static EDA_RECT itemArea( const BOARD_ITEM* aItem )
+{
+    EDA_RECT area = aItem->GetBoundingBox();
+
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+
+        // The bounding box of a module does not include its user texts
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+            area.Merge( itemArea( item ) );
+
+        break;
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+
+        // A Bezier curve is inside the hull of its control points, which are not in its
+        // bounding box
+        if( segment->GetShape() == S_CURVE )
+        {
+            EDA_RECT hull( segment->GetStart(), wxSize( 0, 0 ) );
+
+            hull.Merge( segment->GetBezControl1() );
+            hull.Merge( segment->GetBezControl2() );
+            hull.Merge( segment->GetEnd() );
+            hull.Inflate( ( segment->GetWidth() + 1 ) / 2 );
+            area.Merge( hull );
+        }
+
+        break;
+    }
+
+    case PCB_DIMENSION_T:
+    {
+        const DIMENSION* dimension = static_cast<const DIMENSION*>( aItem );
+
+        // The bounding box of a dimension has neither the width of its lines nor the
+        // rotation of its text
+        area.Merge( dimension->Text().GetBoundingBox() );
+        area.Inflate( ( dimension->GetWidth() + 1 ) / 2 );
+        break;
+    }
+
+    case PCB_MARKER_T:
+        area.Merge( static_cast<const MARKER_PCB*>( aItem )->GetBoundingBoxMarker() );
+        break;
+
+    default:
+        break;
+    }
+
+    return area;
+}
+
+
+/// @return the box of \a aItem in the item index of a board
+static EDA_RECT itemIndexBox( const BOARD_ITEM* aItem )
+{
+    EDA_RECT box = itemArea( aItem );
+
+    box.Normalize();
+    box.Inflate( ITEM_INDEX_MARGIN );
+
+    return box;
+}
+
+
 BOARD::BOARD() :
     BOARD_ITEM_CONTAINER( (BOARD_ITEM*) NULL, PCB_T ),
         m_paper( PAGE_INFO::A4 ), m_NetInfo( this )
@@ -82,6 +165,7 @@ BOARD::BOARD() :
 
     m_colorsSettings = &dummyColorsSettings;
     m_Status_Pcb    = 0;                    // Status word: bit 1 = calculate.
+    m_itemIndexValid = false;
     m_CurrentZoneContour = NULL;            // This ZONE_CONTAINER handle the
                                             // zone contour currently in progress
 
@@ -824,6 +908,8 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         return;
     }
 
+    bool indexed = isItemIndexSynced();
+
     switch( aBoardItem->Type() )
     {
     case PCB_NETINFO_T:
@@ -897,6 +983,22 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         break;
     }
 
+    // The queries of the item index give the items in the order of their list, so
+    // only the items appended to their list can be inserted in it
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+    {
+        if( indexed && ( aMode == ADD_APPEND || aBoardItem->Type() == PCB_MARKER_T
+                         || aBoardItem->Type() == PCB_ZONE_AREA_T ) )
+        {
+            m_itemIndex.Insert( aBoardItem, itemIndexBox( aBoardItem ) );
+            m_itemIndexCounts = itemListCounts();
+        }
+        else
+        {
+            InvalidateItemIndex();
+        }
+    }
+
     aBoardItem->SetParent( this );
     m_connectivity->Add( aBoardItem );
 }
@@ -907,6 +1009,8 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
     // find these calls and fix them!  Don't send me no stinking' NULL.
     wxASSERT( aBoardItem );
 
+    bool indexed = isItemIndexSynced();
+
     switch( aBoardItem->Type() )
     {
     case PCB_NETINFO_T:
@@ -967,6 +1071,19 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
         wxFAIL_MSG( wxT( "BOARD::Remove() needs more ::Type() support" ) );
     }
 
+    if( aBoardItem->Type() != PCB_NETINFO_T )
+    {
+        if( indexed )
+        {
+            m_itemIndex.Remove( aBoardItem );
+            m_itemIndexCounts = itemListCounts();
+        }
+        else
+        {
+            InvalidateItemIndex();
+        }
+    }
+
     m_connectivity->Remove( aBoardItem );
 }
 
@@ -978,6 +1095,7 @@ void BOARD::DeleteMARKERs()
         delete m_markers[i];
 
     m_markers.clear();
+    InvalidateItemIndex();
 }
 
 
@@ -989,6 +1107,7 @@ void BOARD::DeleteZONEOutlines()
         delete m_ZoneDescriptorList[i];
 
     m_ZoneDescriptorList.clear();
+    InvalidateItemIndex();
 }
 
 
@@ -1123,7 +1242,132 @@ void BOARD::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
 }
 
 
+struct BOARD::ITEM_LISTS
+{
+    std::vector<BOARD_ITEM*> m_modules;
+    std::vector<BOARD_ITEM*> m_drawings;
+    std::vector<BOARD_ITEM*> m_tracks;
+    std::vector<BOARD_ITEM*> m_markers;
+    std::vector<BOARD_ITEM*> m_zoneAreas;
+    std::vector<BOARD_ITEM*> m_zones;
+};
+
+
+/// Visits the items of \a aItems, like EDA_ITEM::IterateForward() visits a list
+static SEARCH_RESULT iterateForward( const std::vector<BOARD_ITEM*>& aItems,
+                                     INSPECTOR inspector, void* testData,
+                                     const KICAD_T scanTypes[] )
+{
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( SEARCH_QUIT == item->Visit( inspector, testData, scanTypes ) )
+            return SEARCH_QUIT;
+    }
+
+    return SEARCH_CONTINUE;
+}
+
+
+std::vector<size_t> BOARD::itemListCounts() const
+{
+    return { m_Modules.GetCount(), m_Drawings.GetCount(), m_Track.GetCount(),
+             m_Zone.GetCount(), m_markers.size(), m_ZoneDescriptorList.size() };
+}
+
+
+bool BOARD::isItemIndexSynced() const
+{
+    // The lists are public, and some code changes them directly: this is detected as
+    // long as the number of items changes
+    return m_itemIndexValid && m_itemIndexCounts == itemListCounts();
+}
+
+
+void BOARD::updateItemIndex()
+{
+    if( isItemIndexSynced() )
+        return;
+
+    m_itemIndex.Clear();
+
+    // The lists are indexed one after the other, in the order of their items
+    for( BOARD_ITEM* item = m_Modules; item; item = item->Next() )
+        m_itemIndex.Insert( item, itemIndexBox( item ) );
+
+    for( BOARD_ITEM* item = m_Drawings; item; item = item->Next() )
+        m_itemIndex.Insert( item, itemIndexBox( item ) );
+
+    for( BOARD_ITEM* item = m_Track; item; item = item->Next() )
+        m_itemIndex.Insert( item, itemIndexBox( item ) );
+
+    for( BOARD_ITEM* item = m_Zone; item; item = item->Next() )
+        m_itemIndex.Insert( item, itemIndexBox( item ) );
+
+    for( MARKER_PCB* marker : m_markers )
+        m_itemIndex.Insert( marker, itemIndexBox( marker ) );
+
+    for( ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+        m_itemIndex.Insert( zone, itemIndexBox( zone ) );
+
+    m_itemIndexCounts = itemListCounts();
+    m_itemIndexValid = true;
+}
+
+
+SEARCH_RESULT BOARD::VisitArea( const EDA_RECT& aArea, INSPECTOR inspector, void* testData,
+                                const KICAD_T scanTypes[] )
+{
+    updateItemIndex();
+
+    std::vector<BOARD_ITEM*> candidates;
+    ITEM_LISTS               items;
+
+    m_itemIndex.Query( aArea, candidates );
+
+    // The candidates are in the order of their list
+    for( BOARD_ITEM* item : candidates )
+    {
+        switch( item->Type() )
+        {
+        case PCB_MODULE_T:
+            items.m_modules.push_back( item );
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            items.m_tracks.push_back( item );
+            break;
+
+        case PCB_MARKER_T:
+            items.m_markers.push_back( item );
+            break;
+
+        case PCB_ZONE_AREA_T:
+            items.m_zoneAreas.push_back( item );
+            break;
+
+        case PCB_ZONE_T:
+            items.m_zones.push_back( item );
+            break;
+
+        default:
+            items.m_drawings.push_back( item );
+            break;
+        }
+    }
+
+    return visit( &items, inspector, testData, scanTypes );
+}
+
+
 SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] )
+{
+    return visit( NULL, inspector, testData, scanTypes );
+}
+
+
+SEARCH_RESULT BOARD::visit( const ITEM_LISTS* aItems, INSPECTOR inspector, void* testData,
+                            const KICAD_T scanTypes[] )
 {
     KICAD_T        stype;
     SEARCH_RESULT  result = SEARCH_CONTINUE;
@@ -1159,7 +1403,10 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
         case PCB_MODULE_EDGE_T:
 
             // this calls MODULE::Visit() on each module.
-            result = IterateForward( m_Modules, inspector, testData, p );
+            if( aItems )
+                result = iterateForward( aItems->m_modules, inspector, testData, p );
+            else
+                result = IterateForward( m_Modules, inspector, testData, p );
 
             // skip over any types handled in the above call.
             for( ; ; )
@@ -1185,7 +1432,10 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
         case PCB_TEXT_T:
         case PCB_DIMENSION_T:
         case PCB_TARGET_T:
-            result = IterateForward( m_Drawings, inspector, testData, p );
+            if( aItems )
+                result = iterateForward( aItems->m_drawings, inspector, testData, p );
+            else
+                result = IterateForward( m_Drawings, inspector, testData, p );
 
             // skip over any types handled in the above call.
             for( ; ; )
@@ -1249,17 +1499,23 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
 
 #else
         case PCB_VIA_T:
-            result = IterateForward( m_Track, inspector, testData, p );
-            ++p;
-            break;
-
         case PCB_TRACE_T:
-            result = IterateForward( m_Track, inspector, testData, p );
+            if( aItems )
+                result = iterateForward( aItems->m_tracks, inspector, testData, p );
+            else
+                result = IterateForward( m_Track, inspector, testData, p );
+
             ++p;
             break;
 #endif
 
         case PCB_MARKER_T:
+            if( aItems )
+            {
+                result = iterateForward( aItems->m_markers, inspector, testData, p );
+                ++p;
+                break;
+            }
 
             // MARKER_PCBS are in the m_markers std::vector
             for( unsigned i = 0; i<m_markers.size(); ++i )
@@ -1274,6 +1530,12 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
             break;
 
         case PCB_ZONE_AREA_T:
+            if( aItems )
+            {
+                result = iterateForward( aItems->m_zoneAreas, inspector, testData, p );
+                ++p;
+                break;
+            }
 
             // PCB_ZONE_AREA_T are in the m_ZoneDescriptorList std::vector
             for( unsigned i = 0; i< m_ZoneDescriptorList.size(); ++i )
@@ -1288,7 +1550,11 @@ SEARCH_RESULT BOARD::Visit( INSPECTOR inspector, void* testData, const KICAD_T s
             break;
 
         case PCB_ZONE_T:
-            result = IterateForward( m_Zone, inspector, testData, p );
+            if( aItems )
+                result = iterateForward( aItems->m_zones, inspector, testData, p );
+            else
+                result = IterateForward( m_Zone, inspector, testData, p );
+
             ++p;
             break;
 
@@ -2313,6 +2579,8 @@ ZONE_CONTAINER* BOARD::InsertArea( int aNetcode, int aAreaIdx, PCB_LAYER_ID aLay
     else
         m_ZoneDescriptorList.push_back( new_area );
 
+    InvalidateItemIndex();
+
     new_area->SetHatchStyle( (ZONE_CONTAINER::HATCH_STYLE) aHatch );
 
     // Add the first corner to the new zone
@@ -44,6 +44,7 @@
 #include <class_zone_settings.h>
 #include <pcb_plot_params.h>
 #include <board_item_container.h>
+#include <geometry/item_rtree.h>
 
 #include <memory>
 
@@ -190,6 +191,11 @@ private:
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
+    /// R-tree of the top level items, used by VisitArea().  Built on demand.
+    ITEM_RTREE<BOARD_ITEM*> m_itemIndex;
+    bool                    m_itemIndexValid;
+    std::vector<size_t>     m_itemIndexCounts;      ///< sizes of the item lists in m_itemIndex
+
     BOARD_DESIGN_SETTINGS   m_designSettings;
     ZONE_SETTINGS           m_zoneSettings;
     COLORS_DESIGN_SETTINGS* m_colorsSettings;
@@ -209,6 +215,30 @@ private:
      */
     void chainMarkedSegments( wxPoint aPosition, const LSET& aLayerSet, TRACKS* aList );
 
+    /// The candidates of VisitArea(), list by list
+    struct ITEM_LISTS;
+
+    /**
+     * Function visit
+     * implements Visit() and VisitArea(): visits the items of \a aItems if it is not
+     * NULL, else all the items of the board.
+     */
+    SEARCH_RESULT visit( const ITEM_LISTS* aItems, INSPECTOR inspector, void* testData,
+                         const KICAD_T scanTypes[] );
+
+    /// @return the sizes of the item lists indexed by m_itemIndex
+    std::vector<size_t> itemListCounts() const;
+
+    /**
+     * Function isItemIndexSynced
+     * @return true if m_itemIndex is valid and the item lists were not changed behind the
+     * back of Add() and Remove() since it was built.
+     */
+    bool isItemIndexSynced() const;
+
+    /// Rebuilds m_itemIndex if it is not synced with the item lists
+    void updateItemIndex();
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) :
@@ -838,6 +868,35 @@ public:
      */
     SEARCH_RESULT Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] ) override;
 
+    /**
+     * Function VisitArea
+     * is like Visit(), but only visits the top level items whose area, children included,
+     * intersects \a aArea.  The items are visited in the same order as Visit() does, so
+     * the collectors searching the items at a position give the same results, without
+     * visiting the whole board.
+     * <p>
+     * The items are found in an R-tree of the board, which is updated by Add() and
+     * Remove(), and rebuilt after InvalidateItemIndex().
+     * </p>
+     * @param aArea is the area of interest.
+     * @param inspector An INSPECTOR instance to use in the inspection.
+     * @param testData Arbitrary data used by the inspector.
+     * @param scanTypes Which KICAD_T types are of interest and the order
+     *  is significant too, terminated by EOT.
+     * @return SEARCH_RESULT - SEARCH_QUIT if the Iterator is to stop the scan,
+     *  else SCAN_CONTINUE, and determined by the inspector.
+     */
+    SEARCH_RESULT VisitArea( const EDA_RECT& aArea, INSPECTOR inspector, void* testData,
+                             const KICAD_T scanTypes[] );
+
+    /**
+     * Function InvalidateItemIndex
+     * must be called when board items are moved, or changed in a way that changes their
+     * area.  The R-tree used by VisitArea() is then rebuilt on the next call.
+     * PCB_BASE_FRAME::OnModify() calls it after each edit.
+     */
+    void InvalidateItemIndex() { m_itemIndexValid = false; }
+
     /**
      * Function FindModuleByReference
      * searches for a MODULE within this board with the given
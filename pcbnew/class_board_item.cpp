@@ -30,6 +30,7 @@
 
 #include <fctsys.h>
 #include <common.h>
+#include <kicad_string.h>
 #include <pcbnew.h>
 #include <wx/debug.h>
 
@@ -91,28 +92,8 @@ std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 {
 #if 1
 
-    char    buf[50];
-    int     len;
-    double  mm = aValue / IU_PER_MM;
-
-    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
-    {
-        len = sprintf( buf, "%.10f", mm );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
-    {
-        len = sprintf( buf, "%.10g", mm );
-    }
-
-    return std::string( buf, len );
+    // FormatDouble() does not depend on the current locale, unlike sprintf()
+    return FormatDouble( aValue / IU_PER_MM, 10 );
 
 #else
 
@@ -170,11 +151,8 @@ std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 
 std::string BOARD_ITEM::FormatAngle( double aAngle )
 {
-    char temp[50];
-
-    int len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
-
-    return std::string( temp, len );
+    // Same as "%.10g", small angles included, but with a '.' in any locale
+    return FormatDouble( aAngle / 10.0, 10, false );
 }
 
 
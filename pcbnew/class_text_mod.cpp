@@ -491,6 +491,13 @@ unsigned int TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+bool TEXTE_MODULE::ViewAllowsSizeCulling( int aLayer ) const
+{
+    // Unreadable texts are not worth a draw call
+    return true;
+}
+
+
 wxString TEXTE_MODULE::GetShownText() const
 {
     /* First order optimization: no % means that no processing is
@@ -49,6 +49,9 @@
 #include <math_for_graphics.h>
 #include <polygon_test_point_inside.h>
 
+#include <cstdint>
+#include <mutex>
+
 
 ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     BOARD_CONNECTED_ITEM( aBoard, PCB_ZONE_AREA_T )
@@ -65,6 +68,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     m_cornerRadius = 0;
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
+    m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     aBoard->GetZoneSettings().ExportSetting( *this );
 }
 
@@ -87,7 +91,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList;    // shared until one of the zones changes
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_isKeepout = aZone.m_isKeepout;
@@ -126,8 +130,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;   // shared until one of the zones changes
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -152,10 +155,10 @@ EDA_ITEM* ZONE_CONTAINER::Clone() const
 
 bool ZONE_CONTAINER::UnFill()
 {
-    bool change = ( !m_FilledPolysList.IsEmpty() ) ||
+    bool change = ( !m_FilledPolysList->IsEmpty() ) ||
                   ( m_FillSegmList.size() > 0 );
 
-    m_FilledPolysList.RemoveAllContours();
+    m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     m_FillSegmList.clear();
     m_IsFilled = false;
 
@@ -423,7 +426,7 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     if( displ_opts->m_DisplayZonesMode == 1 )     // Do not show filled areas
         return;
 
-    if( m_FilledPolysList.IsEmpty() )  // Nothing to draw
+    if( m_FilledPolysList->IsEmpty() )  // Nothing to draw
         return;
 
     BOARD*      brd = GetBoard();
@@ -449,9 +452,9 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     color.a = 0.588;
 
 
-    for ( int ic = 0; ic < m_FilledPolysList.OutlineCount(); ic++ )
+    for ( int ic = 0; ic < m_FilledPolysList->OutlineCount(); ic++ )
     {
-        const SHAPE_LINE_CHAIN& path = m_FilledPolysList.COutline( ic );
+        const SHAPE_LINE_CHAIN& path = m_FilledPolysList->COutline( ic );
 
         CornersBuffer.clear();
 
@@ -809,7 +812,7 @@ int ZONE_CONTAINER::GetClearance( BOARD_CONNECTED_ITEM* aItem ) const
 
 bool ZONE_CONTAINER::HitTestFilledArea( const wxPoint& aRefPos ) const
 {
-    return m_FilledPolysList.Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
+    return m_FilledPolysList->Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
 }
 
 
@@ -887,9 +890,9 @@ void ZONE_CONTAINER::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
     msg.Printf( wxT( "%d" ), (int) m_HatchLines.size() );
     aList.push_back( MSG_PANEL_ITEM( _( "Hatch Lines" ), msg, BLUE ) );
 
-    if( !m_FilledPolysList.IsEmpty() )
+    if( !m_FilledPolysList->IsEmpty() )
     {
-        msg.Printf( wxT( "%d" ), m_FilledPolysList.TotalVertices() );
+        msg.Printf( wxT( "%d" ), m_FilledPolysList->TotalVertices() );
         aList.push_back( MSG_PANEL_ITEM( _( "Corner Count" ), msg, BLUE ) );
     }
 }
@@ -904,7 +907,7 @@ void ZONE_CONTAINER::Move( const wxPoint& offset )
 
     Hatch();
 
-    m_FilledPolysList.Move( VECTOR2I( offset.x, offset.y ) );
+    writableFilledPolysList().Move( VECTOR2I( offset.x, offset.y ) );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
     {
@@ -942,7 +945,7 @@ void ZONE_CONTAINER::Rotate( const wxPoint& centre, double angle )
     Hatch();
 
     /* rotate filled areas: */
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = writableFilledPolysList().Iterate(); ic; ++ic )
         RotatePoint( &ic->x, &ic->y, centre.x, centre.y, angle );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
@@ -983,7 +986,7 @@ void ZONE_CONTAINER::Mirror( const wxPoint& mirror_ref )
 
     Hatch();
 
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = writableFilledPolysList().Iterate(); ic; ++ic )
     {
         int py = mirror_ref.y - ic->y;
         ic->y = py + mirror_ref.y;
@@ -1313,9 +1316,29 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
     std::swap( *((ZONE_CONTAINER*) this), *((ZONE_CONTAINER*) aImage) );
 }
 
+/// Locks of the filled polygons being triangulated: zones copied with their fill share it
+/// (see writableFilledPolysList()), and their views are prepared by several threads at once
+static std::mutex s_triangulationLocks[32];
+
+
 void ZONE_CONTAINER::CacheTriangulation()
 {
-    m_FilledPolysList.CacheTriangulation();
+    // The triangulation is a cache of the polygons, so it is shared along with them.  It is
+    // checked and built under the lock of the polygons, so the zones sharing them build it
+    // once, and never both at the same time.
+    uintptr_t lockIndex = ( (uintptr_t) m_FilledPolysList.get() >> 4 ) % 32;
+    std::lock_guard<std::mutex> lock( s_triangulationLocks[lockIndex] );
+
+    m_FilledPolysList->CacheTriangulation();
+}
+
+
+SHAPE_POLY_SET& ZONE_CONTAINER::writableFilledPolysList()
+{
+    if( m_FilledPolysList.use_count() > 1 )
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( *m_FilledPolysList );
+
+    return *m_FilledPolysList;
 }
 
 bool ZONE_CONTAINER::BuildSmoothedPoly( SHAPE_POLY_SET& aSmoothedPoly ) const
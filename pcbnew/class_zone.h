@@ -31,6 +31,7 @@
 #define CLASS_ZONE_H_
 
 
+#include <memory>
 #include <vector>
 #include <gr_basic.h>
 #include <class_board_item.h>
@@ -520,7 +521,7 @@ public:
      */
     void ClearFilledPolysList()
     {
-        m_FilledPolysList.RemoveAllContours();
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     }
 
    /**
@@ -533,9 +534,14 @@ public:
 
     const SHAPE_POLY_SET& GetFilledPolysList() const
     {
-        return m_FilledPolysList;
+        return *m_FilledPolysList;
     }
 
+    /**
+     * Function CacheTriangulation
+     * triangulates the filled polygons if they changed since the last triangulation.  It can
+     * be called from several threads at once, even for zones sharing their filled polygons.
+     */
     void CacheTriangulation();
 
    /**
@@ -544,7 +550,7 @@ public:
      */
     void SetFilledPolysList( SHAPE_POLY_SET& aPolysList )
     {
-        m_FilledPolysList = aPolysList;
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( aPolysList );
     }
 
     /**
@@ -666,6 +672,12 @@ public:
     virtual void SwapData( BOARD_ITEM* aImage ) override;
 
 private:
+    /**
+     * Function writableFilledPolysList
+     * @return the filled polygons, to change them.  They are copied first if they are
+     * shared with another zone.
+     */
+    SHAPE_POLY_SET& writableFilledPolysList();
 
     SHAPE_POLY_SET*       m_Poly;                ///< Outline of the zone.
     int                   m_cornerSmoothingType;
@@ -730,8 +742,10 @@ private:
      * a polygon equivalent to m_Poly, without holes but with extra outline segment
      * connecting "holes" with external main outline.  In complex cases an outline
      * described by m_Poly can have many filled areas
+     * The copies of a zone, like the ones of the undo list, share its filled polygons
+     * until one of them is changed: see writableFilledPolysList().
      */
-    SHAPE_POLY_SET        m_FilledPolysList;
+    std::shared_ptr<SHAPE_POLY_SET> m_FilledPolysList;
     SHAPE_POLY_SET        m_RawPolysList;
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
@@ -25,6 +25,7 @@
 #include <collectors.h>
 #include <class_board_item.h>             // class BOARD_ITEM
 
+#include <class_board.h>
 #include <class_module.h>
 #include <class_pad.h>
 #include <class_track.h>
@@ -447,7 +448,17 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    // On a board, only the items whose area contains the reference position can be hit:
+    // the other ones are not visited
+    if( aItem->Type() == PCB_T )
+    {
+        static_cast<BOARD*>( aItem )->VisitArea( EDA_RECT( aRefPos, wxSize( 0, 0 ) ),
+                                                 m_inspector, NULL, m_ScanTypes );
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     SetTimeNow();               // when snapshot was taken
 
@@ -73,6 +73,10 @@ void DIALOG_GENERALOPTIONS::init()
     timevalue << GetParent()->GetAutoSaveInterval() / 60;
     m_SaveTime->SetValue( timevalue );
 
+    m_MaxUndoMemory->SetValue( GetParent()->GetScreen()->GetMaxUndoMemory() );
+    m_UndoMemoryUsed->SetLabel( wxString::Format( wxT( "%.1f MB" ),
+                                GetParent()->GetScreen()->GetUndoRedoMemory() / 1048576.0 ) );
+
     m_DrcOn->SetValue( GetParent()->Settings().m_legacyDrcOn );
     m_ShowGlobalRatsnest->SetValue( m_Board->IsElementVisible( LAYER_RATSNEST ) );
     m_TrackAutodel->SetValue( GetParent()->Settings().m_legacyAutoDeleteOldTrack );
@@ -107,6 +111,7 @@ void DIALOG_GENERALOPTIONS::OnOkClick( wxCommandEvent& event )
         GetParent()->ReCreateAuxiliaryToolbar();
 
     GetParent()->SetAutoSaveInterval( m_SaveTime->GetValue() * 60 );
+    GetParent()->GetScreen()->SetMaxUndoMemory( m_MaxUndoMemory->GetValue() );
     GetParent()->SetRotationAngle( wxRound( 10.0 * wxAtof( m_RotationAngle->GetValue() ) ) );
 
     /* Updating the combobox to display the active layer. */
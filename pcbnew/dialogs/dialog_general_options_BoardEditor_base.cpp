@@ -67,6 +67,23 @@ DIALOG_GENERALOPTIONS_BOARDEDITOR_BASE::DIALOG_GENERALOPTIONS_BOARDEDITOR_BASE(
 	
 	fgSizer1->Add( m_RotationAngle, 0, wxALIGN_CENTER_VERTICAL|wxALL|wxEXPAND, 5 );
 	
+	m_staticTextUndoMemory = new wxStaticText( this, wxID_ANY, _("&Undo memory (MB):"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticTextUndoMemory->Wrap( -1 );
+	fgSizer1->Add( m_staticTextUndoMemory, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+	
+	m_MaxUndoMemory = new wxSpinCtrl( this, wxID_ANY, wxT("0"), wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 4096, 0 );
+	m_MaxUndoMemory->SetToolTip( _("Memory the copies of the undo list may use. The oldest commands are deleted when a new command exceeds it. If set to 0, the memory is not limited.") );
+	
+	fgSizer1->Add( m_MaxUndoMemory, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+	
+	m_staticTextUndoMemoryUsed = new wxStaticText( this, wxID_ANY, _("Undo memory used:"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticTextUndoMemoryUsed->Wrap( -1 );
+	fgSizer1->Add( m_staticTextUndoMemoryUsed, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+	
+	m_UndoMemoryUsed = new wxStaticText( this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, 0 );
+	m_UndoMemoryUsed->Wrap( -1 );
+	fgSizer1->Add( m_UndoMemoryUsed, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+	
 	
 	bMiddleLeftSizer->Add( fgSizer1, 0, wxEXPAND, 5 );
 	
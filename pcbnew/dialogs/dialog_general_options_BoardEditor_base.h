@@ -59,6 +59,10 @@ class DIALOG_GENERALOPTIONS_BOARDEDITOR_BASE : public DIALOG_SHIM
 		wxSpinCtrl* m_SaveTime;
 		wxStaticText* m_staticTextRotationAngle;
 		wxTextCtrl* m_RotationAngle;
+		wxStaticText* m_staticTextUndoMemory;
+		wxSpinCtrl* m_MaxUndoMemory;
+		wxStaticText* m_staticTextUndoMemoryUsed;
+		wxStaticText* m_UndoMemoryUsed;
 		wxCheckBox* m_ShowGlobalRatsnest;
 		wxCheckBox* m_Segments_45_Only_Ctrl;
 		wxCheckBox* m_UseEditKeyForWidth;
@@ -26,6 +26,7 @@
 #include <common.h>
 #include <fctsys.h>
 #include <footprint_info.h>
+#include <fp_lib_index.h>
 #include <fp_lib_table.h>
 #include <html_messagebox.h>
 #include <io_mgr.h>
@@ -103,6 +104,9 @@ void FOOTPRINT_LIST_IMPL::loader_job()
     while( m_queue_in.pop( nickname ) )
     {
         CatchErrors( [this, &nickname]() {
+            if( loadIndexedLib( nickname ) )
+                return;
+
             m_lib_table->PrefetchLib( nickname );
             m_queue_out.push( nickname );
         } );
@@ -121,6 +125,32 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 }
 
 
+bool FOOTPRINT_LIST_IMPL::loadIndexedLib( const wxString& aNickname )
+{
+    const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( aNickname );
+
+    // Other plugins and properties may change what the footprints look like
+    if( row->GetType() != IO_MGR::ShowType( IO_MGR::KICAD_SEXP ) || row->GetProperties() )
+        return false;
+
+    FP_LIB_INDEX index( row->GetFullURI( true ) );
+
+    // Parse errors only leave the faulty footprints out, like the plugin does
+    CatchErrors( [&index]() { index.Update(); } );
+
+    for( const FP_LIB_INDEX::ENTRY& entry : index.GetEntries() )
+    {
+        FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, aNickname, entry.m_name,
+                                                          entry.m_doc, entry.m_keywords,
+                                                          entry.m_padCount,
+                                                          entry.m_uniquePadCount );
+        m_queue_indexed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+    }
+
+    return true;
+}
+
+
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname )
 {
     FOOTPRINT_ASYNC_LOADER loader;
@@ -145,6 +175,7 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_queue_indexed.clear();
 
     if( aNickname )
         m_queue_in.push( *aNickname );
@@ -170,14 +201,24 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     m_threads.clear();
     m_queue_in.clear();
 
-    LOCALE_IO toggle_locale;
+    // Parse the footprints in parallel. The s-expression plugin reads numbers without the
+    // C library, but the other ones still require changing the locale, which is GLOBAL. It is
+    // only threadsafe to construct the LOCALE_IO before the threads are created, destroy it
+    // after they finish, and block the main (GUI) thread while they work. Any deviation from
+    // this will cause nasal demons.
+    std::unique_ptr<LOCALE_IO> toggle_locale;
+    const wxString             sexprType = IO_MGR::ShowType( IO_MGR::KICAD_SEXP );
+
+    for( auto const& nickname : m_lib_table->GetLogicalLibs() )
+    {
+        const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( nickname );
 
-    // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
-    // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
-    // from this will cause nasal demons.
-    //
-    // TODO: blast LOCALE_IO into the sun
+        if( row && row->GetType() != sexprType )
+        {
+            toggle_locale = std::make_unique<LOCALE_IO>();
+            break;
+        }
+    }
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
     std::vector<std::thread>                    threads;
@@ -230,6 +271,9 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     while( queue_parsed.pop( fpi ) )
         m_list.push_back( std::move( fpi ) );
 
+    while( m_queue_indexed.pop( fpi ) )
+        m_list.push_back( std::move( fpi ) );
+
     std::sort( m_list.begin(), m_list.end(),
             []( std::unique_ptr<FOOTPRINT_INFO> const&     lhs,
                     std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool { return *lhs < *rhs; } );
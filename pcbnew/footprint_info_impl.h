@@ -50,6 +50,22 @@ public:
 #endif
     }
 
+    /// Constructor for a footprint whose details are already known, e.g. from FP_LIB_INDEX
+    FOOTPRINT_INFO_IMPL( FOOTPRINT_LIST* aOwner, const wxString& aNickname,
+            const wxString& aFootprintName, const wxString& aDoc, const wxString& aKeywords,
+            int aPadCount, int aUniquePadCount )
+    {
+        m_owner = aOwner;
+        m_loaded = true;
+        m_nickname = aNickname;
+        m_fpname = aFootprintName;
+        m_num = 0;
+        m_pad_count = aPadCount;
+        m_unique_pad_count = aUniquePadCount;
+        m_doc = aDoc;
+        m_keywords = aKeywords;
+    }
+
 protected:
     virtual void load() override;
 };
@@ -61,6 +77,9 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::vector<std::thread> m_threads;
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
+
+    /// footprints of the libraries listed from their FP_LIB_INDEX by loader_job()
+    SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> m_queue_indexed;
     std::atomic_size_t       m_count_finished;
     std::atomic_bool         m_first_to_finish;
 
@@ -83,6 +102,15 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Function loadIndexedLib
+     * lists the footprints of a .pretty library through its FP_LIB_INDEX, without
+     * prefetching the library.
+     *
+     * @return false if the library is not a .pretty directory, and must be prefetched.
+     */
+    bool loadIndexedLib( const wxString& aNickname );
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
@@ -0,0 +1,389 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fp_lib_index.h>
+
+#include <class_module.h>
+#include <common.h>
+#include <dsnlexer.h>
+#include <fctsys.h>
+#include <macros.h>
+#include <pcb_parser.h>
+#include <profile.h>
+#include <richio.h>
+#include <wildcards_and_files_ext.h>
+
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/time.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+
+
+/**
+ * @ingroup trace_env_vars
+ *
+ * Flag to enable footprint library index debug output.
+ */
+static const wxString traceFootprintIndex = wxT( "KICAD_TRACE_FP_INDEX" );
+
+/// Bump this when the content of the index files changes, old files are then ignored
+static const int FP_LIB_INDEX_VERSION = 2;
+
+/// Files modified this close to the indexing time (in ns) may be modified again with the same
+/// time stamp, as seen with the resolution of the file system (2 s on FAT)
+static const long long RACY_MOD_TIME = 3000000000LL;
+
+static const KEYWORD empty_keywords[1] = {};
+
+
+/// Reads the next symbol and checks it is \a aText
+static void needSymbol( DSNLEXER& aLexer, const char* aText )
+{
+    aLexer.NeedSYMBOL();
+
+    if( strcmp( aLexer.CurText(), aText ) != 0 )
+        aLexer.Expecting( aText );
+}
+
+
+static long long needNumber( DSNLEXER& aLexer, const char* aExpectation )
+{
+    aLexer.NeedNUMBER( aExpectation );
+
+    return strtoll( aLexer.CurText(), NULL, 10 );
+}
+
+
+/**
+ * Function modificationTime
+ * @return the modification time of the file \a aFullPath with its status \a aStat, in ns
+ * since the epoch, with the best resolution the system gives.
+ */
+static long long modificationTime( const wxString& aFullPath, const wxStructStat& aStat )
+{
+#if defined( __WINDOWS__ )
+    // The stat() time only has a 1 s resolution, the file time read by wxWidgets has 1 ms
+    (void) aStat;
+    return wxFileName( aFullPath ).GetModificationTime().GetValue().GetValue() * 1000000LL;
+#elif defined( __APPLE__ )
+    (void) aFullPath;
+    return (long long) aStat.st_mtimespec.tv_sec * 1000000000LL + aStat.st_mtimespec.tv_nsec;
+#else
+    (void) aFullPath;
+    return (long long) aStat.st_mtim.tv_sec * 1000000000LL + aStat.st_mtim.tv_nsec;
+#endif
+}
+
+
+FP_LIB_INDEX::FP_LIB_INDEX( const wxString& aLibraryPath ) :
+    m_libraryPath( aLibraryPath ),
+    m_parsedCount( 0 )
+{
+}
+
+
+wxString FP_LIB_INDEX::indexFileName() const
+{
+    // The configuration path only depends on the environment, which is set up once
+    static const wxString indexDir = GetKicadConfigPath() + wxFileName::GetPathSeparator()
+                                     + wxT( "fp-index" );
+
+    // One file per library path, named after the FNV-1a hash of the path.  The path itself
+    // is stored in the file, so a collision only means parsing the library again.
+    wxFileName  libDir( m_libraryPath, wxEmptyString );
+    std::string path( TO_UTF8( libDir.GetPath() ) );
+    uint64_t    hash = 14695981039346656037ULL;
+
+    for( char c : path )
+    {
+        hash ^= (unsigned char) c;
+        hash *= 1099511628211ULL;
+    }
+
+    return indexDir + wxFileName::GetPathSeparator()
+           + wxString::Format( wxT( "%016llx.idx" ), (unsigned long long) hash );
+}
+
+
+bool FP_LIB_INDEX::read()
+{
+    wxString fileName = indexFileName();
+
+    if( !wxFileExists( fileName ) )
+        return false;
+
+    try
+    {
+        MAPPED_FILE_LINE_READER reader( fileName );
+        DSNLEXER                lexer( empty_keywords, 0, &reader );
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "fp_lib_index" );
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "version" );
+
+        if( needNumber( lexer, "version" ) != FP_LIB_INDEX_VERSION )
+            return false;
+
+        lexer.NeedRIGHT();
+
+        lexer.NeedLEFT();
+        needSymbol( lexer, "library" );
+        lexer.NeedSYMBOLorNUMBER();
+
+        if( lexer.FromUTF8() != m_libraryPath )
+            return false;
+
+        lexer.NeedRIGHT();
+
+        for( int token = lexer.NextTok(); token != DSN_RIGHT; token = lexer.NextTok() )
+        {
+            if( token != DSN_LEFT )
+                lexer.Expecting( DSN_LEFT );
+
+            ENTRY entry;
+
+            needSymbol( lexer, "footprint" );
+            lexer.NeedSYMBOLorNUMBER();
+            entry.m_name = lexer.FromUTF8();
+
+            entry.m_modTime = -1;
+            entry.m_size = -1;
+            entry.m_padCount = 0;
+            entry.m_uniquePadCount = 0;
+
+            for( token = lexer.NextTok(); token != DSN_RIGHT; token = lexer.NextTok() )
+            {
+                if( token != DSN_LEFT )
+                    lexer.Expecting( DSN_LEFT );
+
+                lexer.NeedSYMBOL();
+                std::string field = lexer.CurText();
+
+                if( field == "time" )
+                {
+                    entry.m_modTime = needNumber( lexer, "time" );
+                }
+                else if( field == "size" )
+                {
+                    entry.m_size = needNumber( lexer, "size" );
+                }
+                else if( field == "pads" )
+                {
+                    entry.m_padCount = (int) needNumber( lexer, "pad count" );
+                    entry.m_uniquePadCount = (int) needNumber( lexer, "unique pad count" );
+                }
+                else if( field == "descr" )
+                {
+                    lexer.NeedSYMBOLorNUMBER();
+                    entry.m_doc = lexer.FromUTF8();
+                }
+                else if( field == "tags" )
+                {
+                    lexer.NeedSYMBOLorNUMBER();
+                    entry.m_keywords = lexer.FromUTF8();
+                }
+                else
+                {
+                    lexer.Expecting( "time, size, pads, descr or tags" );
+                }
+
+                lexer.NeedRIGHT();
+            }
+
+            m_entries.push_back( entry );
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceFootprintIndex, wxT( "Ignoring index of '%s': %s" ),
+                    GetChars( m_libraryPath ), GetChars( ioe.What() ) );
+        m_entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void FP_LIB_INDEX::write()
+{
+    wxFileName fileName( indexFileName() );
+
+    if( !fileName.DirExists() )
+        fileName.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    // Written to a temporary file first, so other instances never read a partial index
+    wxString tempName = wxFileName::CreateTempFileName( fileName.GetPathWithSep() + wxT( "fp" ) );
+
+    if( tempName.IsEmpty() )
+        return;
+
+    try
+    {
+        FILE_OUTPUTFORMATTER out( tempName );
+
+        out.Print( 0, "(fp_lib_index (version %d)\n", FP_LIB_INDEX_VERSION );
+        out.Print( 1, "(library %s)\n", out.Quotew( m_libraryPath ).c_str() );
+
+        for( const ENTRY& entry : m_entries )
+        {
+            out.Print( 1, "(footprint %s (time %lld) (size %lld) (pads %d %d)\n",
+                       out.Quotew( entry.m_name ).c_str(), entry.m_modTime, entry.m_size,
+                       entry.m_padCount, entry.m_uniquePadCount );
+            out.Print( 2, "(descr %s) (tags %s))\n",
+                       out.Quotew( entry.m_doc ).c_str(),
+                       out.Quotew( entry.m_keywords ).c_str() );
+        }
+
+        out.Print( 0, ")\n" );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( traceFootprintIndex, wxT( "Cannot write index of '%s': %s" ),
+                    GetChars( m_libraryPath ), GetChars( ioe.What() ) );
+        wxRemoveFile( tempName );
+        return;
+    }
+
+    if( !wxRenameFile( tempName, fileName.GetFullPath(), true ) )
+        wxRemoveFile( tempName );
+}
+
+
+void FP_LIB_INDEX::Update()
+{
+    PROF_COUNTER updateTime;
+
+    wxDir dir( m_libraryPath );
+
+    if( !dir.IsOpened() )
+    {
+        wxString msg = wxString::Format(
+                _( "Footprint library path '%s' does not exist" ),
+                GetChars( m_libraryPath ) );
+
+        THROW_IO_ERROR( msg );
+    }
+
+    m_entries.clear();
+    m_parsedCount = 0;
+
+    std::map<wxString, ENTRY> indexed;
+
+    if( read() )
+    {
+        for( ENTRY& entry : m_entries )
+            indexed[entry.m_name] = entry;
+
+        m_entries.clear();
+    }
+
+    // Check the footprint files against the index, and parse the ones that changed
+    wxString    fpFileName;
+    wxString    wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
+    wxString    errors;
+    bool        modified = false;
+    PCB_PARSER  parser;
+    long long   now = wxGetUTCTimeMillis().GetValue() * 1000000LL;
+
+    for( bool found = dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ); found;
+         found = dir.GetNext( &fpFileName ) )
+    {
+        wxFileName  fullPath( m_libraryPath, fpFileName );
+        wxStructStat stat;
+
+        if( wxStat( fullPath.GetFullPath(), &stat ) != 0 )
+            continue;
+
+        ENTRY entry;
+
+        entry.m_name = fullPath.GetName();
+        entry.m_modTime = modificationTime( fullPath.GetFullPath(), stat );
+        entry.m_size = (long long) stat.st_size;
+
+        auto it = indexed.find( entry.m_name );
+
+        if( it != indexed.end() && it->second.m_modTime == entry.m_modTime
+                && it->second.m_size == entry.m_size )
+        {
+            m_entries.push_back( it->second );
+            indexed.erase( it );
+            continue;
+        }
+
+        modified = true;
+
+        try
+        {
+            MAPPED_FILE_LINE_READER reader( fullPath.GetFullPath() );
+
+            parser.SetLineReader( &reader );
+
+            std::unique_ptr<BOARD_ITEM> item( parser.Parse() );
+            MODULE* footprint = dynamic_cast<MODULE*>( item.get() );
+
+            if( !footprint )
+            {
+                THROW_IO_ERROR( wxString::Format( _( "'%s' does not contain a footprint" ),
+                                                  GetChars( fullPath.GetFullPath() ) ) );
+            }
+
+            entry.m_doc = footprint->GetDescription();
+            entry.m_keywords = footprint->GetKeywords();
+            entry.m_padCount = footprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+            entry.m_uniquePadCount = footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+
+            // A file modified again with the same size within the resolution of its time
+            // stamp would look unchanged: a recent file is indexed with no time, so it is
+            // parsed again by the next Update()
+            if( entry.m_modTime > now - RACY_MOD_TIME )
+                entry.m_modTime = -1;
+
+            m_entries.push_back( entry );
+            m_parsedCount++;
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            if( !errors.IsEmpty() )
+                errors += "\n\n";
+
+            errors += ioe.What();
+        }
+    }
+
+    // Entries left in the map are deleted footprints
+    if( modified || !indexed.empty() )
+        write();
+
+    updateTime.Stop();
+    wxLogTrace( traceFootprintIndex, wxT( "Indexed %u footprints of '%s' in %.1f ms, %d parsed" ),
+                (unsigned) m_entries.size(), GetChars( m_libraryPath ), updateTime.msecs(),
+                m_parsedCount );
+
+    if( !errors.IsEmpty() )
+        THROW_IO_ERROR( errors );
+}
@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FP_LIB_INDEX_H
+#define FP_LIB_INDEX_H
+
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class FP_LIB_INDEX
+ * is a persistent summary of a .pretty footprint library: the description, keywords and
+ * pad counts of each footprint, along with the modification time and size of the file it
+ * was read from.
+ * <p>
+ * Index files are kept in the user's configuration directory, one per library path.  They
+ * let FOOTPRINT_LIST_IMPL list a library by checking the footprint files against the
+ * index, and only parsing the footprints added or modified since the index was written.
+ */
+class FP_LIB_INDEX
+{
+public:
+    struct ENTRY
+    {
+        wxString    m_name;             ///< footprint name, the file name without extension
+        long long   m_modTime;          ///< file modification time, in ns since the epoch,
+                                        ///< or -1 if it was too recent to be trusted
+        long long   m_size;             ///< file size in bytes
+        wxString    m_doc;
+        wxString    m_keywords;
+        int         m_padCount;
+        int         m_uniquePadCount;
+    };
+
+    /**
+     * Constructor FP_LIB_INDEX
+     * @param aLibraryPath is the full path of the .pretty directory.
+     */
+    FP_LIB_INDEX( const wxString& aLibraryPath );
+
+    /**
+     * Function Update
+     * reads the index file of the library if there is one, checks it against the footprint
+     * files of the library directory, parses the new and modified ones and writes the index
+     * back if anything changed.
+     * <p>
+     * Footprint files that cannot be parsed are left out of the index, and their errors are
+     * thrown once the other footprints are indexed, so GetEntries() is always usable.
+     *
+     * @throw IO_ERROR if the library directory cannot be read or a footprint file cannot
+     *   be parsed.
+     */
+    void Update();
+
+    /// Footprints of the library, in the directory order
+    const std::vector<ENTRY>& GetEntries() const { return m_entries; }
+
+    /// Number of footprint files parsed by the last Update()
+    int GetParsedCount() const { return m_parsedCount; }
+
+private:
+    /// Full path of the index file of m_libraryPath
+    wxString indexFileName() const;
+
+    /**
+     * Function read
+     * fills m_entries with the content of the index file.
+     * @return false if there is no index file, or if it is not usable.
+     */
+    bool read();
+
+    /**
+     * Function write
+     * saves m_entries to the index file.  Failures are only traced: without an index
+     * file, the next Update() simply parses the library again.
+     */
+    void write();
+
+    wxString            m_libraryPath;
+    std::vector<ENTRY>  m_entries;
+    int                 m_parsedCount;
+};
+
+#endif // FP_LIB_INDEX_H
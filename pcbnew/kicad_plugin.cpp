@@ -47,9 +47,15 @@
 #include <wx/dir.h>
 #include <wx/filename.h>
 #include <wx/wfstream.h>
+#include <wx/thread.h>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <memory.h>
 #include <connectivity_data.h>
+#include <profile.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
 
 using namespace PCB_KEYS_T;
 
@@ -63,6 +69,29 @@ using namespace PCB_KEYS_T;
  */
 static const wxString traceFootprintLibrary = wxT( "KICAD_TRACE_FP_PLUGIN" );
 
+/**
+ * @ingroup trace_env_vars
+ *
+ * Flag to enable KiCad PCB plugin board load and save timing output.
+ */
+static const wxString traceBoardIO = wxT( "KICAD_TRACE_PCB_IO" );
+
+
+///> Writes a length in the same format as FMT_IU, but without the temporary strings.
+///> Used for the items a board has by the thousands: tracks, vias and zone points.
+static void appendIU( OUTPUTFORMATTER* aOut, int aValue )
+{
+    aOut->AppendDouble( aValue / IU_PER_MM, 10 );
+}
+
+
+static void appendIU( OUTPUTFORMATTER* aOut, const wxPoint& aPoint )
+{
+    appendIU( aOut, aPoint.x );
+    aOut->Append( " ", 1 );
+    appendIU( aOut, aPoint.y );
+}
+
 
 ///> Removes empty nets (i.e. with node count equal zero) from net classes
 void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
@@ -293,36 +322,102 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
     {
-        wxString cacheError;
+        // Each footprint file is parsed by one of several workers, then the footprints
+        // are cached and the errors reported in the directory order.
+        struct FP_FILE
+        {
+            wxFileName              m_path;
+            wxString                m_fullPath;
+            std::unique_ptr<MODULE> m_footprint;
+            wxString                m_error;
+            std::exception_ptr      m_exception;    // anything else than an IO_ERROR
+        };
+
+        PROF_COUNTER         loadTime;
+        std::vector<FP_FILE> files;
 
         do
         {
             // prepend the libpath into fullPath
-            wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
+            files.emplace_back();
+            files.back().m_path = wxFileName( m_lib_path.GetPath(), fpFileName );
+            files.back().m_fullPath = files.back().m_path.GetFullPath();
+        } while( dir.GetNext( &fpFileName ) );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER    reader( fullPath.GetFullPath() );
+        std::atomic<size_t> nextFile( 0 );
+
+        auto worker = [&]()
+        {
+            PCB_PARSER parser;
 
-                m_owner->m_parser->SetLineReader( &reader );
+            for( size_t i = nextFile++; i < files.size(); i = nextFile++ )
+            {
+                FP_FILE& file = files[i];
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
+                // Queue I/O errors so only files that fail to parse don't get loaded.
+                try
+                {
+                    MAPPED_FILE_LINE_READER reader( file.m_fullPath );
 
-                // The footprint name is the file name without the extension.
-                wxString    fpName = fullPath.GetName();
+                    parser.SetLineReader( &reader );
 
-                footprint->SetFPID( LIB_ID( fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fullPath ) );
+                    file.m_footprint.reset( (MODULE*) parser.Parse() );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    file.m_error = ioe.What();
+                }
+                catch( ... )
+                {
+                    file.m_exception = std::current_exception();
+                }
             }
-            catch( const IO_ERROR& ioe )
+        };
+
+        // The footprint list loader already enumerates the libraries in a thread per core,
+        // so only the caller on the GUI thread parses the files of a library in parallel.
+        std::vector<std::thread> threads;
+        size_t threadCount = 1;
+
+        if( wxThread::IsMain() )
+            threadCount = std::min<size_t>( std::thread::hardware_concurrency(), files.size() );
+
+        for( size_t i = 1; i < threadCount; ++i )
+            threads.push_back( std::thread( worker ) );
+
+        worker();
+
+        for( auto& thread : threads )
+            thread.join();
+
+        wxString cacheError;
+
+        for( FP_FILE& file : files )
+        {
+            if( file.m_exception )
+                std::rethrow_exception( file.m_exception );
+
+            if( !file.m_error.IsEmpty() )
             {
                 if( !cacheError.IsEmpty() )
                     cacheError += "\n\n";
 
-                cacheError += ioe.What();
+                cacheError += file.m_error;
+                continue;
             }
-        } while( dir.GetNext( &fpFileName ) );
+
+            // The footprint name is the file name without the extension.
+            wxString    fpName = file.m_path.GetName();
+            MODULE*     footprint = file.m_footprint.release();
+
+            footprint->SetFPID( LIB_ID( fpName ) );
+            m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, file.m_path ) );
+        }
+
+        loadTime.Stop();
+        wxLogTrace( traceFootprintLibrary, wxT( "Loaded %u footprints from '%s' in %.1f ms" ),
+                    (unsigned) files.size(), GetChars( m_lib_path.GetPath() ),
+                    loadTime.msecs() );
 
         // Remember the file modification time of library file when the
         // cache snapshot was made, so that in a networked environment we will
@@ -414,7 +509,8 @@ bool FP_CACHE::IsModified( const wxString& aLibPath, const wxString& aFootprintN
 
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+    // Numbers are formatted without the C library, so no LOCALE_IO is needed here
+    PROF_COUNTER saveTime;
 
     init( aProperties );
 
@@ -433,6 +529,10 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     Format( aBoard, 1 );
 
     m_out->Print( 0, ")\n" );
+
+    saveTime.Stop();
+    wxLogTrace( traceBoardIO, wxT( "Saved '%s' (%u tracks and vias, %d zones) in %.1f ms" ),
+                aFileName, aBoard->m_Track.GetCount(), aBoard->GetAreaCount(), saveTime.msecs() );
 }
 
 
@@ -460,8 +560,6 @@ BOARD_ITEM* PCB_IO::Parse( const wxString& aClipboardSourceInput )
 
 void PCB_IO::Format( BOARD_ITEM* aItem, int aNestLevel ) const
 {
-    LOCALE_IO   toggle;     // public API function, perform anything convenient for caller
-
     switch( aItem->Type() )
     {
     case PCB_T:
@@ -870,8 +968,6 @@ void PCB_IO::format( DIMENSION* aDimension, int aNestLevel ) const
 
 void PCB_IO::format( DRAWSEGMENT* aSegment, int aNestLevel ) const
 {
-    unsigned i;
-
     switch( aSegment->GetShape() )
     {
     case S_SEGMENT:  // Line
@@ -900,8 +996,13 @@ void PCB_IO::format( DRAWSEGMENT* aSegment, int aNestLevel ) const
     case S_POLYGON: // Polygon
         m_out->Print( aNestLevel, "(gr_poly (pts" );
 
-        for( i = 0;  i < aSegment->GetPolyPoints().size();  ++i )
-            m_out->Print( 0, " (xy %s)", FMT_IU( aSegment->GetPolyPoints()[i] ).c_str() );
+        // GetPolyPoints() returns a copy, do not call it for each point
+        for( const wxPoint& point : aSegment->GetPolyPoints() )
+        {
+            m_out->Append( " (xy " );
+            appendIU( m_out, point );
+            m_out->Append( ")" );
+        }
 
         m_out->Print( 0, ")" );
         break;
@@ -956,9 +1057,13 @@ void PCB_IO::format( EDGE_MODULE* aModuleDrawing, int aNestLevel ) const
         break;
 
     case S_POLYGON: // Polygon
+    {
+        // GetPolyPoints() returns a copy, do not call it for each point
+        const std::vector<wxPoint> points = aModuleDrawing->GetPolyPoints();
+
         m_out->Print( aNestLevel, "(fp_poly (pts" );
 
-        for( unsigned i = 0;  i < aModuleDrawing->GetPolyPoints().size();  ++i )
+        for( unsigned i = 0;  i < points.size();  ++i )
         {
             int nestLevel = 0;
 
@@ -968,12 +1073,14 @@ void PCB_IO::format( EDGE_MODULE* aModuleDrawing, int aNestLevel ) const
                 m_out->Print( 0, "\n" );
             }
 
-            m_out->Print( nestLevel, "%s(xy %s)",
-                          nestLevel ? "" : " ",
-                          FMT_IU( aModuleDrawing->GetPolyPoints()[i] ).c_str() );
+            m_out->Indent( nestLevel );
+            m_out->Append( nestLevel ? "(xy " : " (xy " );
+            appendIU( m_out, points[i] );
+            m_out->Append( ")" );
         }
         m_out->Print( 0, ")" );
         break;
+    }
 
     case S_CURVE:   // Bezier curve
         m_out->Print( aNestLevel, "(fp_curve (pts (xy %s) (xy %s) (xy %s) (xy %s))",
@@ -1593,7 +1700,8 @@ void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
         wxCHECK_RET( board != 0, wxT( "Via " ) + via->GetSelectMenuText() +
                      wxT( " has no parent." ) );
 
-        m_out->Print( aNestLevel, "(via" );
+        m_out->Indent( aNestLevel );
+        m_out->Append( "(via" );
 
         via->LayerPair( &layer1, &layer2 );
 
@@ -1614,35 +1722,58 @@ void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
             THROW_IO_ERROR( wxString::Format( _( "unknown via type %d"  ), via->GetViaType() ) );
         }
 
-        m_out->Print( 0, " (at %s) (size %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
+        m_out->Append( " (at " );
+        appendIU( m_out, aTrack->GetStart() );
+        m_out->Append( ") (size " );
+        appendIU( m_out, aTrack->GetWidth() );
+        m_out->Append( ")" );
 
         if( via->GetDrill() != UNDEFINED_DRILL_DIAMETER )
-            m_out->Print( 0, " (drill %s)", FMT_IU( via->GetDrill() ).c_str() );
+        {
+            m_out->Append( " (drill " );
+            appendIU( m_out, via->GetDrill() );
+            m_out->Append( ")" );
+        }
 
-        m_out->Print( 0, " (layers %s %s)",
-                      m_out->Quotew( m_board->GetLayerName( layer1 ) ).c_str(),
-                      m_out->Quotew( m_board->GetLayerName( layer2 ) ).c_str() );
+        m_out->Append( " (layers " );
+        m_out->AppendQuoted( m_board->GetLayerName( layer1 ) );
+        m_out->Append( " " );
+        m_out->AppendQuoted( m_board->GetLayerName( layer2 ) );
+        m_out->Append( ")" );
     }
     else
     {
-        m_out->Print( aNestLevel, "(segment (start %s) (end %s) (width %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(), FMT_IU( aTrack->GetEnd() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
-
-        m_out->Print( 0, " (layer %s)", m_out->Quotew( aTrack->GetLayerName() ).c_str() );
+        m_out->Indent( aNestLevel );
+        m_out->Append( "(segment (start " );
+        appendIU( m_out, aTrack->GetStart() );
+        m_out->Append( ") (end " );
+        appendIU( m_out, aTrack->GetEnd() );
+        m_out->Append( ") (width " );
+        appendIU( m_out, aTrack->GetWidth() );
+        m_out->Append( ") (layer " );
+        m_out->AppendQuoted( aTrack->GetLayerName() );
+        m_out->Append( ")" );
     }
 
-    m_out->Print( 0, " (net %d)", m_mapping->Translate( aTrack->GetNetCode() ) );
+    m_out->Append( " (net " );
+    m_out->AppendInt( m_mapping->Translate( aTrack->GetNetCode() ) );
+    m_out->Append( ")" );
 
     if( aTrack->GetTimeStamp() != 0 )
-        m_out->Print( 0, " (tstamp %lX)", (unsigned long)aTrack->GetTimeStamp() );
+    {
+        m_out->Append( " (tstamp " );
+        m_out->AppendHex( (unsigned long) aTrack->GetTimeStamp() );
+        m_out->Append( ")" );
+    }
 
     if( aTrack->GetStatus() != 0 )
-        m_out->Print( 0, " (status %X)", aTrack->GetStatus() );
+    {
+        m_out->Append( " (status " );
+        m_out->AppendHex( (unsigned) aTrack->GetStatus() );
+        m_out->Append( ")" );
+    }
 
-    m_out->Print( 0, ")\n" );
+    m_out->Append( ")\n" );
 }
 
 
@@ -1780,11 +1911,17 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
             }
 
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( iterator->x ).c_str(), FMT_IU( iterator->y ).c_str() );
+            {
+                m_out->Indent( aNestLevel+3 );
+                m_out->Append( "(xy " );
+            }
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( iterator->x ).c_str(), FMT_IU( iterator->y ).c_str() );
+            {
+                m_out->Append( " (xy " );
+            }
+
+            appendIU( m_out, wxPoint( iterator->x, iterator->y ) );
+            m_out->Append( ")" );
 
             if( newLine < 4 )
             {
@@ -1835,11 +1972,17 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
             }
 
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( it->x ).c_str(), FMT_IU( it->y ).c_str() );
+            {
+                m_out->Indent( aNestLevel+3 );
+                m_out->Append( "(xy " );
+            }
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( it->x ) .c_str(), FMT_IU( it->y ).c_str() );
+            {
+                m_out->Append( " (xy " );
+            }
+
+            appendIU( m_out, wxPoint( it->x, it->y ) );
+            m_out->Append( ")" );
 
             if( newLine < 4 )
             {
@@ -1877,9 +2020,12 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( ZONE_SEGMENT_FILL::const_iterator it = segs.begin();  it != segs.end();  ++it )
         {
-            m_out->Print( aNestLevel+2, "(pts (xy %s) (xy %s))\n",
-                          FMT_IU( wxPoint( it->A ) ).c_str(),
-                          FMT_IU( wxPoint( it->B ) ).c_str() );
+            m_out->Indent( aNestLevel+2 );
+            m_out->Append( "(pts (xy " );
+            appendIU( m_out, wxPoint( it->A ) );
+            m_out->Append( ") (xy " );
+            appendIU( m_out, wxPoint( it->B ) );
+            m_out->Append( "))\n" );
         }
 
         m_out->Print( aNestLevel+1, ")\n" );
@@ -1910,18 +2056,20 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    PROF_COUNTER    loadTime;
+
+    // The whole file is mapped at once, so the parser can split it between several threads
+    MAPPED_FILE_LINE_READER file( aFileName );
 
     init( aProperties );
 
-    m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
 
     BOARD* board;
 
     try
     {
-        board = dynamic_cast<BOARD*>( m_parser->Parse() );
+        board = m_parser->ParseBoardParallel( file.Data(), file.Size(), aFileName );
     }
     catch( const FUTURE_FORMAT_ERROR& )
     {
@@ -1936,18 +2084,15 @@ BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPER
             throw;
     }
 
-    if( !board )
-    {
-        // The parser loaded something that was valid, but wasn't a board.
-        THROW_PARSE_ERROR( _( "this file does not contain a PCB" ),
-                m_parser->CurSource(), m_parser->CurLine(),
-                m_parser->CurLineNumber(), m_parser->CurOffset() );
-    }
-
     // Give the filename to the board if it's new
     if( !aAppendToMe )
         board->SetFileName( aFileName );
 
+    loadTime.Stop();
+    wxLogTrace( traceBoardIO, wxT( "Loaded %u bytes from '%s' in %.1f ms (%.1f MB/s)" ),
+                (unsigned) file.Size(), aFileName, loadTime.msecs(),
+                file.Size() / ( 1000.0 * std::max( loadTime.msecs(), 0.001 ) ) );
+
     return board;
 }
 
@@ -1977,7 +2122,6 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                  const wxString&   aLibraryPath,
                                  const PROPERTIES* aProperties )
 {
-    LOCALE_IO     toggle;     // toggles on, then off, the C locale.
     wxDir         dir( aLibraryPath );
 
     if( !dir.IsOpened() )
@@ -2016,8 +2160,6 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
 MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFootprintName,
                                const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath, aFootprintName );
@@ -2039,8 +2181,6 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootprint,
                             const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     // In this public PLUGIN API function, we can safely assume it was
@@ -2110,8 +2250,6 @@ void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootpri
 
 void PCB_IO::FootprintDelete( const wxString& aLibraryPath, const wxString& aFootprintName, const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath );
@@ -2134,8 +2272,6 @@ void PCB_IO::FootprintLibCreate( const wxString& aLibraryPath, const PROPERTIES*
                                           aLibraryPath.GetData() ) );
     }
 
-    LOCALE_IO   toggle;
-
     init( aProperties );
 
     delete m_cache;
@@ -2223,8 +2359,6 @@ bool PCB_IO::FootprintLibDelete( const wxString& aLibraryPath, const PROPERTIES*
 
 bool PCB_IO::IsFootprintLibWritable( const wxString& aLibraryPath )
 {
-    LOCALE_IO   toggle;
-
     init( NULL );
 
     cacheLib( aLibraryPath );
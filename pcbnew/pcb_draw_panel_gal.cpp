@@ -140,12 +140,9 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 {
     m_view->Clear();
 
-    // Load zones
+    // Load zones (their triangulation is computed in parallel by the first view update)
     for( auto zone : aBoard->Zones() )
-    {
-        zone->CacheTriangulation();
         m_view->Add( zone );
-    }
 
     // Load drawings
     for( auto drawing : const_cast<BOARD*>(aBoard)->Drawings() )
@@ -329,6 +329,30 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::PrepareItem( const VIEW_ITEM* aItem )
+{
+    const EDA_ITEM* item = static_cast<const EDA_ITEM*>( aItem );
+
+    switch( item->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+    {
+        // Triangulating the filled areas is by far the most expensive part of drawing a zone.
+        // The zone checks if the triangulation is up to date itself, as its filled areas can
+        // be shared with a zone prepared by another thread.
+        ZONE_CONTAINER* zone = const_cast<ZONE_CONTAINER*>( static_cast<const ZONE_CONTAINER*>( item ) );
+
+        zone->CacheTriangulation();
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -31,6 +31,7 @@
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
+#include <kicad_string.h>
 #include <trigo.h>
 #include <class_title_block.h>
 
@@ -50,6 +51,12 @@
 #include <zones.h>
 #include <pcb_parser.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <thread>
+
 using namespace PCB_KEYS_T;
 
 
@@ -123,11 +130,12 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    // Unlike strtod(), ParseDouble() does not depend on the current locale
+    double fval = ParseDouble( CurText(), &tmp );
 
     if( errno )
     {
@@ -428,7 +436,6 @@ BOARD_ITEM* PCB_PARSER::Parse()
 {
     T               token;
     BOARD_ITEM*     item;
-    LOCALE_IO       toggle;
 
     // MODULEs can be prefixed with an initial block of single line comments and these
     // are kept for Format() so they round trip in s-expression form.  BOARDs might
@@ -569,6 +576,342 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+bool PCB_PARSER::splitBoard( const char* aInput, size_t aSize, std::vector<BOARD_CHUNK>& aChunks )
+{
+    const char* text = aInput;
+    size_t      len = aSize;
+    size_t      pos = 0;
+    unsigned    line = 1;
+    int         depth = 0;
+    bool        lineStart = true;
+    bool        itemFound = false;
+    BOARD_CHUNK chunk;
+
+    // Returns the keyword following the opening parenthesis at aStart
+    auto keyword = [&]( size_t aStart ) -> std::string
+    {
+        size_t first = aStart + 1;
+
+        while( first < len && ( text[first] == ' ' || text[first] == '\t' ) )
+            ++first;
+
+        size_t last = first;
+
+        while( last < len && ( isalnum( (unsigned char) text[last] ) || text[last] == '_' ) )
+            ++last;
+
+        return std::string( text + first, last - first );
+    };
+
+    aChunks.clear();
+
+    while( pos < len )
+    {
+        char c = text[pos];
+
+        if( c == '\n' )
+        {
+            ++line;
+            lineStart = true;
+        }
+        else if( lineStart && c == '#' )
+        {
+            // comment line, skip up to the newline
+            while( pos + 1 < len && text[pos + 1] != '\n' )
+                ++pos;
+        }
+        else if( c == '"' )
+        {
+            lineStart = false;
+
+            for( ++pos; pos < len && text[pos] != '"'; ++pos )
+            {
+                if( text[pos] == '\\' )
+                    ++pos;
+                else if( text[pos] == '\n' )
+                    ++line;
+            }
+        }
+        else if( c == '(' )
+        {
+            lineStart = false;
+
+            if( depth == 0 && keyword( pos ) != "kicad_pcb" )
+                return false;
+
+            if( depth == 1 )
+            {
+                std::string token = keyword( pos );
+
+                chunk.m_start = pos;
+                chunk.m_line = line;
+                chunk.m_parallel = ( token == "module" || token == "segment" ||
+                                     token == "via" || token == "zone" );
+
+                // The items parsed by the workers need the whole header
+                if( chunk.m_parallel )
+                    itemFound = true;
+                else if( itemFound && ( token == "general" || token == "page" ||
+                                        token == "title_block" || token == "layers" ||
+                                        token == "setup" || token == "net" ||
+                                        token == "net_class" ) )
+                    return false;
+            }
+
+            ++depth;
+        }
+        else if( c == ')' )
+        {
+            lineStart = false;
+
+            if( --depth < 0 )
+                return false;
+
+            if( depth == 1 )
+            {
+                chunk.m_end = pos + 1;
+                aChunks.push_back( chunk );
+            }
+        }
+        else if( c != ' ' && c != '\t' && c != '\r' )
+        {
+            lineStart = false;
+        }
+
+        ++pos;
+    }
+
+    return depth == 0 && itemFound;
+}
+
+
+void PCB_PARSER::parseBoardItems( std::vector< std::unique_ptr<BOARD_ITEM> >& aItems )
+{
+    T token;
+
+    for( token = NextTok();  token != T_EOF;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        token = NextTok();
+
+        switch( token )
+        {
+        case T_module:
+            aItems.emplace_back( parseMODULE() );
+            break;
+
+        case T_segment:
+            aItems.emplace_back( parseTRACK() );
+            break;
+
+        case T_via:
+            aItems.emplace_back( parseVIA() );
+            break;
+
+        case T_zone:
+            aItems.emplace_back( parseZONE_CONTAINER() );
+            break;
+
+        default:
+            Expecting( "module, segment, via or zone" );
+        }
+    }
+}
+
+
+BOARD* PCB_PARSER::ParseBoardParallel( const char* aInput, size_t aSize, const wxString& aSource )
+{
+    // Batches of consecutive modules, tracks, vias and zones, parsed by a single worker
+    struct BATCH
+    {
+        size_t      m_start;
+        size_t      m_end;
+        unsigned    m_line;
+        int         m_requiredVersion;
+
+        std::vector< std::unique_ptr<BOARD_ITEM> >          m_items;
+        std::vector< std::pair<ZONE_CONTAINER*, wxString> > m_zoneNetFixups;
+        std::exception_ptr                                  m_error;
+    };
+
+    const size_t minBatchSize = 256 * 1024;
+
+    std::vector<BOARD_CHUNK> chunks;
+    std::vector<BATCH>       batches;
+    unsigned                 threadCount = std::thread::hardware_concurrency();
+
+    if( threadCount > 1 && splitBoard( aInput, aSize, chunks ) )
+    {
+        size_t parallelSize = 0;
+
+        for( const BOARD_CHUNK& chunk : chunks )
+        {
+            if( chunk.m_parallel )
+                parallelSize += chunk.m_end - chunk.m_start;
+        }
+
+        // A few batches per thread, to balance the load
+        size_t batchSize = std::max( minBatchSize, parallelSize / ( 4 * threadCount ) );
+        bool   split = true;
+
+        for( const BOARD_CHUNK& chunk : chunks )
+        {
+            if( !chunk.m_parallel )
+            {
+                split = true;
+                continue;
+            }
+
+            if( split || chunk.m_end - batches.back().m_start > batchSize )
+            {
+                batches.emplace_back();
+                batches.back().m_start = chunk.m_start;
+                batches.back().m_line = chunk.m_line;
+            }
+
+            batches.back().m_end = chunk.m_end;
+            split = false;
+        }
+    }
+
+    if( batches.size() < 2 )
+    {
+        // Not worth the trouble
+        MEMORY_LINE_READER reader( aInput, aSize, aSource );
+
+        SetLineReader( &reader );
+
+        std::unique_ptr<BOARD_ITEM> item( Parse() );
+        BOARD* board = dynamic_cast<BOARD*>( item.get() );
+
+        if( !board )
+        {
+            THROW_PARSE_ERROR( _( "this file does not contain a PCB" ),
+                               CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+        }
+
+        item.release();
+        return board;
+    }
+
+    // The header and the other items are parsed first by this thread, from a copy of
+    // the input without the batches (but with their line breaks, to report the same
+    // line numbers).
+    std::string serialInput;
+    size_t      pos = 0;
+
+    serialInput.reserve( aSize / 4 );
+
+    for( const BATCH& batch : batches )
+    {
+        serialInput.append( aInput + pos, aInput + batch.m_start );
+        serialInput.append( std::count( aInput + batch.m_start, aInput + batch.m_end, '\n' ),
+                            '\n' );
+        pos = batch.m_end;
+    }
+
+    serialInput.append( aInput + pos, aInput + aSize );
+
+    MEMORY_LINE_READER reader( serialInput.data(), serialInput.size(), aSource );
+
+    SetLineReader( &reader );
+
+    std::unique_ptr<BOARD_ITEM> item( Parse() );
+    BOARD* board = dynamic_cast<BOARD*>( item.get() );
+
+    if( !board )
+    {
+        THROW_PARSE_ERROR( _( "this file does not contain a PCB" ),
+                           CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+
+    // Now parse the batches, with the layer and net maps read from the header
+    std::atomic<size_t> nextBatch( 0 );
+
+    auto worker = [&]()
+    {
+        for( size_t i = nextBatch++; i < batches.size(); i = nextBatch++ )
+        {
+            BATCH& batch = batches[i];
+
+            try
+            {
+                MEMORY_LINE_READER batchReader( aInput + batch.m_start,
+                                                batch.m_end - batch.m_start,
+                                                aSource, batch.m_line - 1 );
+                PCB_PARSER parser( &batchReader );
+
+                parser.m_board = m_board;
+                parser.m_layerIndices = m_layerIndices;
+                parser.m_layerMasks = m_layerMasks;
+                parser.m_netCodes = m_netCodes;
+                parser.m_requiredVersion = m_requiredVersion;
+                parser.m_tooRecent = m_tooRecent;
+                parser.m_zoneNetFixups = &batch.m_zoneNetFixups;
+
+                parser.parseBoardItems( batch.m_items );
+
+                batch.m_requiredVersion = parser.m_requiredVersion;
+            }
+            catch( ... )
+            {
+                batch.m_error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for( unsigned i = 1; i < std::min<size_t>( threadCount, batches.size() ); ++i )
+        threads.push_back( std::thread( worker ) );
+
+    worker();
+
+    for( auto& thread : threads )
+        thread.join();
+
+    // Report the first error in file order
+    for( BATCH& batch : batches )
+    {
+        if( !batch.m_error )
+            continue;
+
+        try
+        {
+            std::rethrow_exception( batch.m_error );
+        }
+        catch( const FUTURE_FORMAT_ERROR& )
+        {
+            throw;
+        }
+        catch( const PARSE_ERROR& parse_error )
+        {
+            if( m_tooRecent )
+                throw FUTURE_FORMAT_ERROR( parse_error, GetRequiredVersion() );
+            else
+                throw;
+        }
+    }
+
+    for( BATCH& batch : batches )
+    {
+        for( std::unique_ptr<BOARD_ITEM>& batchItem : batch.m_items )
+            m_board->Add( batchItem.release(), ADD_APPEND );
+
+        for( const std::pair<ZONE_CONTAINER*, wxString>& fixup : batch.m_zoneNetFixups )
+            fixupZoneNet( fixup.first, fixup.second );
+
+        m_requiredVersion = std::max( m_requiredVersion, batch.m_requiredVersion );
+        m_tooRecent = ( m_requiredVersion > SEXPR_BOARD_FILE_VERSION );
+    }
+
+    item.release();
+    return board;
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3145,40 +3488,50 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
     // Ensure the zone net name is valid, and matches the net code, for copper zones
     if( zone_has_net && ( zone->GetNet()->GetNetname() != netnameFromfile ) )
     {
-        // Can happens which old boards, with nonexistent nets ...
-        // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-            zone->SetNetCode( net->GetNet() );
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNet() );
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNet() );
-
-            // FIXME: a call to any GUI item is not allowed in io plugins:
-            // Change this code to generate a warning message outside this plugin
-            // Prompt the user
-            wxString msg;
-            msg.Printf( _( "There is a zone that belongs to a not existing net\n"
-                           "\"%s\"\n"
-                           "you should verify and edit it (run DRC test)." ),
-                           GetChars( netnameFromfile ) );
-            DisplayError( NULL, msg );
-        }
+        // The board nets must not be modified by a worker thread
+        if( m_zoneNetFixups )
+            m_zoneNetFixups->emplace_back( zone.get(), netnameFromfile );
+        else
+            fixupZoneNet( zone.get(), netnameFromfile );
     }
 
     return zone.release();
 }
 
 
+void PCB_PARSER::fixupZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName )
+{
+    // Can happens which old boards, with nonexistent nets ...
+    // or after being edited by hand
+    // We try to fix the mismatch.
+    NETINFO_ITEM* net = m_board->FindNet( aNetName );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+        aZone->SetNetCode( net->GetNet() );
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetName, newnetcode );
+        m_board->Add( net );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNet() );
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNet() );
+
+        // FIXME: a call to any GUI item is not allowed in io plugins:
+        // Change this code to generate a warning message outside this plugin
+        // Prompt the user
+        wxString msg;
+        msg.Printf( _( "There is a zone that belongs to a not existing net\n"
+                       "\"%s\"\n"
+                       "you should verify and edit it (run DRC test)." ),
+                       GetChars( aNetName ) );
+        DisplayError( NULL, msg );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, NULL,
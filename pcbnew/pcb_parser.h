@@ -36,6 +36,7 @@
 #include <common.h>                             // KiROUND
 #include <convert_to_biu.h>                     // IU_PER_MM
 
+#include <memory>
 #include <unordered_map>
 
 
@@ -74,6 +75,40 @@ class PCB_PARSER : public PCB_LEXER
     bool                m_tooRecent;        ///< true if version parses as later than supported
     int                 m_requiredVersion;  ///< set to the KiCad format version this board requires
 
+    ///> Zones whose net name did not match their net code, when their fix up is left to
+    ///> the caller (see ParseBoardParallel())
+    std::vector< std::pair<ZONE_CONTAINER*, wxString> >* m_zoneNetFixups;
+
+    ///> A part of a board file, holding one top level s-expression
+    struct BOARD_CHUNK
+    {
+        size_t      m_start;        ///< offset of the opening parenthesis
+        size_t      m_end;          ///< offset just after the closing parenthesis
+        unsigned    m_line;         ///< line number of the opening parenthesis
+        bool        m_parallel;     ///< true for the items which can be parsed by workers
+    };
+
+    /**
+     * Function splitBoard
+     * scans the board file in \a aInput for its top level s-expressions.
+     * @return false if the file cannot be parsed in parallel, e.g. if a header section
+     *   (layers, nets...) follows a board item which depends on it.
+     */
+    static bool splitBoard( const char* aInput, size_t aSize, std::vector<BOARD_CHUNK>& aChunks );
+
+    /**
+     * Function parseBoardItems
+     * parses a sequence of top level modules, tracks, vias and zones up to the end
+     * of the input.
+     */
+    void parseBoardItems( std::vector< std::unique_ptr<BOARD_ITEM> >& aItems );
+
+    /**
+     * Function fixupZoneNet
+     * makes the net of \a aZone match \a aNetName, adding a net to the board if needed.
+     */
+    void fixupZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName );
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -273,7 +308,8 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_zoneNetFixups( NULL )
     {
         init();
     }
@@ -300,6 +336,23 @@ public:
     }
 
     BOARD_ITEM* Parse();
+
+    /**
+     * Function ParseBoardParallel
+     * parses a whole .kicad_pcb file held in memory.  The modules, tracks, vias and zones,
+     * which make most of a board file, are split in batches parsed by worker threads with
+     * the layer and net maps read from the header.  They are appended to the board in
+     * file order once all the workers are done.  Falls back to a sequential parse if the
+     * file layout does not allow splitting it.
+     *
+     * @param aInput is the content of the board file, e.g. a MAPPED_FILE_LINE_READER's.
+     * @param aSize is the number of bytes in aInput.
+     * @param aSource is the file name, used in error messages.
+     * @return BOARD* - the board given to SetBoard(), or a new one.
+     * @throw PARSE_ERROR or FUTURE_FORMAT_ERROR like Parse(), or PARSE_ERROR if the file
+     *   is not a board.
+     */
+    BOARD* ParseBoardParallel( const char* aInput, size_t aSize, const wxString& aSource );
     /**
      * Function parseMODULE
      * @param aInitialComments may be a pointer to a heap allocated initial comment block
@@ -27,6 +27,7 @@
 #include <layers_id_colors_and_visibility.h>
 #include <class_plotter.h>
 #include <macros.h>
+#include <kicad_string.h>
 #include <convert_to_biu.h>
 
 
@@ -163,8 +164,8 @@ void PCB_PLOT_PARAMS::Format( OUTPUTFORMATTER* aFormatter,
 
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_excludeedgelayer ),
                        m_excludeEdgeLayer ? trueStr : falseStr );
-    aFormatter->Print( aNestLevel+1, "(%s %f)\n", getTokenName( T_linewidth ),
-                       m_lineWidth / IU_PER_MM );
+    aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_linewidth ),
+                       FormatDouble( m_lineWidth / IU_PER_MM, 6 ).c_str() );
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_plotframeref ),
                        m_plotFrameRef ? trueStr : falseStr );
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_viasonmask ),
@@ -558,7 +559,7 @@ double PCB_PLOT_PARAMS_PARSER::parseDouble()
     if( token != T_NUMBER )
         Expecting( T_NUMBER );
 
-    double val = strtod( CurText(), NULL );
+    double val = ParseDouble( CurText() );
 
     return val;
 }
@@ -0,0 +1,177 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2013-2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <profile.h>
+#include <widgets/progress_reporter.h>
+
+#include "pns_batch_router.h"
+#include "pns_router.h"
+#include "pns_node.h"
+#include "pns_placement_algo.h"
+#include "time_limit.h"
+
+namespace PNS {
+
+BATCH_ROUTER::BATCH_ROUTER( ROUTER* aRouter ) :
+    ALGO_BASE( aRouter ),
+    m_progressReporter( nullptr ),
+    m_timeBudget( 1000 ),
+    m_routed( 0 ),
+    m_failed( 0 ),
+    m_elapsed( 0.0 )
+{
+}
+
+
+BATCH_ROUTER::~BATCH_ROUTER()
+{
+}
+
+
+ITEM* BATCH_ROUTER::findAnchor( const VECTOR2I& aP, int aNet ) const
+{
+    const ITEM_SET items = Router()->GetWorld()->HitTest( aP );
+    ITEM* best = nullptr;
+
+    // prefer pads over tracks and vias
+    for( ITEM* item : items.CItems() )
+    {
+        if( item->Net() != aNet )
+            continue;
+
+        if( !best || item->Kind() < best->Kind() )
+            best = item;
+    }
+
+    return best;
+}
+
+
+bool BATCH_ROUTER::routeConnection( const CONNECTION& aConnection )
+{
+    ROUTER* router = Router();
+
+    // Committing a route replaces the items of the router world it touches, so the
+    // anchors are looked up by position just before routing.
+    ITEM* startItem = findAnchor( aConnection.m_start, aConnection.m_net );
+    ITEM* endItem = findAnchor( aConnection.m_end, aConnection.m_net );
+
+    if( !startItem || !endItem )
+        return false;
+
+    int layer = aConnection.m_layer;
+
+    if( !startItem->Layers().Overlaps( layer ) )
+        layer = startItem->Layers().Start();
+
+    router->UpdateSizes( aConnection.m_sizes );
+
+    if( !router->StartRouting( aConnection.m_start, startItem, layer ) )
+        return false;
+
+    TIME_LIMIT budget( m_timeBudget );
+    bool reached = false;
+
+    // The budget is shared by both attempts and also bounds the shove and walkaround
+    // iterations inside Move(), so a single connection cannot run much past it.
+    router->SetTimeLimit( &budget );
+
+    // try both postures of the initial segment until the head gets to the target
+    for( int attempt = 0; attempt < 2 && !budget.Expired(); attempt++ )
+    {
+        if( attempt > 0 )
+            router->FlipPosture();
+
+        router->Move( aConnection.m_end, endItem );
+
+        if( router->Placer()->CurrentEnd() == aConnection.m_end )
+        {
+            reached = true;
+            break;
+        }
+    }
+
+    router->SetTimeLimit( nullptr );
+
+    if( reached && router->FixRoute( aConnection.m_end, endItem ) )
+        return true;
+
+    router->StopRouting();
+    return false;
+}
+
+
+int BATCH_ROUTER::Run()
+{
+    ROUTER_MODE prevMode = Router()->Mode();
+
+    Router()->SetMode( PNS_MODE_ROUTE_SINGLE );
+
+    m_routed = 0;
+    m_failed = 0;
+
+    if( m_progressReporter )
+    {
+        m_progressReporter->Report( _( "Routing connections..." ) );
+        m_progressReporter->SetMaxProgress( m_connections.size() );
+    }
+
+    PROF_COUNTER totalTime;
+
+    for( const CONNECTION& conn : m_connections )
+    {
+        if( routeConnection( conn ) )
+            m_routed++;
+        else
+            m_failed++;
+
+        if( m_progressReporter )
+        {
+            m_progressReporter->AdvanceProgress();
+            m_progressReporter->KeepRefreshing();
+        }
+    }
+
+    totalTime.Stop();
+    m_elapsed = totalTime.msecs();
+
+    Router()->SetMode( prevMode );
+
+    wxLogTrace( "PNS", "BATCH_ROUTER: routed %d of %d connections in %.1f ms (%.1f connections/s)",
+            m_routed, m_routed + m_failed, m_elapsed, Throughput() );
+
+    return m_routed;
+}
+
+
+double BATCH_ROUTER::CompletionRate() const
+{
+    int total = m_routed + m_failed;
+
+    return total ? 100.0 * m_routed / total : 100.0;
+}
+
+
+double BATCH_ROUTER::Throughput() const
+{
+    return m_elapsed > 0.0 ? 1000.0 * ( m_routed + m_failed ) / m_elapsed : 0.0;
+}
+
+}
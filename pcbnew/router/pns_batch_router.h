@@ -0,0 +1,118 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2013-2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <vector>
+
+#include <math/vector2d.h>
+
+#include "pns_algo_base.h"
+#include "pns_sizes_settings.h"
+
+class PROGRESS_REPORTER;
+
+namespace PNS {
+
+class ROUTER;
+class ITEM;
+
+/**
+ * Class BATCH_ROUTER
+ *
+ * Non-interactive driver for the single track placer. Routes a list of point-to-point
+ * connections (typically the unrouted ratsnest lines) one after another, giving each
+ * of them a time budget. Each connection that reaches its target is committed to the
+ * board through the router interface; the others are left untouched.
+ */
+class BATCH_ROUTER : public ALGO_BASE
+{
+public:
+    struct CONNECTION
+    {
+        VECTOR2I m_start;
+        VECTOR2I m_end;
+        int m_net;
+
+        ///> preferred layer, used if the start anchor is a multilayer item
+        int m_layer;
+
+        SIZES_SETTINGS m_sizes;
+    };
+
+    BATCH_ROUTER( ROUTER* aRouter );
+    ~BATCH_ROUTER();
+
+    void AddConnection( const CONNECTION& aConnection )
+    {
+        m_connections.push_back( aConnection );
+    }
+
+    ///> Sets the time (in milliseconds) spent on a single connection before giving up. The
+    ///> limit is also checked by each shove/walkaround iteration, so it may only be exceeded
+    ///> by the duration of one iteration.
+    void SetTimeBudget( int aMilliseconds )
+    {
+        m_timeBudget = aMilliseconds;
+    }
+
+    void SetProgressReporter( PROGRESS_REPORTER* aReporter )
+    {
+        m_progressReporter = aReporter;
+    }
+
+    /**
+     * Function Run()
+     *
+     * Routes all the connections added so far.
+     * @return number of successfully routed connections
+     */
+    int Run();
+
+    int RoutedCount() const { return m_routed; }
+    int FailedCount() const { return m_failed; }
+
+    ///> Returns the percentage of the connections that have been routed
+    double CompletionRate() const;
+
+    ///> Returns the number of connections processed per second
+    double Throughput() const;
+
+    ///> Returns the total routing time in milliseconds
+    double ElapsedTime() const { return m_elapsed; }
+
+private:
+    bool routeConnection( const CONNECTION& aConnection );
+
+    ITEM* findAnchor( const VECTOR2I& aP, int aNet ) const;
+
+    std::vector<CONNECTION> m_connections;
+    PROGRESS_REPORTER* m_progressReporter;
+
+    int m_timeBudget;
+    int m_routed;
+    int m_failed;
+    double m_elapsed;
+};
+
+}
+
+#endif
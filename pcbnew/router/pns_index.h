@@ -32,6 +32,7 @@
 #include <geometry/shape_index.h>
 
 #include "pns_item.h"
+#include "pns_node_pool.h"
 
 namespace PNS {
 
@@ -48,9 +49,15 @@ class INDEX
 public:
     typedef std::list<ITEM*>            NET_ITEMS_LIST;
     typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
-    typedef std::unordered_set<ITEM*>   ITEM_SET;
+    typedef std::unordered_set<ITEM*, std::hash<ITEM*>, std::equal_to<ITEM*>,
+                               POOL_ALLOCATOR<ITEM*> > ITEM_SET;
 
-    INDEX();
+    /**
+     * Constructor
+     *
+     * @param aPool memory pool for the item set (NULL to use the system allocator)
+     */
+    INDEX( NODE_POOL* aPool = NULL );
     ~INDEX();
 
     /**
@@ -81,14 +88,22 @@ public:
      * For each item, function object aVisitor is called. Only items on
      * overlapping layers are considered.
      *
+     * Sub-indices that can't contain items of the kinds in aKindMask are
+     * not searched at all, and the found items of other kinds (or of the
+     * same net as aItem if aDifferentNetsOnly is set) are rejected before
+     * reaching the visitor.
+     *
      * @param aItem item to search against
      * @param aMinDistance proximity distance (wrs to the item's shape)
      * @param aVisitor function object called on each found item. Return
               false from the visitor to stop searching.
+     * @param aKindMask mask of item kinds passed to the visitor
+     * @param aDifferentNetsOnly skip the items belonging to aItem's net
      * @return number of items found.
      */
     template<class Visitor>
-    int Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor );
+    int Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor,
+               int aKindMask = ITEM::ANY_T, bool aDifferentNetsOnly = false );
 
     /**
      * Function Query()
@@ -143,12 +158,48 @@ public:
 private:
     static const int    MaxSubIndices   = 128;
     static const int    SI_Multilayer   = 2;
+    static const int    SI_Vias         = 3;
     static const int    SI_SegDiagonal  = 0;
     static const int    SI_SegStraight  = 1;
-    static const int    SI_Traces       = 3;
+    static const int    SI_Traces       = 4;
     static const int    SI_PadsTop      = 0;
     static const int    SI_PadsBottom   = 1;
 
+    /**
+     * Class FILTERED_VISITOR
+     *
+     * Rejects the items of unwanted kinds or of the net being routed before
+     * they reach the (much more expensive) collision visitor.
+     */
+    template <class Visitor>
+    class FILTERED_VISITOR
+    {
+    public:
+        FILTERED_VISITOR( Visitor& aVisitor, int aKindMask, bool aSkipNet, int aNet ) :
+            m_visitor( aVisitor ),
+            m_kindMask( aKindMask ),
+            m_skipNet( aSkipNet ),
+            m_net( aNet )
+        {}
+
+        bool operator()( ITEM* aCandidate )
+        {
+            if( !aCandidate->OfKind( m_kindMask ) )
+                return true;
+
+            if( m_skipNet && aCandidate->Net() == m_net )
+                return true;
+
+            return m_visitor( aCandidate );
+        }
+
+    private:
+        Visitor& m_visitor;
+        int m_kindMask;
+        bool m_skipNet;
+        int m_net;
+    };
+
     template <class Visitor>
     int querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor );
 
@@ -159,7 +210,8 @@ private:
     ITEM_SET m_allItems;
 };
 
-INDEX::INDEX()
+INDEX::INDEX( NODE_POOL* aPool ) :
+    m_allItems( 0, std::hash<ITEM*>(), std::equal_to<ITEM*>(), POOL_ALLOCATOR<ITEM*>( aPool ) )
 {
     memset( m_subIndices, 0, sizeof( m_subIndices ) );
 }
@@ -173,7 +225,7 @@ INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
     switch( aItem->Kind() )
     {
     case ITEM::VIA_T:
-        idx_n = SI_Multilayer;
+        idx_n = SI_Vias;
         break;
 
     case ITEM::SOLID_T:
@@ -257,33 +309,53 @@ int INDEX::querySingle( int index, const SHAPE* aShape, int aMinDistance, Visito
 }
 
 template<class Visitor>
-int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor )
+int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor,
+                  int aKindMask, bool aDifferentNetsOnly )
 {
     const SHAPE* shape = aItem->Shape();
     int total = 0;
 
-    total += querySingle( SI_Multilayer, shape, aMinDistance, aVisitor );
+    FILTERED_VISITOR<Visitor> filter( aVisitor, aKindMask, aDifferentNetsOnly, aItem->Net() );
+
+    bool solids = ( aKindMask & ITEM::SOLID_T ) != 0;
+    bool traces = ( aKindMask & ( ITEM::SEGMENT_T | ITEM::LINE_T ) ) != 0;
+
+    if( solids )
+        total += querySingle( SI_Multilayer, shape, aMinDistance, filter );
+
+    if( aKindMask & ITEM::VIA_T )
+        total += querySingle( SI_Vias, shape, aMinDistance, filter );
 
     const LAYER_RANGE layers = aItem->Layers();
 
     if( layers.IsMultilayer() )
     {
-        total += querySingle( SI_PadsTop, shape, aMinDistance, aVisitor );
-        total += querySingle( SI_PadsBottom, shape, aMinDistance, aVisitor );
+        if( solids )
+        {
+            total += querySingle( SI_PadsTop, shape, aMinDistance, filter );
+            total += querySingle( SI_PadsBottom, shape, aMinDistance, filter );
+        }
 
-        for( int i = layers.Start(); i <= layers.End(); ++i )
-            total += querySingle( SI_Traces + 2 * i + SI_SegStraight, shape, aMinDistance, aVisitor );
+        if( traces )
+        {
+            for( int i = layers.Start(); i <= layers.End(); ++i )
+                total += querySingle( SI_Traces + 2 * i + SI_SegStraight, shape, aMinDistance, filter );
+        }
     }
     else
     {
         int l = layers.Start();
 
-        if( l == B_Cu )
-            total += querySingle( SI_PadsTop, shape, aMinDistance, aVisitor );
-        else if( l == F_Cu )
-            total += querySingle( SI_PadsBottom, shape, aMinDistance, aVisitor );
+        if( solids )
+        {
+            if( l == B_Cu )
+                total += querySingle( SI_PadsTop, shape, aMinDistance, filter );
+            else if( l == F_Cu )
+                total += querySingle( SI_PadsBottom, shape, aMinDistance, filter );
+        }
 
-        total += querySingle(  SI_Traces + 2 * l + SI_SegStraight, shape, aMinDistance, aVisitor );
+        if( traces )
+            total += querySingle( SI_Traces + 2 * l + SI_SegStraight, shape, aMinDistance, filter );
     }
 
     return total;
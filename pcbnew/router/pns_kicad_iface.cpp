@@ -478,6 +478,8 @@ PNS_KICAD_IFACE::PNS_KICAD_IFACE()
     m_router = nullptr;
     m_debugDecorator = nullptr;
     m_dispOptions = nullptr;
+    m_groupCommits = false;
+    m_undoGroup = nullptr;
 }
 
 
@@ -988,9 +990,49 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 
 void PNS_KICAD_IFACE::Commit()
 {
+    // a non empty commit creates an undo entry
+    bool changed = !m_commit->Empty();
+
     EraseView();
     m_commit->Push( wxT( "Added a track" ) );
     m_commit.reset( new BOARD_COMMIT( m_tool ) );
+
+    if( changed && m_groupCommits )
+        groupLastUndoCommand();
+}
+
+
+void PNS_KICAD_IFACE::SetGroupCommits( bool aGroup )
+{
+    m_groupCommits = aGroup;
+    m_undoGroup = nullptr;
+}
+
+
+void PNS_KICAD_IFACE::groupLastUndoCommand()
+{
+    PCB_BASE_FRAME* frame = (PCB_BASE_FRAME*) m_tool->GetManager()->GetEditFrame();
+    std::vector<PICKED_ITEMS_LIST*>& commands = frame->GetScreen()->m_UndoList.m_CommandsList;
+    PICKED_ITEMS_LIST* last = commands.back();
+
+    // The undo limits delete the oldest entries first: if the group entry is not just below
+    // the new one, it has been deleted with all the older ones, and the new entry starts
+    // the group.
+    if( commands.size() < 2 || commands[commands.size() - 2] != m_undoGroup )
+    {
+        m_undoGroup = last;
+        return;
+    }
+
+    // Undo restores the pickers in reverse order, so a track added by a commit and removed
+    // by a later one is handled like in separate entries.
+    frame->GetScreen()->PopCommandFromUndoList();
+
+    for( unsigned ii = 0; ii < last->GetCount(); ii++ )
+        m_undoGroup->PushItem( last->GetItemWrapper( ii ) );
+
+    last->ClearItemsList();
+    delete last;
 }
 
 
@@ -58,6 +58,12 @@ public:
     void RemoveItem( PNS::ITEM* aItem ) override;
     void Commit() override;
 
+    /**
+     * Merges the undo entries of the following commits into a single one, so a batch of
+     * routing operations is undone in one step.  Ends with SetGroupCommits( false ).
+     */
+    void SetGroupCommits( bool aGroup );
+
     void UpdateNet( int aNetCode ) override;
 
     PNS::RULE_RESOLVER* GetRuleResolver() override;
@@ -71,6 +77,8 @@ private:
     std::unique_ptr<PNS::SEGMENT> syncTrack( TRACK* aTrack );
     std::unique_ptr<PNS::VIA>     syncVia( VIA* aVia );
 
+    void groupLastUndoCommand();
+
     KIGFX::VIEW* m_view;
     KIGFX::VIEW_GROUP* m_previewItems;
     std::unordered_set<BOARD_CONNECTED_ITEM*> m_hiddenItems;
@@ -81,6 +89,9 @@ private:
     PCB_TOOL* m_tool;
     std::unique_ptr<BOARD_COMMIT> m_commit;
     PCB_DISPLAY_OPTIONS* m_dispOptions;
+
+    bool m_groupCommits;
+    PICKED_ITEMS_LIST* m_undoGroup;     ///< undo entry the grouped commits are merged in
 };
 
 #endif
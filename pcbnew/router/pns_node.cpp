@@ -54,6 +54,27 @@ NODE::NODE()
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
     m_index = new INDEX;
+    m_pool.reset( new NODE_POOL );
+
+#ifdef DEBUG
+    allocNodes.insert( this );
+#endif
+}
+
+
+NODE::NODE( NODE* aParent ) :
+    m_joints( 0, JOINT::JOINT_TAG_HASH(), std::equal_to<JOINT::HASH_TAG>(),
+              POOL_ALLOCATOR<TagJointPair>( aParent->Pool() ) ),
+    m_override( 0, std::hash<ITEM*>(), std::equal_to<ITEM*>(),
+                POOL_ALLOCATOR<ITEM*>( aParent->Pool() ) )
+{
+    wxLogTrace( "PNS", "NODE::create %p", this );
+    m_depth = aParent->m_depth + 1;
+    m_root = aParent->m_root;
+    m_parent = aParent;
+    m_maxClearance = 800000;    // fixme: depends on how thick traces are.
+    m_ruleResolver = aParent->m_ruleResolver;
+    m_index = new INDEX( aParent->Pool() );
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -106,17 +127,12 @@ int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
 
 NODE* NODE::Branch()
 {
-    NODE* child = new NODE;
+    NODE* child = new NODE( this );
 
     wxLogTrace( "PNS", "NODE::branch %p (parent %p)", child, this );
 
     m_children.insert( child );
 
-    child->m_depth = m_depth + 1;
-    child->m_parent = this;
-    child->m_ruleResolver = m_ruleResolver;
-    child->m_root = isRoot() ? this : m_root;
-
     // immmediate offspring of the root branch needs not copy anything.
     // For the rest, deep-copy joints, overridden item map and pointers
     // to stored items.
@@ -286,13 +302,13 @@ int NODE::QueryColliding( const ITEM* aItem,
     visitor.SetWorld( this, NULL );
     visitor.m_forceClearance = aForceClearance;
     // first, look for colliding items in the local index
-    m_index->Query( aItem, m_maxClearance, visitor );
+    m_index->Query( aItem, m_maxClearance, visitor, aKindMask, aDifferentNetsOnly );
 
     // if we haven't found enough items, look in the root branch as well.
     if( !isRoot() && ( visitor.m_matchCount < aLimitCount || aLimitCount < 0 ) )
     {
         visitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, visitor );
+        m_root->m_index->Query( aItem, m_maxClearance, visitor, aKindMask, aDifferentNetsOnly );
     }
 
     return aObstacles.size();
@@ -1226,6 +1242,14 @@ void NODE::KillChildren()
 {
     assert( isRoot() );
     releaseChildren();
+
+    wxLogTrace( "PNS", "NODE::KillChildren: %d pooled allocations, %d chunk allocations, %d kB reserved",
+            m_pool->AllocCount(), m_pool->SystemAllocCount(),
+            (int) ( m_pool->ReservedBytes() / 1024 ) );
+
+    // all the branches are gone, so is everything they allocated from the pool
+    m_pool->Release();
+    m_pool->ResetStats();
 }
 
 
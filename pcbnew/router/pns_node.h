@@ -26,6 +26,7 @@
 #include <list>
 #include <unordered_set>
 #include <unordered_map>
+#include <memory>
 
 #include <core/optional.h>
 
@@ -36,6 +37,7 @@
 #include "pns_item.h"
 #include "pns_joint.h"
 #include "pns_itemset.h"
+#include "pns_node_pool.h"
 
 namespace PNS {
 
@@ -132,7 +134,8 @@ protected:
  * - collision search & clearance checking
  * - assembly of lines connecting joints, finding loops and unique paths
  * - lightweight cloning/branching (for recursive optimization and shove
- * springback)
+ * springback). The hash tables of all branches are allocated from a memory
+ * pool owned by the root node, which is released by KillChildren().
  **/
 class NODE
 {
@@ -394,9 +397,16 @@ public:
     ///> finds the joints corresponding to the ends of line aLine
     void FindLineEnds( const LINE& aLine, JOINT& aA, JOINT& aB );
 
-    ///> Destroys all child nodes. Applicable only to the root node.
+    ///> Destroys all child nodes and releases the branch memory pool.
+    ///> Applicable only to the root node.
     void KillChildren();
 
+    ///> Returns the memory pool used by the branches of this node's root
+    NODE_POOL* Pool() const
+    {
+        return m_root->m_pool.get();
+    }
+
     void AllItemsInNet( int aNet, std::set<ITEM*>& aItems );
 
     void ClearRanks( int aMarkerMask = MK_HEAD | MK_VIOLATION );
@@ -420,8 +430,15 @@ public:
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
-    typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
-    typedef JOINT_MAP::value_type TagJointPair;
+    typedef std::pair<const JOINT::HASH_TAG, JOINT> TagJointPair;
+    typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH,
+                                    std::equal_to<JOINT::HASH_TAG>,
+                                    POOL_ALLOCATOR<TagJointPair> > JOINT_MAP;
+    typedef std::unordered_set<ITEM*, std::hash<ITEM*>, std::equal_to<ITEM*>,
+                               POOL_ALLOCATOR<ITEM*> > OVERRIDE_SET;
+
+    ///> creates a branch of aParent, allocating its containers from aParent's root pool
+    NODE( NODE* aParent );
 
     /// nodes are not copyable
     NODE( const NODE& aB );
@@ -486,7 +503,7 @@ private:
     std::set<NODE*> m_children;
 
     ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    OVERRIDE_SET m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -501,6 +518,9 @@ private:
     int m_depth;
 
     std::unordered_set<ITEM*> m_garbageItems;
+
+    ///> memory pool for the branches (owned by the root node only)
+    std::unique_ptr<NODE_POOL> m_pool;
 };
 
 }
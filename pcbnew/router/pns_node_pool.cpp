@@ -0,0 +1,119 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2013-2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "pns_node_pool.h"
+
+namespace PNS {
+
+NODE_POOL::NODE_POOL() :
+    m_chunkPtr( nullptr ),
+    m_chunkEnd( nullptr )
+{
+    memset( m_freeLists, 0, sizeof( m_freeLists ) );
+    ResetStats();
+    m_liveBlocks = 0;
+}
+
+
+NODE_POOL::~NODE_POOL()
+{
+    assert( m_liveBlocks == 0 );
+
+    for( char* chunk : m_chunks )
+        delete[] chunk;
+}
+
+
+void* NODE_POOL::Alloc( size_t aSize )
+{
+    size_t sizeClass = ( aSize + Granularity - 1 ) / Granularity - 1;
+    size_t blockSize = ( sizeClass + 1 ) * Granularity;
+
+    m_allocCount++;
+    m_liveBlocks++;
+
+    FREE_BLOCK* block = m_freeLists[sizeClass];
+
+    if( block )
+    {
+        m_freeLists[sizeClass] = block->m_next;
+        return block;
+    }
+
+    if( m_chunkPtr + blockSize > m_chunkEnd )
+    {
+        // the tail of the previous chunk is too small for this size class, just drop it
+        char* chunk = new char[ChunkSize];
+
+        m_chunks.push_back( chunk );
+        m_chunkPtr = chunk;
+        m_chunkEnd = chunk + ChunkSize;
+        m_systemAllocCount++;
+    }
+
+    void* ptr = m_chunkPtr;
+    m_chunkPtr += blockSize;
+
+    return ptr;
+}
+
+
+void NODE_POOL::Free( void* aPtr, size_t aSize )
+{
+    if( !aPtr )
+        return;
+
+    size_t sizeClass = ( aSize + Granularity - 1 ) / Granularity - 1;
+
+    FREE_BLOCK* block = static_cast<FREE_BLOCK*>( aPtr );
+    block->m_next = m_freeLists[sizeClass];
+    m_freeLists[sizeClass] = block;
+
+    m_liveBlocks--;
+}
+
+
+bool NODE_POOL::Release()
+{
+    if( m_liveBlocks != 0 )
+        return false;
+
+    for( char* chunk : m_chunks )
+        delete[] chunk;
+
+    m_chunks.clear();
+    memset( m_freeLists, 0, sizeof( m_freeLists ) );
+    m_chunkPtr = nullptr;
+    m_chunkEnd = nullptr;
+
+    return true;
+}
+
+
+void NODE_POOL::ResetStats()
+{
+    m_allocCount = 0;
+    m_systemAllocCount = 0;
+}
+
+}
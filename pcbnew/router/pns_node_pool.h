@@ -0,0 +1,179 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2013-2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_NODE_POOL_H
+#define __PNS_NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace PNS {
+
+/**
+ * Class NODE_POOL
+ *
+ * Size-class free list allocator shared by all the branches of a root NODE. The shove
+ * and walkaround algorithms create and discard many short-lived branches on each mouse
+ * move; their hash table entries are recycled through the pool instead of going back
+ * and forth to the system allocator. All the memory is given back at once when the root
+ * node kills its children.
+ */
+class NODE_POOL
+{
+public:
+    NODE_POOL();
+    ~NODE_POOL();
+
+    /**
+     * Function Alloc()
+     *
+     * Returns a block of at least aSize bytes. Blocks larger than the biggest size
+     * class are taken directly from the system allocator.
+     */
+    void* Alloc( size_t aSize );
+
+    /**
+     * Function Free()
+     *
+     * Returns a block obtained with Alloc() to its free list. aSize must be the
+     * size the block was allocated with.
+     */
+    void Free( void* aPtr, size_t aSize );
+
+    /**
+     * Function Release()
+     *
+     * Frees all the chunks owned by the pool. Does nothing if some blocks are still
+     * in use.
+     * @return true if the memory has been released.
+     */
+    bool Release();
+
+    ///> Resets the allocation statistics
+    void ResetStats();
+
+    ///> Number of Alloc() calls since the last ResetStats()
+    int AllocCount() const { return m_allocCount; }
+
+    ///> Number of Alloc() calls that had to go to the system allocator
+    int SystemAllocCount() const { return m_systemAllocCount; }
+
+    ///> Number of blocks currently handed out
+    int LiveBlocks() const { return m_liveBlocks; }
+
+    ///> Total memory held in chunks, in bytes
+    size_t ReservedBytes() const { return m_chunks.size() * ChunkSize; }
+
+    static bool Pooled( size_t aSize )
+    {
+        return aSize > 0 && aSize <= MaxBlockSize;
+    }
+
+private:
+    static const size_t Granularity    = 16;
+    static const size_t MaxBlockSize   = 256;
+    static const size_t SizeClasses    = MaxBlockSize / Granularity;
+    static const size_t ChunkSize      = 64 * 1024;
+
+    struct FREE_BLOCK
+    {
+        FREE_BLOCK* m_next;
+    };
+
+    FREE_BLOCK* m_freeLists[SizeClasses];
+    std::vector<char*> m_chunks;
+
+    char* m_chunkPtr;
+    char* m_chunkEnd;
+
+    int m_allocCount;
+    int m_systemAllocCount;
+    int m_liveBlocks;
+};
+
+
+/**
+ * Class POOL_ALLOCATOR
+ *
+ * Standard library allocator adaptor for NODE_POOL. An allocator without a pool
+ * (e.g. one used by the root node) simply forwards to the global operator new.
+ */
+template <class T>
+class POOL_ALLOCATOR
+{
+public:
+    typedef T value_type;
+
+    POOL_ALLOCATOR( NODE_POOL* aPool = nullptr ) :
+        m_pool( aPool )
+    {}
+
+    template <class U>
+    POOL_ALLOCATOR( const POOL_ALLOCATOR<U>& aOther ) :
+        m_pool( aOther.Pool() )
+    {}
+
+    T* allocate( size_t aCount )
+    {
+        size_t size = aCount * sizeof( T );
+
+        if( m_pool && NODE_POOL::Pooled( size ) )
+            return static_cast<T*>( m_pool->Alloc( size ) );
+
+        return static_cast<T*>( ::operator new( size ) );
+    }
+
+    void deallocate( T* aPtr, size_t aCount )
+    {
+        size_t size = aCount * sizeof( T );
+
+        if( m_pool && NODE_POOL::Pooled( size ) )
+            m_pool->Free( aPtr, size );
+        else
+            ::operator delete( aPtr );
+    }
+
+    NODE_POOL* Pool() const
+    {
+        return m_pool;
+    }
+
+private:
+    NODE_POOL* m_pool;
+};
+
+
+template <class T, class U>
+bool operator==( const POOL_ALLOCATOR<T>& aA, const POOL_ALLOCATOR<U>& aB )
+{
+    return aA.Pool() == aB.Pool();
+}
+
+
+template <class T, class U>
+bool operator!=( const POOL_ALLOCATOR<T>& aA, const POOL_ALLOCATOR<U>& aB )
+{
+    return aA.Pool() != aB.Pool();
+}
+
+}
+
+#endif
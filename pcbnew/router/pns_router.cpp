@@ -22,6 +22,8 @@
 #include <cstdio>
 #include <vector>
 
+#include <profile.h>
+
 #include <view/view.h>
 #include <view/view_item.h>
 #include <view/view_group.h>
@@ -72,6 +74,7 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_timeLimit = nullptr;
 }
 
 
@@ -81,6 +84,12 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+bool ROUTER::TimeLimitExpired() const
+{
+    return m_timeLimit && m_timeLimit->Expired();
+}
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
@@ -205,6 +214,11 @@ void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
     m_currentEnd = aP;
 
+    PROF_COUNTER moveTime;
+    NODE_POOL* pool = m_world->Pool();
+
+    pool->ResetStats();
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -218,6 +232,11 @@ void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
     default:
         break;
     }
+
+    moveTime.Stop();
+
+    wxLogTrace( "PNS", "ROUTER::Move: %.3f ms, %d branch allocations (%d from the system)",
+            moveTime.msecs(), pool->AllocCount(), pool->SystemAllocCount() );
 }
 
 
@@ -220,6 +220,16 @@ public:
         return m_iface;
     }
 
+    /**
+     * Sets a deadline for the routing operations (Move()), checked by the shove and
+     * walkaround iterations on top of their own limits. The limit is not owned by the router,
+     * pass nullptr to remove it.
+     */
+    void SetTimeLimit( const TIME_LIMIT* aLimit ) { m_timeLimit = aLimit; }
+
+    ///> Returns true if the deadline set by SetTimeLimit() has passed
+    bool TimeLimitExpired() const;
+
 private:
     void movePlacing( const VECTOR2I& aP, ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, ITEM* aItem );
@@ -263,6 +273,7 @@ private:
     int m_snapshotIter;
     bool m_violation;
     bool m_forceMarkObstaclesMode = false;
+    const TIME_LIMIT* m_timeLimit;
 
     ROUTING_SETTINGS m_settings;
     SIZES_SETTINGS m_sizes;
@@ -47,6 +47,7 @@ ROUTING_SETTINGS::ROUTING_SETTINGS()
     m_inlineDragEnabled = false;
     m_snapToTracks = false;
     m_snapToPads = false;
+    m_batchTimeBudget = 1000;
 }
 
 
@@ -67,6 +68,7 @@ void ROUTING_SETTINGS::Save( TOOL_SETTINGS& aSettings ) const
     aSettings.Set( "SuggestFinish", m_suggestFinish );
     aSettings.Set( "FreeAngleMode", m_freeAngleMode );
     aSettings.Set( "InlineDragEnabled", m_inlineDragEnabled );
+    aSettings.Set( "BatchTimeBudget", m_batchTimeBudget );
 }
 
 
@@ -87,6 +89,7 @@ void ROUTING_SETTINGS::Load( const TOOL_SETTINGS& aSettings )
     m_suggestFinish = aSettings.Get( "SuggestFinish", false );
     m_freeAngleMode = aSettings.Get( "FreeAngleMode", false );
     m_inlineDragEnabled = aSettings.Get( "InlineDragEnabled", false );
+    m_batchTimeBudget = aSettings.Get( "BatchTimeBudget", 1000 );
 }
 
 
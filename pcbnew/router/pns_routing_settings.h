@@ -133,6 +133,12 @@ public:
     int WalkaroundIterationLimit() const { return m_walkaroundIterationLimit; };
     TIME_LIMIT WalkaroundTimeLimit() const;
 
+    ///> Returns the time (in ms) the batch router may spend on a single connection.
+    int BatchTimeBudget() const { return m_batchTimeBudget; }
+
+    ///> Sets the time (in ms) the batch router may spend on a single connection.
+    void SetBatchTimeBudget( int aMilliseconds ) { m_batchTimeBudget = aMilliseconds; }
+
     void SetInlineDragEnabled ( bool aEnable ) { m_inlineDragEnabled = aEnable; }
     bool InlineDragEnabled() const { return m_inlineDragEnabled; }
 
@@ -164,6 +170,7 @@ private:
     int m_shoveIterationLimit;
     TIME_LIMIT m_shoveTimeLimit;
     TIME_LIMIT m_walkaroundTimeLimit;
+    int m_batchTimeBudget;
 };
 
 }
@@ -1047,7 +1047,8 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
 
         m_iter++;
 
-        if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit )
+        if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit
+                || Router()->TimeLimitExpired() )
         {
             st = SH_INCOMPLETE;
             break;
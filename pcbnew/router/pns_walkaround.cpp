@@ -206,6 +206,10 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         }
 
         m_iteration++;
+
+        // out of time: behave as if the iteration limit was hit
+        if( Router()->TimeLimitExpired() )
+            m_iteration = m_iterationLimit;
     }
 
     if( m_iteration == m_iterationLimit )
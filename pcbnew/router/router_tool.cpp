@@ -54,10 +54,14 @@ using namespace std::placeholders;
 #include <tools/selection_tool.h>
 #include <tools/edit_tool.h>
 #include <tools/tool_event_utils.h>
+#include <widgets/progress_reporter.h>
+#include <connectivity_data.h>
+#include <connectivity_algo.h>
 
 #include "router_tool.h"
 #include "pns_segment.h"
 #include "pns_router.h"
+#include "pns_batch_router.h"
 
 using namespace KIGFX;
 
@@ -114,6 +118,12 @@ TOOL_ACTION PCB_ACTIONS::routerInlineDrag( "pcbnew.InteractiveRouter.InlineDrag"
         _( "Drag Track/Via" ), _( "Drags tracks and vias without breaking connections" ),
         drag_xpm );
 
+TOOL_ACTION PCB_ACTIONS::routerAutorouteUnrouted( "pcbnew.InteractiveRouter.AutorouteUnrouted",
+        AS_GLOBAL, 0,
+        _( "Route All Unrouted Connections" ),
+        _( "Routes the unrouted ratsnest lines with the push & shove router" ),
+        NULL, AF_ACTIVATE );
+
 TOOL_ACTION PCB_ACTIONS::breakTrack( "pcbnew.InteractiveRouter.BreakTrack",
         AS_GLOBAL, 0,
         _( "Break Track" ),
@@ -341,6 +351,9 @@ public:
         AppendSeparator();
         Add( PNS::TOOL_BASE::ACT_RouterOptions );
 
+        if( aMode == PNS::PNS_MODE_ROUTE_SINGLE )
+            Add( PCB_ACTIONS::routerAutorouteUnrouted );
+
         AppendSeparator();
         Add( &m_zoomMenu );
         Add( &m_gridMenu );
@@ -809,6 +822,7 @@ void ROUTER_TOOL::setTransitions()
     Go( &ROUTER_TOOL::DpDimensionsDialog, PCB_ACTIONS::routerActivateDpDimensionsDialog.MakeEvent() );
     Go( &ROUTER_TOOL::SettingsDialog, PCB_ACTIONS::routerActivateSettingsDialog.MakeEvent() );
     Go( &ROUTER_TOOL::InlineDrag, PCB_ACTIONS::routerInlineDrag.MakeEvent() );
+    Go( &ROUTER_TOOL::AutorouteUnrouted, PCB_ACTIONS::routerAutorouteUnrouted.MakeEvent() );
 
     Go( &ROUTER_TOOL::onViaCommand, ACT_PlaceThroughVia.MakeEvent() );
     Go( &ROUTER_TOOL::onViaCommand, ACT_PlaceBlindVia.MakeEvent() );
@@ -1050,6 +1064,74 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
 }
 
 
+int ROUTER_TOOL::AutorouteUnrouted( const TOOL_EVENT& aEvent )
+{
+    std::vector<CN_EDGE> edges;
+
+    board()->GetConnectivity()->GetUnconnectedEdges( edges );
+
+    if( edges.empty() )
+    {
+        DisplayInfoMessage( frame(), _( "No unrouted connections." ) );
+        return 0;
+    }
+
+    Activate();
+
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    m_router->SyncWorld();
+
+    PNS::BATCH_ROUTER batch( m_router );
+    batch.SetTimeBudget( m_router->Settings().BatchTimeBudget() );
+
+    for( const CN_EDGE& edge : edges )
+    {
+        BOARD_CONNECTED_ITEM* parent = edge.GetSourceNode()->Parent();
+
+        if( !parent || parent->GetNetCode() <= 0 )
+            continue;
+
+        PNS::BATCH_ROUTER::CONNECTION conn;
+
+        conn.m_start = edge.GetSourcePos();
+        conn.m_end = edge.GetTargetPos();
+        conn.m_net = parent->GetNetCode();
+        conn.m_layer = frame()->GetActiveLayer();
+
+        conn.m_sizes = m_router->Sizes();
+        conn.m_sizes.Init( board(), NULL, conn.m_net );
+        conn.m_sizes.AddLayerPair( frame()->GetScreen()->m_Route_Layer_TOP,
+                                   frame()->GetScreen()->m_Route_Layer_BOTTOM );
+
+        batch.AddConnection( conn );
+    }
+
+    std::unique_ptr<WX_PROGRESS_REPORTER> progressReporter(
+            new WX_PROGRESS_REPORTER( frame(), _( "Route Unrouted Connections" ), 1 )
+            );
+
+    batch.SetProgressReporter( progressReporter.get() );
+
+    // the whole run is undone in one step
+    frame()->UndoRedoBlock( true );
+    m_iface->SetGroupCommits( true );
+    batch.Run();
+    m_iface->SetGroupCommits( false );
+    frame()->UndoRedoBlock( false );
+
+    progressReporter.reset();
+
+    DisplayInfoMessage( frame(),
+            wxString::Format( _( "Routed %d of %d connections (%.1f%%) in %.1f s (%.1f connections/s)." ),
+                              batch.RoutedCount(), batch.RoutedCount() + batch.FailedCount(),
+                              batch.CompletionRate(), batch.ElapsedTime() / 1000.0,
+                              batch.Throughput() ) );
+
+    return 0;
+}
+
+
 int ROUTER_TOOL::CustomTrackWidthDialog( const TOOL_EVENT& aEvent )
 {
     BOARD_DESIGN_SETTINGS& bds = board()->GetDesignSettings();
@@ -37,6 +37,7 @@ public:
     int RouteSingleTrace( const TOOL_EVENT& aEvent );
     int RouteDiffPair( const TOOL_EVENT& aEvent );
     int InlineDrag( const TOOL_EVENT& aEvent );
+    int AutorouteUnrouted( const TOOL_EVENT& aEvent );
 
     // TODO make this private?
     int DpDimensionsDialog( const TOOL_EVENT& aEvent );
@@ -242,7 +242,7 @@ void SPECCTRA_DB::readTIME( time_t* time_stamp )
 
 void SPECCTRA_DB::LoadPCB( const wxString& aFilename )
 {
-    FILE_LINE_READER curr_reader( aFilename );
+    MAPPED_FILE_LINE_READER curr_reader( aFilename );
 
     PushReader( &curr_reader );
 
@@ -261,7 +261,7 @@ void SPECCTRA_DB::LoadPCB( const wxString& aFilename )
 
 void SPECCTRA_DB::LoadSESSION( const wxString& aFilename )
 {
-    FILE_LINE_READER curr_reader( aFilename );
+    MAPPED_FILE_LINE_READER curr_reader( aFilename );
 
     PushReader( &curr_reader );
 
@@ -39,6 +39,16 @@
 #include <io_mgr.h>
 #include <macros.h>
 #include <stdlib.h>
+#include <trigo.h>
+#include <memory>
+#include <common.h>
+#include <project.h>
+#include <3d_cache/3d_cache.h>
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+
+#include <wx/filename.h>
+#include <wx/image.h>
 
 static PCB_EDIT_FRAME* s_PcbEditFrame = NULL;
 
@@ -127,3 +137,67 @@ void UpdateUserInterface()
     if( s_PcbEditFrame )
         s_PcbEditFrame->UpdateUserInterface();
 }
+
+
+bool RenderBoard3D( BOARD* aBoard, wxString& aFileName, int aWidth, int aHeight,
+                    double aRotX, double aRotY, double aRotZ, double aZoom )
+{
+    if( !aBoard )
+        return false;
+
+    // Without an editor frame (e.g. in a python script), the models are loaded by a cache
+    // of their own, in the same cache directory as the 3D viewer
+    std::unique_ptr<S3D_CACHE> localCache;
+    S3D_CACHE*                 cache;
+
+    if( s_PcbEditFrame )
+    {
+        cache = s_PcbEditFrame->Prj().Get3DCacheManager();
+    }
+    else
+    {
+        wxFileName cfgpath;
+        cfgpath.AssignDir( GetKicadConfigPath() );
+        cfgpath.AppendDir( wxT( "3d" ) );
+
+        localCache.reset( new S3D_CACHE );
+        localCache->Set3DConfigDir( cfgpath.GetFullPath() );
+        localCache->SetProjectDir( wxFileName( aBoard->GetFileName() ).GetPath() );
+        cache = localCache.get();
+    }
+
+    CINFO3D_VISU settings;
+
+    settings.SetBoard( aBoard );
+    settings.Set3DCacheManager( cache );
+    settings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+
+    // Same defaults as the 3D viewer
+    settings.SetFlag( FL_RENDER_SHOW_HOLES_IN_ZONES, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_BACKFLOOR, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+
+    CCAMERA& camera = settings.CameraGet();
+
+    camera.SetCurWindowSize( wxSize( aWidth, aHeight ) );
+    camera.RotateX( DEG2RAD( aRotX ) );
+    camera.RotateY( DEG2RAD( aRotY ) );
+    camera.RotateZ( DEG2RAD( aRotZ ) );
+    camera.Zoom( aZoom );
+
+    C3D_RENDER_RAYTRACING render( settings );
+    wxImage               image;
+
+    if( !render.RenderToImage( wxSize( aWidth, aHeight ), image ) )
+        return false;
+
+    if( !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+
+    return image.SaveFile( aFileName, wxBITMAP_TYPE_PNG );
+}
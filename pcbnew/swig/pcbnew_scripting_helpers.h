@@ -61,6 +61,22 @@ void    Refresh();
 
 void    WindowZoom( int xl, int yl, int width, int height );
 
+/**
+ * Render a board with the raytracing engine of the 3D viewer, and save the image
+ * as a PNG file. No window nor OpenGL context is used, so it also works on a headless
+ * server, e.g. to produce product renders in batch.
+ *
+ * The camera looks at the top of the board from its default position in the 3D viewer,
+ * is then rotated by aRotX, aRotY and aRotZ degrees, and moved closer to the board by
+ * aZoom (> 1.0) or away from it (< 1.0). The time spent in each stage of the render is
+ * traced in the "KI_TRACE_3D_RENDER" trace mask.
+ *
+ * @return true if the image was saved.
+ */
+bool    RenderBoard3D( BOARD* aBoard, wxString& aFileName, int aWidth, int aHeight,
+                       double aRotX = 0.0, double aRotY = 0.0, double aRotZ = 0.0,
+                       double aZoom = 1.0 );
+
 /**
  * Update the layer manager and other widgets from the board setup
  * (layer and items visibility, colors ...)
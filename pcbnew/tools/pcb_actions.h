@@ -208,6 +208,9 @@ public:
     /// Activation of the Push and Shove router (inline dragging mode)
     static TOOL_ACTION routerInlineDrag;
 
+    /// Routes all the unrouted connections with the Push and Shove router
+    static TOOL_ACTION routerAutorouteUnrouted;
+
     // Point Editor
     /// Break outline (insert additional points to an edge)
     static TOOL_ACTION pointEditorAddCorner;
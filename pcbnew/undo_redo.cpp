@@ -26,6 +26,7 @@
  */
 
 #include <functional>
+#include <unordered_set>
 using namespace std::placeholders;
 #include <fctsys.h>
 #include <class_drawpanel.h>
@@ -44,6 +45,7 @@ using namespace std::placeholders;
 #include <class_dimension.h>
 #include <class_zone.h>
 #include <class_edge_mod.h>
+#include <class_marker_pcb.h>
 
 #include <connectivity_data.h>
 
@@ -594,3 +596,187 @@ void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount
         delete curr_cmd;    // Delete command
     }
 }
+
+
+/**
+ * @ingroup trace_env_vars
+ *
+ * Flag to enable the debug output of the memory used by the undo list.
+ */
+static const wxString traceUndoMemory = wxT( "KICAD_TRACE_UNDO_MEMORY" );
+
+
+/**
+ * Function itemMemory
+ * @return an estimate of the memory used by \a aItem, without its strings.  The filled
+ * polygons of the zones are only counted if they are not in \a aCountedFills.
+ */
+static size_t itemMemory( const EDA_ITEM* aItem,
+                          std::unordered_set<const SHAPE_POLY_SET*>& aCountedFills )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t        size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+            size += itemMemory( pad, aCountedFills );
+
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+            size += itemMemory( item, aCountedFills );
+
+        return size;
+    }
+
+    case PCB_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
+        size_t                size = sizeof( ZONE_CONTAINER )
+                                     + zone->Outline()->TotalVertices() * sizeof( VECTOR2I )
+                                     + zone->FillSegments().size() * sizeof( SEG );
+
+        // The copies of a zone share its filled polygons until it is filled again
+        if( aCountedFills.insert( &zone->GetFilledPolysList() ).second )
+            size += zone->GetFilledPolysList().TotalVertices() * sizeof( VECTOR2I );
+
+        return size;
+    }
+
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        return sizeof( D_PAD ) + pad->GetPrimitives().size() * sizeof( PAD_CS_PRIMITIVE );
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+        size_t             size = aItem->Type() == PCB_LINE_T ? sizeof( DRAWSEGMENT )
+                                                              : sizeof( EDGE_MODULE );
+
+        return size + segment->GetBezierPoints().size() * sizeof( wxPoint )
+               + segment->GetPolyShape().TotalVertices() * sizeof( VECTOR2I );
+    }
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB );
+
+    case PCB_MODULE_TEXT_T:
+        return sizeof( TEXTE_MODULE );
+
+    case PCB_DIMENSION_T:
+        return sizeof( DIMENSION );
+
+    case PCB_TARGET_T:
+        return sizeof( PCB_TARGET );
+
+    case PCB_TRACE_T:
+        return sizeof( TRACK );
+
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    case PCB_ZONE_T:
+        return sizeof( SEGZONE );
+
+    case PCB_MARKER_T:
+        return sizeof( MARKER_PCB );
+
+    default:
+        // No other item is expected in the undo list of a board: count it like an empty
+        // footprint, to err on the side of a bigger estimate
+        return sizeof( MODULE );
+    }
+}
+
+
+/**
+ * Function commandMemory
+ * @return an estimate of the memory used by the items owned by \a aCommand.
+ */
+static size_t commandMemory( const PICKED_ITEMS_LIST* aCommand,
+                             std::unordered_set<const SHAPE_POLY_SET*>& aCountedFills )
+{
+    size_t size = sizeof( PICKED_ITEMS_LIST ) + aCommand->GetCount() * sizeof( ITEM_PICKER );
+
+    // The owned items are the ones deleted by PICKED_ITEMS_LIST::ClearListAndDeleteItems()
+    for( unsigned ii = 0; ii < aCommand->GetCount(); ii++ )
+    {
+        switch( aCommand->GetPickedItemStatus( ii ) )
+        {
+        case UR_CHANGED:
+        case UR_EXCHANGE_T:
+            if( aCommand->GetPickedItemLink( ii ) )
+                size += itemMemory( aCommand->GetPickedItemLink( ii ), aCountedFills );
+
+            break;
+
+        case UR_DELETED:
+        case UR_LIBEDIT:
+            if( aCommand->GetPickedItem( ii ) )
+                size += itemMemory( aCommand->GetPickedItem( ii ), aCountedFills );
+
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return size;
+}
+
+
+void PCB_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
+{
+    BASE_SCREEN::PushCommandToUndoList( aNewitem );
+
+    if( m_undoMemoryMax <= 0 )
+        return;
+
+    // Keep the newest commands using less memory than the budget.  The filled polygons
+    // shared by several commands are counted in the newest one, which is deleted last.
+    std::vector<PICKED_ITEMS_LIST*>&          commands = m_UndoList.m_CommandsList;
+    std::unordered_set<const SHAPE_POLY_SET*> countedFills;
+    size_t                                    budget = (size_t) m_undoMemoryMax << 20;
+    size_t                                    memory = 0;
+    unsigned                                  kept = 0;
+
+    for( auto it = commands.rbegin(); it != commands.rend(); ++it )
+    {
+        size_t size = commandMemory( *it, countedFills );
+
+        if( kept > 0 && memory + size > budget )
+            break;
+
+        memory += size;
+        kept++;
+    }
+
+    int deleted = (int) ( commands.size() - kept );
+
+    if( deleted > 0 )
+        ClearUndoORRedoList( m_UndoList, deleted );
+
+    wxLogTrace( traceUndoMemory, wxT( "Undo list: %u commands, %.1f MB, %d deleted" ),
+                kept, memory / 1048576.0, deleted );
+}
+
+
+size_t PCB_SCREEN::GetUndoRedoMemory() const
+{
+    std::unordered_set<const SHAPE_POLY_SET*> countedFills;
+    size_t                                    memory = 0;
+
+    for( const PICKED_ITEMS_LIST* command : m_UndoList.m_CommandsList )
+        memory += commandMemory( command, countedFills );
+
+    for( const PICKED_ITEMS_LIST* command : m_RedoList.m_CommandsList )
+        memory += commandMemory( command, countedFills );
+
+    return memory;
+}
@@ -320,3 +320,9 @@ void DIALOG_BLOCK_OPTIONS::ExecuteCommand( wxCommandEvent& event )
 void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount )
 {
 }
+
+
+void PCB_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
+{
+    BASE_SCREEN::PushCommandToUndoList( aNewitem );
+}
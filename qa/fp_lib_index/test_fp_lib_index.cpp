@@ -0,0 +1,315 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <fp_lib_index.h>
+#include <common.h>
+#include <ki_exception.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/init.h>
+#include <wx/utils.h>
+
+#include <map>
+
+
+/**
+ * Initializes wxWidgets, and keeps the index files of the tests out of the user's
+ * configuration directory.
+ */
+struct FP_LIB_INDEX_ENVIRONMENT
+{
+    FP_LIB_INDEX_ENVIRONMENT()
+    {
+        wxSetEnv( wxT( "XDG_CONFIG_HOME" ), RootDir() + wxT( "config" ) );
+    }
+
+    ~FP_LIB_INDEX_ENVIRONMENT()
+    {
+        wxFileName::Rmdir( RootDir(), wxPATH_RMDIR_RECURSIVE );
+    }
+
+    static wxString RootDir()
+    {
+        static const wxString root = wxFileName::GetTempDir() + wxFileName::GetPathSeparator()
+                + wxString::Format( wxT( "qa_fp_lib_index_%lu" ), wxGetProcessId() )
+                + wxFileName::GetPathSeparator();
+
+        return root;
+    }
+
+    wxInitializer m_wxInit;
+};
+
+BOOST_GLOBAL_FIXTURE( FP_LIB_INDEX_ENVIRONMENT );
+
+
+/**
+ * A footprint library in its own directory.
+ */
+struct FpLibIndexFixture
+{
+    wxString m_libraryPath;
+
+    FpLibIndexFixture()
+    {
+        static int count = 0;
+
+        m_libraryPath = FP_LIB_INDEX_ENVIRONMENT::RootDir()
+                + wxString::Format( wxT( "lib%d.pretty" ), count++ );
+
+        wxFileName::Mkdir( m_libraryPath, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+    }
+
+    wxString fileName( const wxString& aName ) const
+    {
+        return m_libraryPath + wxFileName::GetPathSeparator() + aName + wxT( ".kicad_mod" );
+    }
+
+    /**
+     * Writes the footprint file \a aName, with a pad for each character of \a aPadNames,
+     * and sets its modification time \a aAgeHours ago (0 keeps the current time).
+     */
+    void writeFootprint( const wxString& aName, const wxString& aDescr, const wxString& aTags,
+                         const wxString& aPadNames, int aAgeHours = 1 )
+    {
+        wxFFile file( fileName( aName ), wxT( "w" ) );
+
+        file.Write( wxString::Format( wxT( "(module %s (layer F.Cu) (tedit 59D6C1F2)\n" ),
+                                      aName ) );
+        file.Write( wxString::Format( wxT( "  (descr \"%s\")\n  (tags \"%s\")\n" ),
+                                      aDescr, aTags ) );
+
+        for( unsigned i = 0; i < aPadNames.length(); i++ )
+        {
+            file.Write( wxString::Format(
+                    wxT( "  (pad %c smd rect (at %u 0) (size 1 1) (layers F.Cu F.Mask))\n" ),
+                    aPadNames[i], i * 2 ) );
+        }
+
+        file.Write( wxT( ")\n" ) );
+        file.Close();
+
+        if( aAgeHours > 0 )
+        {
+            wxDateTime time = wxDateTime::Now() - wxTimeSpan::Hours( aAgeHours );
+            wxFileName( fileName( aName ) ).SetTimes( &time, &time, NULL );
+        }
+    }
+
+    /// Indexes the library, as a new instance of the program would do
+    std::map<wxString, FP_LIB_INDEX::ENTRY> update( int& aParsedCount )
+    {
+        FP_LIB_INDEX index( m_libraryPath );
+        std::map<wxString, FP_LIB_INDEX::ENTRY> entries;
+
+        index.Update();
+
+        for( const FP_LIB_INDEX::ENTRY& entry : index.GetEntries() )
+            entries[entry.m_name] = entry;
+
+        aParsedCount = index.GetParsedCount();
+
+        return entries;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FpLibIndex, FpLibIndexFixture )
+
+/**
+ * Checks the content of the index of a new library.
+ */
+BOOST_AUTO_TEST_CASE( NewLibrary )
+{
+    writeFootprint( wxT( "R_0603" ), wxT( "Resistor 0603" ), wxT( "resistor smd" ), wxT( "12" ) );
+    writeFootprint( wxT( "SOT-23" ), wxT( "SOT-23 package" ), wxT( "transistor" ), wxT( "1223" ) );
+
+    int parsed;
+    auto entries = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 2 );
+    BOOST_REQUIRE_EQUAL( entries.size(), 2 );
+
+    const FP_LIB_INDEX::ENTRY& resistor = entries[wxT( "R_0603" )];
+
+    BOOST_CHECK( resistor.m_doc == wxT( "Resistor 0603" ) );
+    BOOST_CHECK( resistor.m_keywords == wxT( "resistor smd" ) );
+    BOOST_CHECK_EQUAL( resistor.m_padCount, 2 );
+    BOOST_CHECK_EQUAL( resistor.m_uniquePadCount, 2 );
+
+    const FP_LIB_INDEX::ENTRY& sot = entries[wxT( "SOT-23" )];
+
+    BOOST_CHECK( sot.m_doc == wxT( "SOT-23 package" ) );
+    BOOST_CHECK_EQUAL( sot.m_padCount, 4 );
+    BOOST_CHECK_EQUAL( sot.m_uniquePadCount, 3 );
+}
+
+/**
+ * Checks that an unchanged library is listed from its index file alone.
+ */
+BOOST_AUTO_TEST_CASE( Unchanged )
+{
+    writeFootprint( wxT( "R_0603" ), wxT( "Resistor (0603), 1.6 x 0.8 mm" ), wxT( "resistor" ),
+                    wxT( "12" ) );
+    writeFootprint( wxT( "C_0603" ), wxT( "Capacitor 0603" ), wxT( "capacitor" ), wxT( "12" ) );
+
+    int parsed;
+    auto first = update( parsed );
+    auto second = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 0 );
+    BOOST_REQUIRE_EQUAL( second.size(), 2 );
+
+    for( auto& entry : first )
+    {
+        const FP_LIB_INDEX::ENTRY& indexed = second[entry.first];
+
+        BOOST_CHECK( indexed.m_doc == entry.second.m_doc );
+        BOOST_CHECK( indexed.m_keywords == entry.second.m_keywords );
+        BOOST_CHECK_EQUAL( indexed.m_padCount, entry.second.m_padCount );
+        BOOST_CHECK_EQUAL( indexed.m_uniquePadCount, entry.second.m_uniquePadCount );
+        BOOST_CHECK_EQUAL( indexed.m_modTime, entry.second.m_modTime );
+    }
+}
+
+/**
+ * Checks that only the added and modified footprints are parsed, and that the deleted
+ * ones leave the index.
+ */
+BOOST_AUTO_TEST_CASE( Modified )
+{
+    writeFootprint( wxT( "A" ), wxT( "first" ), wxEmptyString, wxT( "1" ) );
+    writeFootprint( wxT( "B" ), wxT( "second" ), wxEmptyString, wxT( "1" ) );
+    writeFootprint( wxT( "C" ), wxT( "third" ), wxEmptyString, wxT( "1" ) );
+
+    int parsed;
+    update( parsed );
+
+    writeFootprint( wxT( "A" ), wxT( "first, modified" ), wxEmptyString, wxT( "12" ), 2 );
+    writeFootprint( wxT( "D" ), wxT( "fourth" ), wxEmptyString, wxT( "1" ) );
+    wxRemoveFile( fileName( wxT( "B" ) ) );
+
+    auto entries = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 2 );
+    BOOST_REQUIRE_EQUAL( entries.size(), 3 );
+    BOOST_CHECK( entries.count( wxT( "B" ) ) == 0 );
+    BOOST_CHECK( entries[wxT( "A" )].m_doc == wxT( "first, modified" ) );
+    BOOST_CHECK_EQUAL( entries[wxT( "A" )].m_padCount, 2 );
+    BOOST_CHECK( entries[wxT( "C" )].m_doc == wxT( "third" ) );
+    BOOST_CHECK( entries[wxT( "D" )].m_doc == wxT( "fourth" ) );
+
+    update( parsed );
+    BOOST_CHECK_EQUAL( parsed, 0 );
+}
+
+/**
+ * Checks that a file modified just now is parsed again by the next update, as it could
+ * still be modified with the same time stamp.
+ */
+BOOST_AUTO_TEST_CASE( RecentFile )
+{
+    writeFootprint( wxT( "OLD" ), wxT( "old" ), wxEmptyString, wxT( "1" ) );
+    writeFootprint( wxT( "NEW" ), wxT( "new" ), wxEmptyString, wxT( "1" ), 0 );
+
+    int parsed;
+    auto entries = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 2 );
+    BOOST_CHECK_EQUAL( entries[wxT( "NEW" )].m_modTime, -1 );
+
+    entries = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 1 );
+    BOOST_CHECK( entries[wxT( "NEW" )].m_doc == wxT( "new" ) );
+}
+
+/**
+ * Checks that a footprint file which cannot be parsed is reported, and does not prevent
+ * the other footprints from being indexed.
+ */
+BOOST_AUTO_TEST_CASE( ParseError )
+{
+    writeFootprint( wxT( "GOOD" ), wxT( "good" ), wxEmptyString, wxT( "1" ) );
+
+    wxFFile file( fileName( wxT( "BAD" ) ), wxT( "w" ) );
+    file.Write( wxT( "(module BAD (layer F.Cu)\n" ) );
+    file.Close();
+
+    FP_LIB_INDEX index( m_libraryPath );
+
+    BOOST_CHECK_THROW( index.Update(), IO_ERROR );
+    BOOST_REQUIRE_EQUAL( index.GetEntries().size(), 1 );
+    BOOST_CHECK( index.GetEntries()[0].m_name == wxT( "GOOD" ) );
+}
+
+/**
+ * Checks that a damaged index file is ignored, and written again.
+ */
+BOOST_AUTO_TEST_CASE( DamagedIndex )
+{
+    writeFootprint( wxT( "A" ), wxT( "first" ), wxEmptyString, wxT( "1" ) );
+    writeFootprint( wxT( "B" ), wxT( "second" ), wxEmptyString, wxT( "1" ) );
+
+    int parsed;
+    update( parsed );
+
+    // Truncate every index file, this library's is one of them
+    wxString indexDir = GetKicadConfigPath() + wxFileName::GetPathSeparator() + wxT( "fp-index" );
+    wxDir dir( indexDir );
+    wxString indexName;
+
+    BOOST_REQUIRE( dir.IsOpened() );
+
+    for( bool found = dir.GetFirst( &indexName, wxT( "*.idx" ), wxDIR_FILES ); found;
+         found = dir.GetNext( &indexName ) )
+    {
+        wxFFile index( indexDir + wxFileName::GetPathSeparator() + indexName, wxT( "w" ) );
+        index.Write( wxT( "(fp_lib_index (version" ) );
+    }
+
+    auto entries = update( parsed );
+
+    BOOST_CHECK_EQUAL( parsed, 2 );
+    BOOST_CHECK_EQUAL( entries.size(), 2 );
+
+    update( parsed );
+    BOOST_CHECK_EQUAL( parsed, 0 );
+}
+
+/**
+ * Checks that a missing library directory is reported.
+ */
+BOOST_AUTO_TEST_CASE( MissingLibrary )
+{
+    FP_LIB_INDEX index( m_libraryPath + wxT( "_missing" ) );
+
+    BOOST_CHECK_THROW( index.Update(), IO_ERROR );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <geometry/item_rtree.h>
+
+#include <vector>
+
+/**
+ * Items of a row, 10 units wide and spaced by 100 units, inserted in a tree.
+ */
+struct ItemRtreeFixture
+{
+    struct ITEM
+    {
+        int m_id;
+    };
+
+    std::vector<ITEM>   m_items;
+    ITEM_RTREE<ITEM*>   m_tree;
+
+    ItemRtreeFixture() :
+        m_items( 20 )
+    {
+        for( int i = 0; i < (int) m_items.size(); i++ )
+        {
+            m_items[i].m_id = i;
+            m_tree.Insert( &m_items[i], EDA_RECT( wxPoint( i * 100, 0 ), wxSize( 10, 10 ) ) );
+        }
+    }
+
+    std::vector<int> query( const EDA_RECT& aBounds )
+    {
+        std::vector<ITEM*> found;
+        std::vector<int> ids;
+
+        m_tree.Query( aBounds, found );
+
+        for( ITEM* item : found )
+            ids.push_back( item->m_id );
+
+        return ids;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ItemRtree, ItemRtreeFixture )
+
+/**
+ * Checks that a query returns the items it intersects, and only them.
+ */
+BOOST_AUTO_TEST_CASE( Query )
+{
+    std::vector<int> expected = { 2, 3, 4 };
+    std::vector<int> ids = query( EDA_RECT( wxPoint( 205, 5 ), wxSize( 200, 1 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+
+    // Between two items, and outside of the row
+    BOOST_CHECK( query( EDA_RECT( wxPoint( 20, 0 ), wxSize( 50, 10 ) ) ).empty() );
+    BOOST_CHECK( query( EDA_RECT( wxPoint( 0, 20 ), wxSize( 5000, 10 ) ) ).empty() );
+
+    // The boxes are closed: touching an edge is enough
+    expected = { 1 };
+    ids = query( EDA_RECT( wxPoint( 110, 10 ), wxSize( 50, 50 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+}
+
+/**
+ * Checks that boxes with a negative size are normalized, both inserted and queried.
+ */
+BOOST_AUTO_TEST_CASE( NegativeSize )
+{
+    ITEM item = { 100 };
+
+    m_tree.Insert( &item, EDA_RECT( wxPoint( 5010, 510 ), wxSize( -10, -10 ) ) );
+
+    std::vector<int> expected = { 100 };
+    std::vector<int> ids = query( EDA_RECT( wxPoint( 5020, 520 ), wxSize( -15, -15 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+
+    m_tree.Remove( &item );
+    BOOST_CHECK( query( EDA_RECT( wxPoint( 5000, 500 ), wxSize( 10, 10 ) ) ).empty() );
+}
+
+/**
+ * Checks that the items are returned in the order they were inserted in, whatever the
+ * layout of the tree.
+ */
+BOOST_AUTO_TEST_CASE( InsertionOrder )
+{
+    std::vector<int> ids = query( EDA_RECT( wxPoint( -100, -100 ), wxSize( 10000, 1000 ) ) );
+
+    BOOST_REQUIRE_EQUAL( ids.size(), m_items.size() );
+
+    for( int i = 0; i < (int) ids.size(); i++ )
+        BOOST_CHECK_EQUAL( ids[i], i );
+
+    // An item inserted again comes after all the others
+    m_tree.Remove( &m_items[0] );
+    m_tree.Insert( &m_items[0], EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ) );
+
+    std::vector<int> expected = { 1, 0 };
+    ids = query( EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 10 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+}
+
+/**
+ * Checks that a removed item is not found anymore, and that removing an item which is
+ * not in the tree does nothing.
+ */
+BOOST_AUTO_TEST_CASE( Remove )
+{
+    m_tree.Remove( &m_items[3] );
+
+    std::vector<int> expected = { 2, 4 };
+    std::vector<int> ids = query( EDA_RECT( wxPoint( 200, 0 ), wxSize( 200, 10 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+
+    ITEM other = { 100 };
+
+    m_tree.Remove( &m_items[3] );
+    m_tree.Remove( &other );
+
+    ids = query( EDA_RECT( wxPoint( 200, 0 ), wxSize( 200, 10 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+}
+
+/**
+ * Checks that an item moved by removing and inserting it again is only found at its
+ * new place (this is how the board and schematic indexes update a modified item).
+ */
+BOOST_AUTO_TEST_CASE( Move )
+{
+    m_tree.Remove( &m_items[5] );
+    m_tree.Insert( &m_items[5], EDA_RECT( wxPoint( 500, 1000 ), wxSize( 10, 10 ) ) );
+
+    BOOST_CHECK( query( EDA_RECT( wxPoint( 500, 0 ), wxSize( 10, 10 ) ) ).empty() );
+
+    std::vector<int> expected = { 5 };
+    std::vector<int> ids = query( EDA_RECT( wxPoint( 0, 1000 ), wxSize( 5000, 10 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+}
+
+/**
+ * Checks that a cleared tree is empty and can be filled again, as done when the index
+ * of a board or a schematic screen is invalidated and rebuilt.
+ */
+BOOST_AUTO_TEST_CASE( Clear )
+{
+    m_tree.Clear();
+
+    BOOST_CHECK( query( EDA_RECT( wxPoint( -100, -100 ), wxSize( 10000, 1000 ) ) ).empty() );
+
+    m_tree.Insert( &m_items[7], EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ) );
+    m_tree.Insert( &m_items[2], EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ) );
+
+    std::vector<int> expected = { 7, 2 };
+    std::vector<int> ids = query( EDA_RECT( wxPoint( -100, -100 ), wxSize( 10000, 1000 ) ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
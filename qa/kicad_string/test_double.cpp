@@ -0,0 +1,216 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <kicad_string.h>
+
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+
+/**
+ * Prints \a aValue with printf() in the "C" locale, the reference of FormatDouble()
+ */
+static std::string printC( const char* aFormat, int aPrecision, double aValue )
+{
+    char buf[64];
+    int  len = snprintf( buf, sizeof( buf ), aFormat, aPrecision, aValue );
+
+    return std::string( buf, len );
+}
+
+
+BOOST_AUTO_TEST_SUITE( DoubleFormatting )
+
+/**
+ * Checks FormatDouble() prints the same text as "%.*g" with the precisions used in the
+ * board files: 10 for lengths and angles, 16 for Double2Str()
+ */
+BOOST_AUTO_TEST_CASE( SameAsPrintfG )
+{
+    const double values[] =
+    {
+        0.0, 1.0, -1.0, 0.1, 0.25, 1.27, -2.54, 100.0, 123.456789, 123.456789012345,
+        359.9, -90.0, 0.1 + 0.2, 9.2, 1.0 / 3.0, 2e-3, 0.001234, 12345678.9, 1e10, 1e15,
+        9999999999.6, -759.313152
+    };
+
+    for( double value : values )
+    {
+        for( int precision : { 6, 10, 16 } )
+        {
+            BOOST_CHECK_EQUAL( FormatDouble( value, precision, false ),
+                               printC( "%.*g", precision, value ) );
+        }
+    }
+
+    // The angles of the board files
+    BOOST_CHECK_EQUAL( FormatDouble( 123.456789012345, 10, false ), "123.456789" );
+    BOOST_CHECK_EQUAL( FormatDouble( 1e-5, 10, false ), printC( "%.*g", 10, 1e-5 ) );
+
+    // Double2Str()
+    BOOST_CHECK_EQUAL( FormatDouble( 0.1 + 0.2, 16 ), "0.3" );
+    BOOST_CHECK_EQUAL( FormatDouble( -0.0, 10 ), "-0" );
+}
+
+
+/**
+ * Checks the values not bigger than 1e-4 are printed in fixed point notation
+ */
+BOOST_AUTO_TEST_CASE( SmallValues )
+{
+    BOOST_CHECK_EQUAL( FormatDouble( 1e-4, 10 ), "0.0001" );
+    BOOST_CHECK_EQUAL( FormatDouble( -1e-5, 10 ), "-0.00001" );
+    BOOST_CHECK_EQUAL( FormatDouble( 1e-6, 16 ), "0.000001" );
+    BOOST_CHECK_EQUAL( FormatDouble( 1.23456789e-5, 10 ), "0.0000123457" );
+    BOOST_CHECK_EQUAL( FormatDouble( 1e-12, 10 ), "0" );
+}
+
+
+/**
+ * Checks the decimal separator of the current locale is not used
+ */
+BOOST_AUTO_TEST_CASE( CommaLocale )
+{
+    const char* locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German" };
+    std::string previous = setlocale( LC_NUMERIC, NULL );
+    bool        found = false;
+
+    for( const char* locale : locales )
+    {
+        if( setlocale( LC_NUMERIC, locale ) )
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if( !found )
+    {
+        BOOST_TEST_MESSAGE( "No locale with a comma decimal separator, test skipped" );
+        return;
+    }
+
+    BOOST_CHECK_EQUAL( FormatDouble( 431.8, 6 ), "431.8" );
+    BOOST_CHECK_EQUAL( FormatDouble( 0.1 + 0.2, 16 ), "0.3" );
+    BOOST_CHECK_EQUAL( FormatDouble( 123.456789012345, 10, false ), "123.456789" );
+    BOOST_CHECK_EQUAL( FormatDouble( 1.23456789e-5, 10 ), "0.0000123457" );
+    BOOST_CHECK_EQUAL( ParseDouble( "279.4" ), 279.4 );
+
+    setlocale( LC_NUMERIC, previous.c_str() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE( DoubleParsing )
+
+/**
+ * Checks ParseDouble() reads the decimal numbers like strtod() in the "C" locale
+ */
+BOOST_AUTO_TEST_CASE( SameAsStrtod )
+{
+    const char* texts[] =
+    {
+        "0", "-0", "1.5", "-2.54", ".5", "5.", "  +3.25e2", "1e-3", "0.30000000000000004",
+        "123456789012345678901234567890", "1.7976931348623157e308", "4.9e-324"
+    };
+
+    for( const char* text : texts )
+    {
+        const char* end;
+        char*       refEnd;
+        double      value = ParseDouble( text, &end );
+        double      ref = strtod( text, &refEnd );
+
+        BOOST_CHECK_EQUAL( value, ref );
+        BOOST_CHECK_EQUAL( std::signbit( value ), std::signbit( ref ) );
+        BOOST_CHECK_EQUAL( end - text, refEnd - text );
+    }
+}
+
+
+/**
+ * Checks the out of range values keep their sign
+ */
+BOOST_AUTO_TEST_CASE( OutOfRange )
+{
+    errno = 0;
+    BOOST_CHECK_EQUAL( ParseDouble( "-1e400" ), -HUGE_VAL );
+    BOOST_CHECK_EQUAL( errno, ERANGE );
+
+    errno = 0;
+    BOOST_CHECK_EQUAL( ParseDouble( "1e400" ), HUGE_VAL );
+    BOOST_CHECK_EQUAL( errno, ERANGE );
+
+    double underflow = ParseDouble( "-1e-400" );
+
+    BOOST_CHECK_EQUAL( underflow, 0.0 );
+    BOOST_CHECK( std::signbit( underflow ) );
+}
+
+
+/**
+ * Checks the other forms accepted by strtod(): hexadecimal numbers, infinities and NaNs
+ */
+BOOST_AUTO_TEST_CASE( OtherForms )
+{
+    const char* end;
+
+    BOOST_CHECK_EQUAL( ParseDouble( "0x10", &end ), 16.0 );
+    BOOST_CHECK_EQUAL( *end, '\0' );
+    BOOST_CHECK_EQUAL( ParseDouble( "-0x1.8p1" ), -3.0 );
+    BOOST_CHECK_EQUAL( ParseDouble( "0X1P-2" ), 0.25 );
+
+    // No hexadecimal digit: only the "0" is read
+    BOOST_CHECK_EQUAL( ParseDouble( "0xg", &end ), 0.0 );
+    BOOST_CHECK_EQUAL( *end, 'x' );
+
+    BOOST_CHECK_EQUAL( ParseDouble( "inf" ), HUGE_VAL );
+    BOOST_CHECK_EQUAL( ParseDouble( "-Infinity", &end ), -HUGE_VAL );
+    BOOST_CHECK_EQUAL( *end, '\0' );
+    BOOST_CHECK( std::isnan( ParseDouble( "nan" ) ) );
+    BOOST_CHECK( std::isnan( ParseDouble( "NaN(123)", &end ) ) );
+    BOOST_CHECK_EQUAL( *end, '\0' );
+}
+
+
+/**
+ * Checks the numbers written by FormatDouble() read back to the same value
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    for( int nm = -2000000; nm <= 2000000; nm += 997 )
+    {
+        double mm = nm / 1e6;
+
+        BOOST_CHECK_EQUAL( ParseDouble( FormatDouble( mm, 10 ).c_str() ), mm );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
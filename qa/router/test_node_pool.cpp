@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <pns_node_pool.h>
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+using PNS::NODE_POOL;
+using PNS::POOL_ALLOCATOR;
+
+
+BOOST_AUTO_TEST_SUITE( NodePool )
+
+/**
+ * Checks that the blocks handed out at the same time do not overlap.
+ */
+BOOST_AUTO_TEST_CASE( DistinctBlocks )
+{
+    NODE_POOL pool;
+    std::vector<char*> blocks;
+
+    for( int i = 0; i < 1000; i++ )
+    {
+        size_t size = 1 + i % 256;
+        char* block = static_cast<char*>( pool.Alloc( size ) );
+
+        BOOST_REQUIRE( block );
+        BOOST_CHECK_EQUAL( reinterpret_cast<uintptr_t>( block ) % 16, 0 );
+        memset( block, i & 0xff, size );
+        blocks.push_back( block );
+    }
+
+    for( int i = 0; i < 1000; i++ )
+    {
+        size_t size = 1 + i % 256;
+
+        for( size_t j = 0; j < size; j++ )
+            BOOST_REQUIRE_EQUAL( blocks[i][j], (char) ( i & 0xff ) );
+    }
+
+    BOOST_CHECK_EQUAL( pool.LiveBlocks(), 1000 );
+
+    for( int i = 0; i < 1000; i++ )
+        pool.Free( blocks[i], 1 + i % 256 );
+
+    BOOST_CHECK_EQUAL( pool.LiveBlocks(), 0 );
+}
+
+/**
+ * Checks that a freed block is reused by the next allocation of its size class only.
+ */
+BOOST_AUTO_TEST_CASE( Recycling )
+{
+    NODE_POOL pool;
+
+    void* a = pool.Alloc( 20 );
+    pool.Free( a, 20 );
+
+    // 17 to 32 bytes share a size class, 16 bytes do not
+    void* b = pool.Alloc( 16 );
+    void* c = pool.Alloc( 32 );
+
+    BOOST_CHECK( b != a );
+    BOOST_CHECK( c == a );
+    BOOST_CHECK_EQUAL( pool.AllocCount(), 3 );
+    BOOST_CHECK_EQUAL( pool.SystemAllocCount(), 1 );
+
+    pool.Free( b, 16 );
+    pool.Free( c, 32 );
+
+    pool.ResetStats();
+    BOOST_CHECK_EQUAL( pool.AllocCount(), 0 );
+    BOOST_CHECK_EQUAL( pool.SystemAllocCount(), 0 );
+}
+
+/**
+ * Checks that the pool takes new chunks from the system when the current one is full.
+ */
+BOOST_AUTO_TEST_CASE( ChunkGrowth )
+{
+    NODE_POOL pool;
+    std::vector<void*> blocks;
+
+    // a 64 kB chunk holds 256 blocks of 256 bytes
+    for( int i = 0; i < 257; i++ )
+        blocks.push_back( pool.Alloc( 256 ) );
+
+    BOOST_CHECK_EQUAL( pool.SystemAllocCount(), 2 );
+    BOOST_CHECK_EQUAL( pool.ReservedBytes(), 2 * 64 * 1024 );
+
+    for( void* block : blocks )
+        pool.Free( block, 256 );
+}
+
+/**
+ * Checks that the memory is only released when no block is in use anymore.
+ */
+BOOST_AUTO_TEST_CASE( Release )
+{
+    NODE_POOL pool;
+
+    void* a = pool.Alloc( 64 );
+
+    BOOST_CHECK( !pool.Release() );
+    BOOST_CHECK( pool.ReservedBytes() > 0 );
+
+    pool.Free( a, 64 );
+
+    BOOST_CHECK( pool.Release() );
+    BOOST_CHECK_EQUAL( pool.ReservedBytes(), 0 );
+
+    // the pool can still be used after a release
+    a = pool.Alloc( 64 );
+    BOOST_CHECK( a );
+    pool.Free( a, 64 );
+}
+
+/**
+ * Checks the allocator used by the hash tables of the branch nodes.
+ */
+BOOST_AUTO_TEST_CASE( Allocator )
+{
+    NODE_POOL pool;
+
+    {
+        typedef POOL_ALLOCATOR<std::pair<const int, int>> ALLOC;
+        std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, ALLOC>
+                map( 16, std::hash<int>(), std::equal_to<int>(), ALLOC( &pool ) );
+
+        for( int i = 0; i < 1000; i++ )
+            map[i] = 2 * i;
+
+        for( int i = 0; i < 1000; i++ )
+            BOOST_REQUIRE_EQUAL( map[i], 2 * i );
+
+        // the nodes come from the pool, the big bucket arrays from the system
+        BOOST_CHECK( pool.AllocCount() >= 1000 );
+        BOOST_CHECK( pool.LiveBlocks() >= 1000 );
+
+        for( int i = 0; i < 500; i++ )
+            map.erase( i );
+
+        std::list<int, POOL_ALLOCATOR<int>> list( ( POOL_ALLOCATOR<int>( &pool ) ) );
+
+        for( int i = 0; i < 100; i++ )
+            list.push_back( i );
+
+        BOOST_CHECK( POOL_ALLOCATOR<int>( &pool ) == map.get_allocator() );
+        BOOST_CHECK( POOL_ALLOCATOR<int>() != map.get_allocator() );
+    }
+
+    BOOST_CHECK_EQUAL( pool.LiveBlocks(), 0 );
+
+    // without a pool the allocator uses the global operator new
+    std::vector<int, POOL_ALLOCATOR<int>> vec;
+
+    for( int i = 0; i < 100; i++ )
+        vec.push_back( i );
+
+    BOOST_CHECK_EQUAL( vec[99], 99 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Times the display of a board and the full redraw done by VIEW::RecacheAllItems() (e.g. when
+ * the layer colors change). The board given with -f is filled up with tracks and vias, so the
+ * view holds at least MIN_ITEM_COUNT items.
+ */
+
+#include <pcb_test_frame.h>
+
+#include <wx/log.h>
+
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <pcb_draw_panel_gal.h>
+#include <view/view.h>
+#include <profile.h>
+
+#include <cstdio>
+
+static const int MIN_ITEM_COUNT = 100000;
+static const int RECACHE_RUNS = 5;
+
+
+class VIEW_UPDATE_TEST_FRAME : public PCB_TEST_FRAME
+{
+public:
+    VIEW_UPDATE_TEST_FRAME( wxFrame* frame,
+            const wxString& title,
+            const wxPoint& pos  = wxDefaultPosition,
+            const wxSize& size  = wxDefaultSize,
+            long style = wxDEFAULT_FRAME_STYLE ) :
+        PCB_TEST_FRAME( frame, title, pos, size, style )
+    {
+    }
+
+    virtual ~VIEW_UPDATE_TEST_FRAME() {}
+
+    void Run( const std::string& aFileName );
+};
+
+
+static int countItems( BOARD* aBoard )
+{
+    int count = aBoard->Zones().size();
+
+    for( auto track : aBoard->Tracks() )
+    {
+        (void) track;
+        count++;
+    }
+
+    for( auto drawing : aBoard->Drawings() )
+    {
+        (void) drawing;
+        count++;
+    }
+
+    for( auto module : aBoard->Modules() )
+    {
+        // The footprint itself, its reference and its value
+        count += 3;
+
+        for( auto pad : module->Pads() )
+        {
+            (void) pad;
+            count++;
+        }
+
+        for( auto item : module->GraphicalItems() )
+        {
+            (void) item;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+static void fillBoard( BOARD* aBoard, int aItemCount )
+{
+    const int pitch = 1000000;     // 1 mm
+    const int columns = 500;
+
+    for( int i = 0; i < aItemCount; i++ )
+    {
+        wxPoint pos( ( i % columns ) * pitch, ( i / columns ) * pitch );
+
+        if( i % 4 == 3 )
+        {
+            VIA* via = new VIA( aBoard );
+
+            via->SetViaType( VIA_THROUGH );
+            via->SetLayerPair( F_Cu, B_Cu );
+            via->SetPosition( pos );
+            via->SetWidth( pitch / 2 );
+            via->SetDrill( pitch / 4 );
+            aBoard->Add( via );
+        }
+        else
+        {
+            TRACK* track = new TRACK( aBoard );
+
+            track->SetLayer( i % 2 ? F_Cu : B_Cu );
+            track->SetStart( pos );
+            track->SetEnd( pos + wxPoint( pitch * 3 / 4, 0 ) );
+            track->SetWidth( pitch / 5 );
+            aBoard->Add( track );
+        }
+    }
+}
+
+
+void VIEW_UPDATE_TEST_FRAME::Run( const std::string& aFileName )
+{
+    BOARD* board = nullptr;
+
+    if( aFileName != "" )
+    {
+        PLUGIN::RELEASER pi( new PCB_IO );
+
+        try
+        {
+            board = pi->Load( wxString( aFileName.c_str() ), NULL, NULL );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            printf( "Error loading board: %s\n", (const char*) ioe.Problem().mb_str() );
+        }
+    }
+
+    if( !board )
+        board = new BOARD;
+
+    int count = countItems( board );
+
+    if( count < MIN_ITEM_COUNT )
+    {
+        fillBoard( board, MIN_ITEM_COUNT - count );
+        count = MIN_ITEM_COUNT;
+    }
+
+    // VIEW::UpdateItems() traces the time spent in its parallel and serial phases
+    wxLog::AddTraceMask( "GAL_PROFILE" );
+
+    PROF_COUNTER displayTime;
+    SetBoard( board );
+    displayTime.Stop();
+
+    printf( "display: %d items, %.1f ms\n", count, displayTime.msecs() );
+
+    KIGFX::VIEW* view = m_galPanel->GetView();
+
+    for( int i = 0; i < RECACHE_RUNS; i++ )
+    {
+        PROF_COUNTER recacheTime;
+        view->RecacheAllItems();
+        view->UpdateItems();
+        recacheTime.Stop();
+
+        printf( "recache: %d items, %.1f ms\n", count, recacheTime.msecs() );
+    }
+}
+
+
+wxFrame* CreateMainFrame( const std::string& aFileName )
+{
+    auto frame = new VIEW_UPDATE_TEST_FRAME( nullptr, wxT( "View Update Test" ) );
+
+    frame->Run( aFileName );
+
+    return frame;
+}